@@ -348,45 +348,80 @@ struct OutParams {
   double t[2]; ///< temperatures
 };             // OutParams
 
+namespace detail {
+
+/// @brief Per-call working storage of dso::Nrlmsise00, i.e. all quantities
+///        (temperature nodes, Legendre polynomials, trigonometric terms, etc)
+///        the model computes and passes between its sub-routines during one
+///        evaluation. A fresh instance is used for each call to
+///        dso::Nrlmsise00::gtd7, so that the model itself holds no state.
+struct Workspace {
+  /// Cached terms of globe7/glob7s, re-computed only when their arguments
+  /// change (within a call)
+  struct GlobeCache {
+    int last_doy{-1};
+    double p14{-1e3}, p18{-1e3}, p32{-1e3}, p39{-1e3};
+    double cd14{0e0}, cd18{0e0}, cd32{0e0}, cd39{0e0};
+  }; // GlobeCache
+
+  /// associated Legendre polynomials, for the latitude xl
+  double plg[4][9] = {{0e0}};
+  double xl{1000e0};
+  /// trigonometric terms of local time, for the local time tll
+  double ctloc{0e0}, stloc{0e0};
+  double c2tloc{0e0}, s2tloc{0e0};
+  double s3tloc{0e0}, c3tloc{0e0};
+  double tll{1000e0};
+  /// temperature nodes and gradients at end nodes
+  double tn1[5] = {0e0};
+  double tn2[4] = {0e0};
+  double tn3[5] = {0e0};
+  double tgn1[2] = {0e0};
+  double tgn2[2] = {0e0};
+  double tgn3[2] = {0e0};
+  /// magnetic activity terms
+  double apt[4] = {0e0};
+  double apdf{0e0};
+  /// F10.7 (average) flux minus 150
+  double dfa{0e0};
+  /// latitude variable gravity and effective radius
+  double gsurf{0e0};
+  double re{0e0};
+  /// N2 mixed density at altitude (from gts7)
+  double dm28{0e0};
+  GlobeCache globe7_cache, glob7s_cache;
+}; // Workspace
+
+} // namespace detail
+
 } // namespace nrlmsise00
 
 /// @brief A class to handle calls to the NRLMSISE00 model
+///
+/// The class only holds the (immutable) model coefficients; all quantities
+/// computed during an evaluation live in a dso::nrlmsise00::detail::Workspace
+/// local to the call. Hence, the model is reentrant and one instance can be
+/// shared by any number of threads.
 class Nrlmsise00 {
+  using Workspace = nrlmsise00::detail::Workspace;
+
   static const double ptm[10];
   static const double pdm[8][10];
   static const double pavgm[10];
 
   // two dim arrays
-  double pma[10][100];
-  double pd[9][150];
-  double ptl[4][100];
-  double plg[4][9];
+  const double pma[10][100];
+  const double pd[9][150];
+  const double ptl[4][100];
   const double pdl[2][25];
 
   // one dim arrays ...
-  double pt[150];
-  double ps[150];
-  double tn1[5];
-  double tn2[4];
-  double tn3[5];
-  double tgn1[2];
-  double tgn2[2];
-  double tgn3[2];
-  double apt[4];
+  const double pt[150];
+  const double ps[150];
   const double zn2[4] = {72.5e0, 55e0, 45e0, 32.5e0};
   const double zn3[5] = {32.5e0, 20e0, 15e0, 10e0, 0e0};
   // const double sam[100]; -> just a function
 
-  double gsurf;
-  double re;
-  double dd;
-  double dm28, tlb, xg0, dm28m;
-  double dfa;
-  double ctloc, stloc;
-  double c2tloc, s2tloc;
-  double s3tloc, c3tloc;
-  double apdf;
-
   /// @brief Replaces the original FORTRAN implementation SAM array
   constexpr double sam(int i) const noexcept {
 #ifdef DEBUG
@@ -395,28 +430,32 @@ class Nrlmsise00 {
     return (i < 50);
   }
 
-  double densm(double alt, double d0, double xm, double &tz) const noexcept;
-  double densu(double alt, double dlb, double t1, double t2, double xm,
-               double xalpha, double &tz, double zlb, double s2,
-               const double *zn1) noexcept;
-  double zeta(double zz, double zl) const noexcept {
+  double densm(const Workspace &ws, double alt, double d0, double xm,
+               double &tz) const noexcept;
+  double densu(Workspace &ws, double alt, double dlb, double t1, double t2,
+               double xm, double xalpha, double &tz, double zlb, double s2,
+               const double *zn1) const noexcept;
+  static double zeta(double zz, double zl, double re) noexcept {
     return (zz - zl) * (re + zl) / (re + zz);
   }
-  double scalh(double alt, double xm, double temp) const noexcept {
-    const double g = gsurf / std::pow(1e0 + alt / re, 2e0);
+  static double scalh(const Workspace &ws, double alt, double xm,
+                      double temp) noexcept {
+    const double g = ws.gsurf / std::pow(1e0 + alt / ws.re, 2e0);
     return dso::nrlmsise00::detail::r100gas * temp / (g * xm);
   }
-  double glatf(double lat, double &gv) const noexcept;
+  static double glatf(double lat, double &gv) noexcept;
 
-  double glob7s(const nrlmsise00::detail::InParamsCore *in, double *p) noexcept;
+  double glob7s(Workspace &ws, const nrlmsise00::detail::InParamsCore *in,
+                const double *p) const noexcept;
 
-  int ghp7(const nrlmsise00::detail::InParamsCore *in,
-           nrlmsise00::OutParams *out, double press) noexcept;
+  int gts7(Workspace &ws, const nrlmsise00::detail::InParamsCore *in,
+           nrlmsise00::OutParams *out, int mass = 48) const noexcept;
 
-  int gts7(const nrlmsise00::detail::InParamsCore *in,
-           nrlmsise00::OutParams *out, int mass = 48) noexcept;
+  double globe7(Workspace &ws, const nrlmsise00::detail::InParamsCore *in,
+                const double *p) const noexcept;
 
-  double globe7(const nrlmsise00::detail::InParamsCore *in, double *p) noexcept;
+  int ghp7(const nrlmsise00::detail::InParamsCore *in,
+           nrlmsise00::OutParams *out, double press) const noexcept;
 
 public:
   Nrlmsise00() noexcept;
@@ -455,7 +494,7 @@ public:
   ///        This includes He, O, N2, O2, Ar, H, and N but does NOT include
   ///        anomalous oxygen (species index 8).
   int gtd7(const nrlmsise00::detail::InParamsCore *in,
-           nrlmsise00::OutParams *out, int mass = 48) noexcept;
+           nrlmsise00::OutParams *out, int mass = 48) const noexcept;
 
   /// @brief Neutral Atmosphere Empirical Model from the surface to lower
   /// exosphere, including the anomalous oxygen contribution.
@@ -464,7 +503,7 @@ public:
   ///  d[5] which includes contributions from "anomalous oxygen" which can
   ///  affect satellite drag above 500 km.
   int gtd7d(const nrlmsise00::detail::InParamsCore *in,
-            nrlmsise00::OutParams *out, int mass = 48) noexcept;
+            nrlmsise00::OutParams *out, int mass = 48) const noexcept;
 
 }; // Nrlmsise00
 
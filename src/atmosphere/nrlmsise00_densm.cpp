@@ -7,9 +7,11 @@
 using namespace dso::nrlmsise00::detail;
 
 /// @brief Calculate Temperature and Density Profiles for lower atmos.
-double dso::Nrlmsise00::densm(double alt, double d0, double xm,
-                              double &tz) const noexcept {
+double dso::Nrlmsise00::densm(const Workspace &ws, double alt, double d0,
+                              double xm, double &tz) const noexcept {
   constexpr const int dim = 10;
+  const double re = ws.re;
+  const double gsurf = ws.gsurf;
   double xs[dim], ys[dim], y2out[dim], work[dim];
 
   double densm = d0;
@@ -19,24 +21,24 @@ double dso::Nrlmsise00::densm(double alt, double d0, double xm,
     int mn = mn2;
     double z1 = zn2[0];
     double z2 = zn2[mn - 1];
-    double t1 = tn2[0];
-    double t2 = tn2[mn - 1];
-    double zg = zeta(z, z1);
-    double zgdif = zeta(z2, z1);
+    double t1 = ws.tn2[0];
+    double t2 = ws.tn2[mn - 1];
+    double zg = zeta(z, z1, re);
+    double zgdif = zeta(z2, z1, re);
 
 // setup spline nodes
 #ifdef DEBUG
     assert(mn < 10);
 #endif
     for (int k = 0; k < mn; k++) {
-      xs[k] = zeta(zn2[k], z1) / zgdif;
+      xs[k] = zeta(zn2[k], z1, re) / zgdif;
     }
     for (int k = 0; k < mn; k++) {
-      ys[k] = 1e0 / tn2[k];
+      ys[k] = 1e0 / ws.tn2[k];
     }
-    double yd1 = -tgn2[0] / (t1 * t1) * zgdif;
+    double yd1 = -ws.tgn2[0] / (t1 * t1) * zgdif;
     double yd2 =
-        -tgn2[1] / (t2 * t2) * zgdif * std::pow((re + z2) / (re + z1), 2e0);
+        -ws.tgn2[1] / (t2 * t2) * zgdif * std::pow((re + z2) / (re + z1), 2e0);
 
     // calculate spline coefficients
     dso::nrlmsise00::detail::spline(xs, ys, mn, yd1, yd2, y2out, work);
@@ -65,18 +67,19 @@ double dso::Nrlmsise00::densm(double alt, double d0, double xm,
       mn = mn3;
       z1 = zn3[0];
       z2 = zn3[mn - 1];
-      t1 = tn3[0];
-      t2 = tn3[mn - 1];
-      zg = zeta(z, z1);
-      zgdif = zeta(z2, z1);
+      t1 = ws.tn3[0];
+      t2 = ws.tn3[mn - 1];
+      zg = zeta(z, z1, re);
+      zgdif = zeta(z2, z1, re);
 
       // Setup spline nodes
       for (int k = 0; k < mn; k++)
-        xs[k] = zeta(zn3[k], z1) / zgdif;
+        xs[k] = zeta(zn3[k], z1, re) / zgdif;
       for (int k = 0; k < mn; k++)
-        ys[k] = 1e0 / tn3[k];
-      yd1 = -tgn3[0] / (t1 * t1) * zgdif;
-      yd2 = -tgn3[1] / (t2 * t2) * zgdif * std::pow((re + z2) / (re + z1), 2e0);
+        ys[k] = 1e0 / ws.tn3[k];
+      yd1 = -ws.tgn3[0] / (t1 * t1) * zgdif;
+      yd2 = -ws.tgn3[1] / (t2 * t2) * zgdif *
+            std::pow((re + z2) / (re + z1), 2e0);
 
       // calculate spline coefficients
       dso::nrlmsise00::detail::spline(xs, ys, mn, yd1, yd2, y2out, work);
@@ -8,10 +8,13 @@ using namespace dso::nrlmsise00::detail;
 
 /// @brief  Calculate Temperature and Density Profiles for MSIS models
 /// New lower thermo polynomial 10/30/89
-double dso::Nrlmsise00::densu(double alt, double dlb, double t1, double t2,
-                              double xm, double xalph, double &tz, double zlb,
-                              double s2, const double *zn1) noexcept {
+double dso::Nrlmsise00::densu(Workspace &ws, double alt, double dlb, double t1,
+                              double t2, double xm, double xalph, double &tz,
+                              double zlb, double s2,
+                              const double *zn1) const noexcept {
   constexpr const int dim = 5;
+  const double re = ws.re;
+  const double gsurf = ws.gsurf;
   double xs[dim], ys[dim], y2out[dim], work[dim];
 
   double densu = 1e0;
@@ -21,7 +24,7 @@ double dso::Nrlmsise00::densu(double alt, double dlb, double t1, double t2,
   double z = std::max(alt, za);
 
   // geopotential altitude difference from ZLB
-  const double zg2 = zeta(z, zlb);
+  const double zg2 = zeta(z, zlb, re);
 
   // Bates temperature
   const double tt = t1 - (t1 - t2) * std::exp(-s2 * zg2);
@@ -35,31 +38,31 @@ double dso::Nrlmsise00::densu(double alt, double dlb, double t1, double t2,
     // CALCULATE TEMPERATURE BELOW ZA
     // Temperature gradient at ZA from Bates profile
     const double dta = (t1 - ta) * s2 * std::pow((re + zlb) / (re + za), 2e0);
-    tgn1[0] = dta;
-    tn1[0] = ta;
+    ws.tgn1[0] = dta;
+    ws.tn1[0] = ta;
     z = std::max(alt, zn1[mn1 - 1]);
     mn = mn1;
     z1 = zn1[0];
     const double z2 = zn1[mn - 1];
-    tt1 = tn1[0];
-    const double tt2 = tn1[mn - 1];
+    tt1 = ws.tn1[0];
+    const double tt2 = ws.tn1[mn - 1];
 
     // geopotential difference from Z1
-    const double zg = zeta(z, z1);
-    zgdif = zeta(z2, z1);
+    const double zg = zeta(z, z1, re);
+    zgdif = zeta(z2, z1, re);
 
     // setup spline nodes
     for (int k = 0; k < mn; k++) {
-      xs[k] = zeta(zn1[k], z1) / zgdif;
+      xs[k] = zeta(zn1[k], z1, re) / zgdif;
     }
     for (int k = 0; k < mn; k++){
-      ys[k] = 1e0 / tn1[k];
+      ys[k] = 1e0 / ws.tn1[k];
     }
 
     // end node derivatives
-    const double yd1 = -tgn1[0] / (tt1 * tt1) * zgdif;
-    const double yd2 =
-        -tgn1[1] / (tt2 * tt2) * zgdif * std::pow((re + z2) / (re + z1), 2e0);
+    const double yd1 = -ws.tgn1[0] / (tt1 * tt1) * zgdif;
+    const double yd2 = -ws.tgn1[1] / (tt2 * tt2) * zgdif *
+                       std::pow((re + z2) / (re + z1), 2e0);
 
     // calculate spline coefficients
 #ifdef DEBUG
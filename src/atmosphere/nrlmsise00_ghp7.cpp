@@ -5,7 +5,7 @@ using namespace dso::nrlmsise00::detail;
 // if anything other than zero is returned, error!
 int dso::Nrlmsise00::ghp7(const InParamsCore *in,
                           dso::nrlmsise00::OutParams *out,
-                          double press) noexcept {
+                          double press) const noexcept {
 
   constexpr const double bm = 1.3806e-19;
 
@@ -74,6 +74,8 @@ int dso::Nrlmsise00::ghp7(const InParamsCore *in,
     double xm = out->d[5] / xn / 1.66e-24;
     if (in->meters())
       xm *= 1e3;
+    double gsurf;
+    const double re = glatf(in->glat, gsurf);
     const double g = gsurf / std::pow(1e0 + z / re, 2);
     const double sh = r100gas * out->t[1] / (xm * g);
     // New altitude estimate using scale height
@@ -4,8 +4,8 @@
 using namespace dso::nrlmsise00::detail;
 
 /// @brief calculate latitude variable gravity (gv) and effective radius (reff)
-double dso::Nrlmsise00::glatf(double lat, double &gv) const noexcept {
+double dso::Nrlmsise00::glatf(double lat, double &gv) noexcept {
   const double c2 = std::cos(2e0 * dso::deg2rad(lat));
   gv = egrav * 1e2 * (1e0 - 0.0026373e0 * c2);
-  return 2e0 * gsurf / (3.085462e-6 + 2.27e-9 * c2) * 1e-5;
+  return 2e0 * gv / (3.085462e-6 + 2.27e-9 * c2) * 1e-5;
 }
@@ -3,12 +3,13 @@
 
 using namespace dso::nrlmsise00::detail;
 
-double dso::Nrlmsise00::globe7(const InParamsCore *in, double *pp) noexcept {
+double dso::Nrlmsise00::globe7(Workspace &ws, const InParamsCore *in,
+                               const double *pp) const noexcept {
 
   // calculate G(L) function
 
   // only access pp through here, let compiler know
-  double *__restrict__ p = pp;
+  const double *__restrict__ p = pp;
 
   // switches ...
   const double *__restrict__ sw = in->sw.sw;
@@ -18,23 +19,15 @@ double dso::Nrlmsise00::globe7(const InParamsCore *in, double *pp) noexcept {
   constexpr const double hr = 0.2618e0;
   constexpr const double sr = 7.2722e-5;
 
-  // last latitude (so we don't re-compute legendre polynomials)
-  static double xl = 1000e0;
-  // last used tloc/lst (so we don't recompute trig numbers)
-  static double tll = 1000e0;
-  static double sw9 = 1e0;
-  // last doy used 
-  static int last_doy = -1;
-  static double p14 = -1e3;
-  static double p18 = -1e3;
-  static double p32 = -1e3;
-  static double p39 = -1e3;
-  static double cd14, cd18, cd32, cd39;
+  // legendre polynomials and terms cached (per call) in the workspace, with
+  // the last used latitude (xl), tloc/lst (tll) and doy
+  double(&plg)[4][9] = ws.plg;
+  Workspace::GlobeCache &gc = ws.globe7_cache;
 
   double t[14] = {0e0};
-  sw9 = 1e0 * (sw[8] < 0e0) * -1e0;
+  const double sw9 = 1e0 * (sw[8] < 0e0) * -1e0;
 
-  if (std::abs(xl - in->glat) > nearzero) {
+  if (std::abs(ws.xl - in->glat) > nearzero) {
     // calculate legendre polynomials
     const double c = std::sin(dso::deg2rad(in->glat));
     const double s = std::cos(dso::deg2rad(in->glat));
@@ -68,45 +61,46 @@ double dso::Nrlmsise00::globe7(const InParamsCore *in, double *pp) noexcept {
     plg[3][6] = (11e0 * c * plg[3][5] - 8e0 * plg[3][4]) / 3e0;
 
     // set last used latitude ...
-    xl = in->glat;
+    ws.xl = in->glat;
   }
 
   const double tloc = in->lst;
-  if (std::abs(tll - tloc) > nearzero) {
+  if (std::abs(ws.tll - tloc) > nearzero) {
     if (std::abs(sw[6]) > 0e0 || std::abs(sw[7]) > 0e0 || std::abs(sw[13])) {
-      stloc = std::sin(hr * tloc);
-      ctloc = std::cos(hr * tloc);
-      s2tloc = std::sin(2e0 * hr * tloc);
-      c2tloc = std::cos(2e0 * hr * tloc);
-      s3tloc = std::sin(3e0 * hr * tloc);
-      c3tloc = std::cos(3e0 * hr * tloc);
+      ws.stloc = std::sin(hr * tloc);
+      ws.ctloc = std::cos(hr * tloc);
+      ws.s2tloc = std::sin(2e0 * hr * tloc);
+      ws.c2tloc = std::cos(2e0 * hr * tloc);
+      ws.s3tloc = std::sin(3e0 * hr * tloc);
+      ws.c3tloc = std::cos(3e0 * hr * tloc);
 
       // update last used tloc
-      tll = tloc;
+      ws.tll = tloc;
     }
   }
 
-  const bool doy_changed = last_doy - (int)in->doy != 0;
-  if (doy_changed || std::abs(p[13] - p14) > nearzero)
-    cd14 = std::cos(dr * (in->doy - p[13]));
-  if (doy_changed || std::abs(p[17] - p18) > nearzero)
-    cd18 = std::cos(2e0 * dr * (in->doy - p[17]));
-  if (doy_changed || std::abs(p[31] - p32) > nearzero)
-    cd32 = std::cos(dr * (in->doy - p[31]));
-  if (doy_changed || std::abs(p[38] - p39) > nearzero)
-    cd39 = std::cos(2e0 * dr * (in->doy - p[38]));
+  const bool doy_changed = gc.last_doy - (int)in->doy != 0;
+  if (doy_changed || std::abs(p[13] - gc.p14) > nearzero)
+    gc.cd14 = std::cos(dr * (in->doy - p[13]));
+  if (doy_changed || std::abs(p[17] - gc.p18) > nearzero)
+    gc.cd18 = std::cos(2e0 * dr * (in->doy - p[17]));
+  if (doy_changed || std::abs(p[31] - gc.p32) > nearzero)
+    gc.cd32 = std::cos(dr * (in->doy - p[31]));
+  if (doy_changed || std::abs(p[38] - gc.p39) > nearzero)
+    gc.cd39 = std::cos(2e0 * dr * (in->doy - p[38]));
 
   // update last doy used ...
-  last_doy = in->doy;
+  gc.last_doy = in->doy;
 
-  p14 = p[13];
-  p18 = p[17];
-  p32 = p[31];
-  p39 = p[38];
+  gc.p14 = p[13];
+  gc.p18 = p[17];
+  gc.p32 = p[31];
+  gc.p39 = p[38];
 
   // F10.7 effect
   const double df = in->f107 - in->f107A;
-  dfa = in->f107A - 150e0;
+  const double dfa = in->f107A - 150e0;
+  ws.dfa = dfa;
   t[0] = p[19] * df * (1e0 + p[59] * dfa) + p[20] * df * df + p[21] * dfa +
          p[29] * dfa * dfa;
   const double f1 =
@@ -119,46 +113,46 @@ double dso::Nrlmsise00::globe7(const InParamsCore *in, double *pp) noexcept {
          (p[14] * plg[0][2]) * dfa * in->sw.swc[0] + p[26] * plg[0][1];
 
   // symmetric annual
-  t[2] = p[18] * cd32;
+  t[2] = p[18] * gc.cd32;
 
   // symmetric semiannual
-  t[3] = (p[15] + p[16] * plg[0][2]) * cd18;
+  t[3] = (p[15] + p[16] * plg[0][2]) * gc.cd18;
 
   // asymmetric annual
-  t[4] = f1 * (p[9] * plg[0][1] + p[10] * plg[0][3]) * cd14;
+  t[4] = f1 * (p[9] * plg[0][1] + p[10] * plg[0][3]) * gc.cd14;
 
   // asymmetric semiannual
-  t[5] = p[37] * plg[0][1] * cd39;
+  t[5] = p[37] * plg[0][1] * gc.cd39;
 
   // diurnal
   if (std::abs(in->sw.sw[6]) > 0e0) {
-    const double t71 = (p[11] * plg[1][2]) * cd14 * in->sw.swc[4];
-    const double t72 = (p[12] * plg[1][2]) * cd14 * in->sw.swc[4];
+    const double t71 = (p[11] * plg[1][2]) * gc.cd14 * in->sw.swc[4];
+    const double t72 = (p[12] * plg[1][2]) * gc.cd14 * in->sw.swc[4];
     t[6] =
         f2 * ((p[3] * plg[1][1] + p[4] * plg[1][3] + p[27] * plg[1][5] + t71) *
-                  ctloc +
+                  ws.ctloc +
               (p[6] * plg[1][1] + p[7] * plg[1][3] + p[28] * plg[1][5] + t72) *
-                  stloc);
+                  ws.stloc);
   }
 
   // semidiurnal
   if (std::abs(sw[7]) > 0e0) {
     const double t81 =
-        (p[23] * plg[2][3] + p[35] * plg[2][5]) * cd14 * in->sw.swc[4];
+        (p[23] * plg[2][3] + p[35] * plg[2][5]) * gc.cd14 * in->sw.swc[4];
     const double t82 =
-        (p[33] * plg[2][3] + p[36] * plg[2][5]) * cd14 * in->sw.swc[4];
-    t[7] = f2 * ((p[5] * plg[2][2] + p[41] * plg[2][4] + t81) * c2tloc +
-                 (p[8] * plg[2][2] + p[42] * plg[2][4] + t82) * s2tloc);
+        (p[33] * plg[2][3] + p[36] * plg[2][5]) * gc.cd14 * in->sw.swc[4];
+    t[7] = f2 * ((p[5] * plg[2][2] + p[41] * plg[2][4] + t81) * ws.c2tloc +
+                 (p[8] * plg[2][2] + p[42] * plg[2][4] + t82) * ws.s2tloc);
   }
 
   // terdiurnal
   if (std::abs(sw[13]) > 0e0) {
     t[13] = f2 * ((p[39] * plg[3][3] + (p[93] * plg[3][4] + p[46] * plg[3][6]) *
-                                           cd14 * in->sw.swc[4]) *
-                      s3tloc +
+                                           gc.cd14 * in->sw.swc[4]) *
+                      ws.s3tloc +
                   (p[40] * plg[3][3] + (p[94] * plg[3][4] + p[48] * plg[3][6]) *
-                                           cd14 * in->sw.swc[4]) *
-                      c3tloc);
+                                           gc.cd14 * in->sw.swc[4]) *
+                      ws.c3tloc);
   }
 
   // magnetic activity based on daily ap
@@ -168,12 +162,12 @@ double dso::Nrlmsise00::globe7(const InParamsCore *in, double *pp) noexcept {
     const double p45 = p[44];
     if (p44 < 0e0)
       p44 = 1e-5;
-    apdf = apd + (p45 - 1e0) * (apd + (std::exp(-p44 * apd) - 1e0) / p44);
+    ws.apdf = apd + (p45 - 1e0) * (apd + (std::exp(-p44 * apd) - 1e0) / p44);
     if (std::abs(sw[8]) > nearzero) {
-      t[8] = apdf *
+      t[8] = ws.apdf *
              (p[32] + p[45] * plg[0][2] + p[34] * plg[0][4] +
               (p[100] * plg[0][1] + p[101] * plg[0][3] + p[102] * plg[0][5]) *
-                  cd14 * in->sw.swc[4] +
+                  gc.cd14 * in->sw.swc[4] +
               (p[121] * plg[1][1] + p[122] * plg[1][3] + p[123] * plg[1][5]) *
                   in->sw.swc[6] * std::cos(hr * (tloc - p[124])));
     }
@@ -182,17 +176,17 @@ double dso::Nrlmsise00::globe7(const InParamsCore *in, double *pp) noexcept {
                            (1e0 + p[138] * (45e0 - std::abs(in->glat))));
     if (exp1 > 0.99999e0)
       exp1 = 0.99999;
-    if (p[24] < 1e-4)
-      p[24] = 1e-4;
-    apt[0] = sg0(exp1, p, in->aparr.a);
+    // note: the FORTRAN code clamps p(25) to >= 1e-4 here; all coefficient
+    // sets already satisfy this, so they are used as-is (and kept immutable)
+    ws.apt[0] = sg0(exp1, p, in->aparr.a);
     // APT(2)=SG2(EXP1)
     // APT(3)=SG0(EXP2)
     // APT(4)=SG2(EXP2)
     if (std::abs(sw[8]) > 0) {
-      t[8] = apt[0] *
+      t[8] = ws.apt[0] *
              (p[50] + p[96] * plg[0][2] + p[54] * plg[0][4] +
               (p[125] * plg[0][1] + p[126] * plg[0][3] + p[127] * plg[0][5]) *
-                  cd14 * in->sw.swc[4] +
+                  gc.cd14 * in->sw.swc[4] +
               (p[128] * plg[1][1] + p[129] * plg[1][3] + p[130] * plg[1][5]) *
                   in->sw.swc[6] * std::cos(hr * (tloc - p[131])));
     }
@@ -207,19 +201,19 @@ double dso::Nrlmsise00::globe7(const InParamsCore *in, double *pp) noexcept {
             p[103] * plg[1][1] + p[104] * plg[1][3] + p[105] * plg[1][5] +
             in->sw.swc[4] *
                 (p[109] * plg[1][1] + p[110] * plg[1][3] + p[111] * plg[1][5]) *
-                cd14) *
+                gc.cd14) *
                std::cos(dso::deg2rad(in->glon)) +
            (p[90] * plg[1][2] + p[91] * plg[1][4] + p[92] * plg[1][6] +
             p[106] * plg[1][1] + p[107] * plg[1][3] + p[108] * plg[1][5] +
             in->sw.swc[4] *
                 (p[112] * plg[1][1] + p[113] * plg[1][3] + p[114] * plg[1][5]) *
-                cd14) *
+                gc.cd14) *
                std::sin(dso::deg2rad(in->glon)));
     }
     // UT and mixed UT, longitude
     if (std::abs(sw[11]) > nearzero) {
       t[11] = (1e0 + p[95] * plg[0][1]) * (1e0 + p[81] * dfa * in->sw.swc[0]) *
-              (1e0 + p[119] * plg[0][1] * in->sw.swc[4] * cd14) *
+              (1e0 + p[119] * plg[0][1] * in->sw.swc[4] * gc.cd14) *
               ((p[68] * plg[0][1] + p[69] * plg[0][3] + p[70] * plg[0][5]) *
                std::cos(sr * (in->sec - p[71])));
       t[11] += in->sw.swc[10] *
@@ -231,24 +225,24 @@ double dso::Nrlmsise00::globe7(const InParamsCore *in, double *pp) noexcept {
     if (std::abs(sw[12]) > nearzero) {
       if (std::abs(sw9 + 1e0) > nearzero) {
         t[12] =
-            apdf * in->sw.swc[10] * (1e0 + p[120] * plg[0][1]) *
+            ws.apdf * in->sw.swc[10] * (1e0 + p[120] * plg[0][1]) *
                 ((p[60] * plg[1][2] + p[61] * plg[1][4] + p[62] * plg[1][6]) *
                  std::cos(dso::deg2rad(in->glon - p[63]))) +
-            apdf * in->sw.swc[10] * in->sw.swc[4] *
+            ws.apdf * in->sw.swc[10] * in->sw.swc[4] *
                 (p[115] * plg[1][1] + p[116] * plg[1][3] + p[117] * plg[1][5]) *
-                cd14 * std::cos(dso::deg2rad(in->glon - p[118])) +
-            apdf * in->sw.swc[11] *
+                gc.cd14 * std::cos(dso::deg2rad(in->glon - p[118])) +
+            ws.apdf * in->sw.swc[11] *
                 (p[83] * plg[0][1] + p[84] * plg[0][3] + p[85] * plg[0][5]) *
                 std::cos(sr * (in->sec - p[75]));
       } else if (p[51] != 0) {
         t[12] =
-            apt[0] * in->sw.swc[10] * (1e0 + p[132] * plg[0][1]) *
+            ws.apt[0] * in->sw.swc[10] * (1e0 + p[132] * plg[0][1]) *
                 ((p[52] * plg[1][2] + p[98] * plg[1][4] + p[67] * plg[1][6]) *
                  std::cos(dso::deg2rad(in->glon - p[97]))) +
-            apt[0] * in->sw.swc[10] * in->sw.swc[4] *
+            ws.apt[0] * in->sw.swc[10] * in->sw.swc[4] *
                 (p[133] * plg[1][1] + p[134] * plg[1][3] + p[135] * plg[1][5]) *
-                cd14 * std::cos(dso::deg2rad(in->glon - p[136])) +
-            apt[0] * in->sw.swc[11] *
+                gc.cd14 * std::cos(dso::deg2rad(in->glon - p[136])) +
+            ws.apt[0] * in->sw.swc[11] *
                 (p[55] * plg[0][1] + p[56] * plg[0][3] + p[57] * plg[0][5]) *
                 std::cos(sr * (in->sec - p[58]));
       }
@@ -3,7 +3,8 @@
 using namespace dso::nrlmsise00::detail;
 
 int dso::Nrlmsise00::gtd7d(const InParamsCore *in,
-                           dso::nrlmsise00::OutParams *out, int mass) noexcept {
+                           dso::nrlmsise00::OutParams *out,
+                           int mass) const noexcept {
   gtd7(in, out, mass);
 
   double *__restrict__ d = out->d;
@@ -8,67 +8,53 @@ const double altl[8] = {200e0, 300e0, 160e0, 250e0, 240e0, 450e0, 320e0, 450e0};
 const double alpha[9] = {-0.380e0, 0e0,      0e0, 0e0, 0.170e0,
                          0e0,      -0.380e0, 0e0, 0e0};
 const int mt[11] = {48, 0, 4, 16, 28, 32, 40, 1, 49, 14, 17};
-double zn1[5] = {120e0, 110e0, 100e0, 90e0, 72.5e0};
 
-int dso::Nrlmsise00::gts7(const InParamsCore *in,
-                          dso::nrlmsise00::OutParams *out, int mass) noexcept {
-
-  // last call with this altitude
-  static double altlast = -999e0;
-
-  // input always changed from previous call ....
-  constexpr const bool input_changed = true;
+int dso::Nrlmsise00::gts7(Workspace &ws, const InParamsCore *in,
+                          dso::nrlmsise00::OutParams *out,
+                          int mass) const noexcept {
 
   const double za = pdl[1][15];
-  zn1[0] = za;
+  const double zn1[5] = {za, 110e0, 100e0, 90e0, 72.5e0};
   std::memset(out->d, 0, sizeof(double) * 9);
 
   // TINF variations not important below za or zn1(1)
-  double tinf = 0e0;
-  if (in->alt > zn1[0]) {
-    if (input_changed || altlast <= zn1[0]) {
-      tinf = ptm[0] * pt[0] * (1e0 + in->sw.sw[15] * globe7(in, pt));
-    }
-  } else {
-    tinf = ptm[0] * pt[0];
-  }
+  double tinf = ptm[0] * pt[0];
+  if (in->alt > zn1[0])
+    tinf *= (1e0 + in->sw.sw[15] * globe7(ws, in, pt));
   out->t[0] = tinf;
 
   // gradient variations not important below zn1(5)
-  if (in->alt > zn1[4]) {
-    if (input_changed || altlast <= zn1[4]) {
-      xg0 = ptm[3] * ps[0] * (1e0 + in->sw.sw[18] * globe7(in, ps));
-    }
-  } else {
-    xg0 = ptm[3] * ps[0];
-  }
+  double xg0 = ptm[3] * ps[0];
+  if (in->alt > zn1[4])
+    xg0 *= (1e0 + in->sw.sw[18] * globe7(ws, in, ps));
 
-  // calculate these temperatures only if input changed
-  if (input_changed || in->alt < 300e0) {
-    tlb = ptm[1] * (1e0 + in->sw.sw[16] * globe7(in, pd[3])) * pd[3][0];
-  }
+  const double tlb =
+      ptm[1] * (1e0 + in->sw.sw[16] * globe7(ws, in, pd[3])) * pd[3][0];
   const double s = xg0 / (tinf - tlb);
 
   // Lower thermosphere temp variations not significant for
   // density above 300 km
+  double *tn1 = ws.tn1;
   if (in->alt >= 300e0) {
     tn1[1] = ptm[6] * ptl[0][0];
     tn1[2] = ptm[2] * ptl[1][0];
     tn1[3] = ptm[7] * ptl[2][0];
     tn1[4] = ptm[4] * ptl[3][0];
-    tgn1[1] = ptm[8] * pma[8][0] * tn1[4] * tn1[4] /
-              std::pow(ptm[4] * ptl[3][0], 2e0);
-  } else if (input_changed || altlast >= 300e0) {
+    ws.tgn1[1] = ptm[8] * pma[8][0] * tn1[4] * tn1[4] /
+                 std::pow(ptm[4] * ptl[3][0], 2e0);
+  } else {
     tn1[1] =
-        ptm[6] * ptl[0][0] / (1e0 - in->sw.sw[17] * glob7s(in, ptl[0]));
+        ptm[6] * ptl[0][0] / (1e0 - in->sw.sw[17] * glob7s(ws, in, ptl[0]));
     tn1[2] =
-        ptm[2] * ptl[1][0] / (1e0 - in->sw.sw[17] * glob7s(in, ptl[1]));
-    tn1[3] = ptm[7] * ptl[2][0] / (1e0 - in->sw.sw[17] * glob7s(in, ptl[2]));
+        ptm[2] * ptl[1][0] / (1e0 - in->sw.sw[17] * glob7s(ws, in, ptl[1]));
+    tn1[3] =
+        ptm[7] * ptl[2][0] / (1e0 - in->sw.sw[17] * glob7s(ws, in, ptl[2]));
     tn1[4] = ptm[4] * ptl[3][0] /
-             (1e0 - in->sw.sw[17] * in->sw.sw[19] * glob7s(in, ptl[3]));
-    tgn1[1] = ptm[8] * pma[8][0] *
-              (1e0 + in->sw.sw[17] * in->sw.sw[19] * glob7s(in, pma[8])) *
-              tn1[4] * tn1[4] / std::pow(ptm[4] * ptl[3][0], 2);
+             (1e0 - in->sw.sw[17] * in->sw.sw[19] * glob7s(ws, in, ptl[3]));
+    ws.tgn1[1] =
+        ptm[8] * pma[8][0] *
+        (1e0 + in->sw.sw[17] * in->sw.sw[19] * glob7s(ws, in, pma[8])) *
+        tn1[4] * tn1[4] / std::pow(ptm[4] * ptl[3][0], 2);
   }
 
   [[maybe_unused]] const double z0 = zn1[3];
@@ -83,7 +69,7 @@ int dso::Nrlmsise00::gts7(const InParamsCore *in,
 #endif
 
     // N2 variation factor at Zlb
-    const double g28 = in->sw.sw[20] * globe7(in, pd[2]);
+    const double g28 = in->sw.sw[20] * globe7(ws, in, pd[2]);
 
     // variation of turbopause height
     const double zhf =
@@ -104,7 +90,7 @@ int dso::Nrlmsise00::gts7(const InParamsCore *in,
       }
     }
 
-    double tz = 0, zhm28 = 0, b28 = 0;
+    double tz = 0, zhm28 = 0, b28 = 0, dd = 0;
     double db01, db04, db14, db16, db28, db32, db40;
     if (goto_100) {
       if (z < altl[5] || mass == 28 || mass == 48) {
@@ -114,21 +100,22 @@ int dso::Nrlmsise00::gts7(const InParamsCore *in,
         // diffusive density at zlb
         db28 = pdm[2][0] * std::exp(g28) * pd[2][0];
         // diffusive density at alt
-        out->d[2] = densu(z, db28, tinf, tlb, 28e0, alpha[2], out->t[1], ptm[5],
-                          s, zn1);
+        out->d[2] = densu(ws, z, db28, tinf, tlb, 28e0, alpha[2],
+                          out->t[1], ptm[5], s, zn1);
         dd = out->d[2];
         // turbopause
         const double zh28 = pdm[2][2] * zhf;
         zhm28 = pdm[2][3] * pdl[1][5];
         const double xmd = 28e0 - xmm;
         // mixed density at Zlb
-        b28 = densu(zh28, db28, tinf, tlb, xmd, alpha[2] - 1e0, tz, ptm[5], s,
-                    zn1);
+        b28 = densu(ws, zh28, db28, tinf, tlb, xmd, alpha[2] - 1e0, tz, ptm[5],
+                    s, zn1);
         if (z <= altl[2] && std::abs(in->sw.sw[14]) > 0e0) {
           // mixed density at alt
-          dm28 = densu(z, b28, tinf, tlb, xmm, alpha[2], tz, ptm[5], s, zn1);
+          ws.dm28 =
+              densu(ws, z, b28, tinf, tlb, xmm, alpha[2], tz, ptm[5], s, zn1);
           // net density at alt
-          out->d[2] = dnet(out->d[2], dm28, zhm28, xmm, 28e0);
+          out->d[2] = dnet(out->d[2], ws.dm28, zhm28, xmm, 28e0);
         }
       }
 
@@ -137,21 +124,21 @@ int dso::Nrlmsise00::gts7(const InParamsCore *in,
         // **** HE DENSITY ****
         // BP: --
         // Density variation factor at Zlb
-        const double g4 = in->sw.sw[20] * globe7(in, pd[0]);
+        const double g4 = in->sw.sw[20] * globe7(ws, in, pd[0]);
         // diffusive density at zlb
         db04 = pdm[0][0] * std::exp(g4) * pd[0][0];
-        out->d[0] =
-            densu(z, db04, tinf, tlb, 4e0, alpha[0], out->t[1], ptm[5], s, zn1);
+        out->d[0] = densu(ws, z, db04, tinf, tlb, 4e0, alpha[0],
+                          out->t[1], ptm[5], s, zn1);
         dd = out->d[0];
         if (z <= altl[0] && std::abs(in->sw.sw[14]) > 0e0) {
           // turbopause
           const double zh04 = pdm[0][2];
           // mixed density at Zlb
-          const double b04 = densu(zh04, db04, tinf, tlb, 4e0 - xmm,
+          const double b04 = densu(ws, zh04, db04, tinf, tlb, 4e0 - xmm,
                                    alpha[0] - 1e0, out->t[1], ptm[5], s, zn1);
           // mixed density at alt
           const double dm04 =
-              densu(z, b04, tinf, tlb, xmm, 0e0, out->t[1], ptm[5], s, zn1);
+              densu(ws, z, b04, tinf, tlb, xmm, 0e0, out->t[1], ptm[5], s, zn1);
           const double zhm04 = zhm28;
           // net density at alt
           out->d[0] = dnet(out->d[0], dm04, zhm04, xmm, 4e0);
@@ -168,23 +155,23 @@ int dso::Nrlmsise00::gts7(const InParamsCore *in,
         //
         // BP: --
         // Density variation factor at Zlb
-        const double g16 = in->sw.sw[20] * globe7(in, pd[1]);
+        const double g16 = in->sw.sw[20] * globe7(ws, in, pd[1]);
         // diffusion density at Zlb
         db16 = pdm[1][0] * std::exp(g16) * pd[1][0];
         // diffusive density at alt
-        out->d[1] = densu(z, db16, tinf, tlb, 16e0, alpha[1], out->t[1], ptm[5],
-                          s, zn1);
+        out->d[1] = densu(ws, z, db16, tinf, tlb, 16e0, alpha[1],
+                          out->t[1], ptm[5], s, zn1);
         dd = out->d[1];
         if (z <= altl[1] && std::abs(in->sw.sw[14]) > 0) {
           // corrected pdm(31) to pdm(3,2) 12/2/85
           // turbopause
           const double zh16 = pdm[1][2];
           // mixed density at Zlb
-          const double b16 = densu(zh16, db16, tinf, tlb, 16e0 - xmm,
+          const double b16 = densu(ws, zh16, db16, tinf, tlb, 16e0 - xmm,
                                    alpha[1] - 1e0, out->t[1], ptm[5], s, zn1);
           // mixed density at alt
           const double dm16 =
-              densu(z, b16, tinf, tlb, xmm, 0e0, out->t[1], ptm[5], s, zn1);
+              densu(ws, z, b16, tinf, tlb, xmm, 0e0, out->t[1], ptm[5], s, zn1);
           const double zhm16 = zhm28;
           // net density at alt
           out->d[1] = dnet(out->d[1], dm16, zhm16, xmm, 16e0);
@@ -213,12 +200,12 @@ int dso::Nrlmsise00::gts7(const InParamsCore *in,
         //  **** O2 DENSITY ****
         //
         // BP: 200
-        const double g32 = in->sw.sw[20] * globe7(in, pd[4]);
+        const double g32 = in->sw.sw[20] * globe7(ws, in, pd[4]);
         // diffusive density at Zlb
         db32 = pdm[3][0] * std::exp(g32) * pd[4][0];
         // diffusive density at alt
-        out->d[3] = densu(z, db32, tinf, tlb, 32e0, alpha[3], out->t[1], ptm[5],
-                          s, zn1);
+        out->d[3] = densu(ws, z, db32, tinf, tlb, 32e0, alpha[3],
+                          out->t[1], ptm[5], s, zn1);
         if (mass == 49) {
           dd += 2e0 * out->d[3];
         } else {
@@ -229,11 +216,11 @@ int dso::Nrlmsise00::gts7(const InParamsCore *in,
             // turbopause
             const double zh32 = pdm[3][2];
             // mixed density at Zlb
-            const double b32 = densu(zh32, db32, tinf, tlb, 32e0 - xmm,
+            const double b32 = densu(ws, zh32, db32, tinf, tlb, 32e0 - xmm,
                                      alpha[3] - 1e0, out->t[1], ptm[5], s, zn1);
             // mixed density at alt
-            const double dm32 =
-                densu(z, b32, tinf, tlb, xmm, 0e0, out->t[1], ptm[5], s, zn1);
+            const double dm32 = densu(ws, z, b32, tinf, tlb, xmm, 0e0,
+                                      out->t[1], ptm[5], s, zn1);
             const double zhm32 = zhm28;
             // net density at alt
             out->d[3] = dnet(out->d[3], dm32, zhm32, xmm, 32e0);
@@ -263,22 +250,22 @@ int dso::Nrlmsise00::gts7(const InParamsCore *in,
       // **** AR DENSITY ****
       //
       // BP: 300
-      const double g40 = in->sw.sw[20] * globe7(in, pd[5]);
+      const double g40 = in->sw.sw[20] * globe7(ws, in, pd[5]);
       // diffusive density at Zlb
       db40 = pdm[4][0] * std::exp(g40) * pd[5][0];
       // diffusive density at alt
-      out->d[4] =
-          densu(z, db40, tinf, tlb, 40e0, alpha[4], out->t[1], ptm[5], s, zn1);
+      out->d[4] = densu(ws, z, db40, tinf, tlb, 40e0, alpha[4],
+                        out->t[1], ptm[5], s, zn1);
       dd = out->d[4];
       if (z <= altl[4] && std::abs(in->sw.sw[14]) > 0e0) {
         // turbopause
         const double zh40 = pdm[4][2];
         // mixed density at Zlb
-        const double b40 = densu(zh40, db40, tinf, tlb, 40e0 - xmm,
+        const double b40 = densu(ws, zh40, db40, tinf, tlb, 40e0 - xmm,
                                  alpha[4] - 1e0, out->t[1], ptm[5], s, zn1);
         // mixed density at alt
         const double dm40 =
-            densu(z, b40, tinf, tlb, xmm, 0e0, out->t[1], ptm[5], s, zn1);
+            densu(ws, z, b40, tinf, tlb, xmm, 0e0, out->t[1], ptm[5], s, zn1);
         const double zhm40 = zhm28;
         // net density at alt
         out->d[4] = dnet(out->d[4], dm40, zhm40, xmm, 40e0);
@@ -296,22 +283,22 @@ int dso::Nrlmsise00::gts7(const InParamsCore *in,
       // **** HYDROGEN DENSITY ****
       //
       // BP: 400
-      const double g1 = in->sw.sw[20] * globe7(in, pd[6]);
+      const double g1 = in->sw.sw[20] * globe7(ws, in, pd[6]);
       // diffusive density at zlb
       db01 = pdm[5][0] * std::exp(g1) * pd[6][0];
       // diffusive density at alt
-      out->d[6] =
-          densu(z, db01, tinf, tlb, 1e0, alpha[6], out->t[1], ptm[5], s, zn1);
+      out->d[6] = densu(ws, z, db01, tinf, tlb, 1e0, alpha[6],
+                        out->t[1], ptm[5], s, zn1);
       dd = out->d[6];
       if (z <= altl[6] && std::abs(in->sw.sw[14]) > 0e0) {
         // turbopause
         const double zh01 = pdm[5][2];
         // mixed density at Zlb
-        const double b01 = densu(zh01, db01, tinf, tlb, 1e0 - xmm,
+        const double b01 = densu(ws, zh01, db01, tinf, tlb, 1e0 - xmm,
                                  alpha[6] - 1e0, out->t[1], ptm[5], s, zn1);
         // mixed density at alt
         const double dm01 =
-            densu(z, b01, tinf, tlb, xmm, 0e0, out->t[1], ptm[5], s, zn1);
+            densu(ws, z, b01, tinf, tlb, xmm, 0e0, out->t[1], ptm[5], s, zn1);
         const double zhm01 = zhm28;
         // net density at alt
         out->d[6] = dnet(out->d[6], dm01, zhm01, xmm, 1e0);
@@ -336,22 +323,22 @@ int dso::Nrlmsise00::gts7(const InParamsCore *in,
       // **** ATOMIC NITROGEN DENSITY ****
       //
       // BP: 500
-      const double g14 = in->sw.sw[20] * globe7(in, pd[7]);
+      const double g14 = in->sw.sw[20] * globe7(ws, in, pd[7]);
       // diffusive density at Zlb
       db14 = pdm[6][0] * std::exp(g14) * pd[7][0];
       // diffusive density at alt
-      out->d[7] =
-          densu(z, db14, tinf, tlb, 14e0, alpha[7], out->t[1], ptm[5], s, zn1);
+      out->d[7] = densu(ws, z, db14, tinf, tlb, 14e0, alpha[7],
+                        out->t[1], ptm[5], s, zn1);
       dd = out->d[7];
       if (z <= altl[7] && std::abs(in->sw.sw[14]) > 0e0) {
         // turbopause
         const double zh14 = pdm[6][2];
         // mixed density at Zlb
-        const double b14 = densu(zh14, db14, tinf, tlb, 14e0 - xmm,
+        const double b14 = densu(ws, zh14, db14, tinf, tlb, 14e0 - xmm,
                                  alpha[7] - 1e0, out->t[1], ptm[5], s, zn1);
         // mixed density at alt
         const double dm14 =
-            densu(z, b14, tinf, tlb, xmm, 0e0, out->t[1], ptm[5], s, zn1);
+            densu(ws, z, b14, tinf, tlb, xmm, 0e0, out->t[1], ptm[5], s, zn1);
         const double zhm14 = zhm28;
         // net density at alt
         out->d[7] = dnet(out->d[7], dm14, zhm14, xmm, 14e0);
@@ -376,13 +363,14 @@ int dso::Nrlmsise00::gts7(const InParamsCore *in,
       // **** Anomalous OXYGEN DENSITY ****
       //
       // BP: 600
-      const double g16h = in->sw.sw[20] * globe7(in, pd[8]);
+      const double g16h = in->sw.sw[20] * globe7(ws, in, pd[8]);
       const double db16h = pdm[7][0] * std::exp(g16h) * pd[8][0];
       const double tho = pdm[7][9] * pdl[0][6];
-      dd = densu(z, db16h, tho, tho, 16e0, alpha[8], out->t[1], ptm[5], s, zn1);
+      dd = densu(ws, z, db16h, tho, tho, 16e0, alpha[8], out->t[1], ptm[5], s,
+                 zn1);
       const double zsht = pdm[7][5];
       const double zmho = pdm[7][4];
-      const double zsho = scalh(zmho, 16e0, tho);
+      const double zsho = scalh(ws, zmho, 16e0, tho);
       out->d[8] =
           dd * std::exp(-zsht / zsho * (std::exp(-(z - zmho) / zsht) - 1e0));
       if (mass == 48) {
@@ -402,7 +390,7 @@ int dso::Nrlmsise00::gts7(const InParamsCore *in,
   if (j != 5) {
     // BP: 700
     const double z = std::abs(in->alt);
-    ddum = densu(z, 1e0, tinf, tlb, 0e0, 0e0, out->t[1], ptm[5], s, zn1);
+    ddum = densu(ws, z, 1e0, tinf, tlb, 0e0, 0e0, out->t[1], ptm[5], s, zn1);
   }
 
   if (in->meters()) {
@@ -412,8 +400,5 @@ int dso::Nrlmsise00::gts7(const InParamsCore *in,
     out->d[5] /= 1e3;
   }
 
-  // update last used altitude
-  altlast = in->alt;
-
   return 0;
 }
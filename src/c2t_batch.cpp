@@ -0,0 +1,195 @@
+#include "c2t_table.hpp"
+#include "orbit_integration.hpp"
+#include "iers2010/iersc.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+namespace {
+/// minimum number of rows per thread
+constexpr const int min_rows_per_thread = 2000;
+
+/// minimum number of epochs per thread, for the (expensive) computation of
+/// the celestial-to-terrestrial parameters
+constexpr const int min_epochs_per_thread = 16;
+
+/// Split [0, n) in (contiguous) chunks, one per thread, and call
+/// fn(begin, end) on each; returns non-zero if any call did
+template <typename Fn>
+int run_chunks(int n, int nthreads, const Fn &fn) noexcept {
+  if (nthreads <= 1)
+    return fn(0, n);
+
+  std::vector<int> status(nthreads, 0);
+  std::vector<std::thread> threads;
+  threads.reserve(nthreads);
+  const int chunk = (n + nthreads - 1) / nthreads;
+  for (int t = 0; t < nthreads; t++) {
+    const int begin = std::min(n, t * chunk);
+    const int end = std::min(n, begin + chunk);
+    threads.emplace_back(
+        [&, t, begin, end]() { status[t] = fn(begin, end); });
+  }
+  for (auto &thread : threads)
+    thread.join();
+
+  return std::any_of(status.begin(), status.end(),
+                     [](int s) { return s != 0; });
+}
+
+/// Celestial-to-terrestrial matrix R and its time derivative dR at mjd_tai,
+/// given the rotation pieces (see dso::ycel2ter)
+void c2t_matrix(const Eigen::Matrix<double, 3, 3> &rc2i, double era,
+                const Eigen::Matrix<double, 3, 3> &rpom,
+                [[maybe_unused]] double xlod, Eigen::Matrix<double, 3, 3> &R,
+                Eigen::Matrix<double, 3, 3> &dR) noexcept {
+  const Eigen::Matrix<double, 3, 3> rz =
+      Eigen::AngleAxisd(era, -Eigen::Vector3d::UnitZ()).toRotationMatrix();
+  R = rpom * rz * rc2i;
+#ifdef NEW_EOP
+  const double omega = iers2010::OmegaEarth * (1e0 - xlod / 86400e0);
+#else
+  const double omega = iers2010::OmegaEarth;
+#endif
+  Eigen::Matrix<double, 3, 3> S = Eigen::Matrix<double, 3, 3>::Zero();
+  S(0, 1) = 1e0;
+  S(1, 0) = -1e0;
+  dR = rpom * (omega * S * rz) * rc2i;
+}
+
+/// Transform rows [begin, end) of in to out, computing the rotation once per
+/// run of equal epochs; Source::operator()(mjd, rc2i, era, rpom, xlod)
+/// provides the rotation pieces
+template <typename Source>
+int transform_rows(const double *mjd_tai, const Eigen::MatrixXd &in,
+                   Eigen::MatrixXd &out, bool to_terrestrial, int begin,
+                   int end, const Source &source) noexcept {
+  const bool velocity = (in.cols() == 6);
+  Eigen::Matrix<double, 3, 3> rc2i, rpom, R, dR;
+  double era, xlod;
+
+  int i = begin;
+  while (i < end) {
+    // run of rows at the same epoch
+    int j = i + 1;
+    while (j < end && mjd_tai[j] == mjd_tai[i])
+      ++j;
+    if (source(mjd_tai[i], rc2i, era, rpom, xlod))
+      return 1;
+    c2t_matrix(rc2i, era, rpom, xlod, R, dR);
+
+    // rows are states, hence x' = x * R^T (to terrestrial) or x' = x * R (to
+    // celestial); velocities first, so that input and output may alias
+    const int m = j - i;
+    if (to_terrestrial) {
+      if (velocity)
+        out.block(i, 3, m, 3) = in.block(i, 3, m, 3) * R.transpose() +
+                                in.block(i, 0, m, 3) * dR.transpose();
+      out.block(i, 0, m, 3) = in.block(i, 0, m, 3) * R.transpose();
+    } else {
+      if (velocity)
+        out.block(i, 3, m, 3) =
+            in.block(i, 3, m, 3) * R + in.block(i, 0, m, 3) * dR;
+      out.block(i, 0, m, 3) = in.block(i, 0, m, 3) * R;
+    }
+    i = j;
+  }
+
+  return 0;
+}
+
+/// Transform all rows of in to out, using (up to) nthreads threads
+template <typename Source>
+int transform(const double *mjd_tai, const Eigen::MatrixXd &in,
+              Eigen::MatrixXd &out, bool to_terrestrial, int nthreads,
+              const Source &source) noexcept {
+  if (in.cols() != 3 && in.cols() != 6) {
+    fprintf(stderr,
+            "[ERROR] States should be given as n x 3 or n x 6 matrices "
+            "(traceback: %s)\n",
+            __func__);
+    return 1;
+  }
+  const int n = in.rows();
+  if (out.rows() != n || out.cols() != in.cols())
+    out.resize(n, in.cols());
+
+  // contiguous chunks of rows, one per thread
+  nthreads = std::max(1, std::min(nthreads, n / min_rows_per_thread));
+  return run_chunks(n, nthreads, [&](int begin, int end) {
+    return transform_rows(mjd_tai, in, out, to_terrestrial, begin, end,
+                          source);
+  });
+}
+
+/// Celestial-to-terrestrial parameters at n epochs, using any EOP source
+/// accepted by dso::c2t_quantities
+template <typename EopSource>
+int quantities(const double *mjd_tai, int n, const EopSource &eop_table,
+               dso::CelTerQuantities *q, int nthreads) noexcept {
+  nthreads = std::max(1, std::min(nthreads, n / min_epochs_per_thread));
+  return run_chunks(n, nthreads, [&](int begin, int end) {
+    for (int i = begin; i < end; i++)
+      if (dso::c2t_quantities(mjd_tai[i], eop_table, q[i]))
+        return 1;
+    return 0;
+  });
+}
+
+/// Rotation pieces off of a dso::CelTerTable
+struct TableSource {
+  const dso::CelTerTable &table;
+  int operator()(double mjd, Eigen::Matrix<double, 3, 3> &rc2i, double &era,
+                 Eigen::Matrix<double, 3, 3> &rpom,
+                 double &xlod) const noexcept {
+    return table.gcrs2itrs(mjd, rc2i, era, rpom, xlod);
+  }
+};
+
+/// Rotation pieces via dso::gcrs2itrs
+struct EopSource {
+  const dso::EopLookUpTable &eop_table;
+  int operator()(double mjd, Eigen::Matrix<double, 3, 3> &rc2i, double &era,
+                 Eigen::Matrix<double, 3, 3> &rpom,
+                 double &xlod) const noexcept {
+    return dso::gcrs2itrs(mjd, eop_table, rc2i, era, rpom, xlod);
+  }
+};
+} // unnamed namespace
+
+int dso::cel2ter(const double *mjd_tai, const Eigen::MatrixXd &cel,
+                 Eigen::MatrixXd &ter, const dso::CelTerTable &table,
+                 int nthreads) noexcept {
+  return transform(mjd_tai, cel, ter, true, nthreads, TableSource{table});
+}
+
+int dso::cel2ter(const double *mjd_tai, const Eigen::MatrixXd &cel,
+                 Eigen::MatrixXd &ter, const dso::EopLookUpTable &eop_table,
+                 int nthreads) noexcept {
+  return transform(mjd_tai, cel, ter, true, nthreads, EopSource{eop_table});
+}
+
+int dso::ter2cel(const double *mjd_tai, const Eigen::MatrixXd &ter,
+                 Eigen::MatrixXd &cel, const dso::CelTerTable &table,
+                 int nthreads) noexcept {
+  return transform(mjd_tai, ter, cel, false, nthreads, TableSource{table});
+}
+
+int dso::ter2cel(const double *mjd_tai, const Eigen::MatrixXd &ter,
+                 Eigen::MatrixXd &cel, const dso::EopLookUpTable &eop_table,
+                 int nthreads) noexcept {
+  return transform(mjd_tai, ter, cel, false, nthreads, EopSource{eop_table});
+}
+
+int dso::c2t_quantities(const double *mjd_tai, int n,
+                        const dso::EopLookUpTable &eop_table,
+                        dso::CelTerQuantities *q, int nthreads) noexcept {
+  return quantities(mjd_tai, n, eop_table, q, nthreads);
+}
+
+int dso::c2t_quantities(const double *mjd_tai, int n,
+                        const dso::EopHighRateTable &eop_table,
+                        dso::CelTerQuantities *q, int nthreads) noexcept {
+  return quantities(mjd_tai, n, eop_table, q, nthreads);
+}
@@ -0,0 +1,237 @@
+#include "c2t_table.hpp"
+#include "datetime/utcdates.hpp"
+#include "geodesy/units.hpp"
+#include "iers2010/iau.hpp"
+#include "iers2010/iers2010.hpp"
+#include "lagrange.hpp"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdio>
+
+namespace {
+/// Celestial-to-terrestrial parameters, using any EOP source with an
+/// interpolate(fmjd_tt, EopRecord&) member (see dso::c2t_quantities)
+template <typename EopSource>
+int quantities(double mjd_tai, const EopSource &eop_table,
+               dso::CelTerQuantities &q,
+               const dso::CipChebyshev *cip) noexcept {
+  // TAI MJD to datetime instance
+  int imjd = (int)mjd_tai;
+  double sec = (mjd_tai - (int)mjd_tai) * 86400e0;
+  dso::nanoseconds::underlying_type iSec =
+      static_cast<dso::nanoseconds::underlying_type>(
+          sec * dso::nanoseconds::template sec_factor<double>());
+  dso::datetime<dso::nanoseconds> taidate{dso::modified_julian_day(imjd),
+                                          dso::nanoseconds(iSec)};
+
+  // TAI to TT
+  dso::datetime<dso::nanoseconds> ttdate(taidate);
+  ttdate.add_seconds(dso::nanoseconds(32184 * 1'000'000L));
+
+  // interpolate/correct EOP values using TT
+  dso::EopRecord eops;
+  if (int error; (error = eop_table.interpolate(ttdate.as_mjd(), eops))) {
+    fprintf(stderr, "ERROR. Failed getting EOP values (status: %d)\n", error);
+    return error;
+  }
+
+  // assign interpolated LOD value
+  q.lod = eops.lod;
+
+  if (cip && cip->contains(ttdate.as_mjd())) {
+    // X,Y and s off of the Chebyshev fit (of the series below)
+    cip->evaluate(ttdate.as_mjd(), q.X, q.Y, q.s);
+  } else {
+    // X,Y coordinates of celestial intermediate pole from series based
+    // on IAU 2006 precession and IAU 2000A nutation.
+    iers2010::sofa::xy06(dso::mjd0_jd, ttdate.as_mjd(), q.X, q.Y);
+
+    // The CIO locator s, positioning the Celestial Intermediate Origin on
+    // the equator of the Celestial Intermediate Pole, given the CIP's X,Y
+    // coordinates. Compatible with IAU 2006/2000A precession-nutation.
+    q.s = iers2010::sofa::s06(dso::mjd0_jd, ttdate.as_mjd(), q.X, q.Y);
+  }
+
+  // Add CIP corrections (arcsec to radians)
+  q.X += dso::arcsec2rad(eops.dx);
+  q.Y += dso::arcsec2rad(eops.dy);
+
+  // UT1-TAI [sec]; UTC-TAI from the (integral) day difference and the
+  // fractional parts, plus UT1-UTC, interpolated
+  dso::modified_julian_day utc_mjd;
+  const double utc = dso::tai2utc(taidate, utc_mjd); // fractional part
+  q.ut1_tai = (static_cast<double>(utc_mjd.as_underlying_type() - imjd) +
+               (utc - sec / 86400e0)) *
+                  86400e0 +
+              eops.dut;
+
+  // Estimate s' [radians]
+  q.sp = iers2010::sofa::sp00(dso::mjd0_jd, ttdate.as_mjd());
+
+  // polar motion in radians
+  q.xp = dso::arcsec2rad(eops.xp);
+  q.yp = dso::arcsec2rad(eops.yp);
+
+  return 0;
+}
+} // unnamed namespace
+
+int dso::c2t_quantities(double mjd_tai, const dso::EopLookUpTable &eop_table,
+                        dso::CelTerQuantities &q,
+                        const dso::CipChebyshev *cip) noexcept {
+  return quantities(mjd_tai, eop_table, q, cip);
+}
+
+int dso::c2t_quantities(double mjd_tai, const dso::EopHighRateTable &eop_table,
+                        dso::CelTerQuantities &q,
+                        const dso::CipChebyshev *cip) noexcept {
+  return quantities(mjd_tai, eop_table, q, cip);
+}
+
+void dso::c2t_matrices(double mjd_tai, const dso::CelTerQuantities &q,
+                       Eigen::Matrix<double, 3, 3> &rc2i, double &era,
+                       Eigen::Matrix<double, 3, 3> &rpom) noexcept {
+  // Form the celestial to intermediate-frame-of-date matrix given the CIP
+  // X,Y and the CIO locator s.
+  // [TRS] = RPOM * R_3(ERA) * rc2i * [CRS]  = RC2T * [CRS]
+  rc2i = iers2010::sofa::c2ixys_e(q.X, q.Y, q.s);
+
+  // ERA00 to get the ERA rotation angle (need UT1 date); keep the integral
+  // day in the first part of the date, to preserve the resolution of the
+  // (small) UT1-TAI offset
+  const double imjd = std::floor(mjd_tai);
+  era = iers2010::sofa::era00(dso::mjd0_jd + imjd,
+                              (mjd_tai - imjd) + q.ut1_tai / 86400e0);
+
+  // Form the polar motion matrix (W)
+  rpom = iers2010::sofa::pom00_e(q.xp, q.yp, q.sp);
+}
+
+template <typename EopSource>
+int dso::CelTerTable::build_nodes(double mjd_start, double mjd_end,
+                                  const EopSource &eop_table,
+                                  int nthreads) noexcept {
+  nodes.clear();
+  if (mjd_end < mjd_start || order < 1 || step <= 0e0) {
+    fprintf(stderr,
+            "[ERROR] Invalid arc or table parameters (traceback: %s)\n",
+            __func__);
+    return 1;
+  }
+
+  // nodes, extended by order/2 on each side
+  const double h = step / 86400e0;
+  const int half = order / 2;
+  const int n =
+      (int)std::ceil((mjd_end - mjd_start) / h) + 1 + 2 * half;
+  mjd_first = mjd_start - half * h;
+
+  std::vector<double> epochs(n);
+  for (int i = 0; i < n; i++)
+    epochs[i] = mjd_first + i * h;
+  nodes.resize(n);
+  if (dso::c2t_quantities(epochs.data(), n, eop_table, nodes.data(),
+                          nthreads)) {
+    fprintf(stderr,
+            "[ERROR] Failed computing table nodes for MJD [%.6f, %.6f] "
+            "(traceback: %s)\n",
+            epochs[0], epochs[n - 1], __func__);
+    nodes.clear();
+    return 1;
+  }
+
+  return 0;
+}
+
+int dso::CelTerTable::build(double mjd_start, double mjd_end,
+                            const dso::EopLookUpTable &eop_table,
+                            int nthreads) noexcept {
+  return build_nodes(mjd_start, mjd_end, eop_table, nthreads);
+}
+
+int dso::CelTerTable::build(double mjd_start, double mjd_end,
+                            const dso::EopHighRateTable &eop_table,
+                            int nthreads) noexcept {
+  return build_nodes(mjd_start, mjd_end, eop_table, nthreads);
+}
+
+int dso::CelTerTable::interpolate(double mjd_tai,
+                                  dso::CelTerQuantities &q) const noexcept {
+  if (!contains(mjd_tai)) {
+    fprintf(stderr,
+            "[ERROR] Epoch MJD %.6f out of table range (traceback: %s)\n",
+            mjd_tai, __func__);
+    return 1;
+  }
+
+  // window of order+1 nodes, (about) centered at the epoch
+  const double u = (mjd_tai - mjd_first) * 86400e0 / step;
+  const int np = std::min(order + 1, size());
+  int first = (int)std::floor(u) - (np - 1) / 2;
+  first = std::max(0, std::min(first, size() - np));
+
+  // Lagrange weights, at u - first (nodes at 0, 1, ..., np-1)
+  double w[32];
+  assert(np <= 32);
+  dso::lagrange_weights(u - first, np, w);
+
+  q = dso::CelTerQuantities{0e0, 0e0, 0e0, 0e0, 0e0, 0e0, 0e0, 0e0};
+  for (int j = 0; j < np; j++) {
+    const dso::CelTerQuantities &p = nodes[first + j];
+    q.X += w[j] * p.X;
+    q.Y += w[j] * p.Y;
+    q.s += w[j] * p.s;
+    q.ut1_tai += w[j] * p.ut1_tai;
+    q.xp += w[j] * p.xp;
+    q.yp += w[j] * p.yp;
+    q.sp += w[j] * p.sp;
+    q.lod += w[j] * p.lod;
+  }
+
+  return 0;
+}
+
+int dso::CelTerTable::gcrs2itrs(double mjd_tai,
+                                Eigen::Matrix<double, 3, 3> &rc2i, double &era,
+                                Eigen::Matrix<double, 3, 3> &rpom,
+                                double &xlod) const noexcept {
+  dso::CelTerQuantities q;
+  if (interpolate(mjd_tai, q))
+    return 1;
+  xlod = q.lod;
+  dso::c2t_matrices(mjd_tai, q, rc2i, era, rpom);
+  return 0;
+}
+
+int dso::CelTerTable::verify(const dso::EopLookUpTable &eop_table,
+                             double &max_angle, int n) const noexcept {
+  max_angle = 0e0;
+  if (nodes.empty() || n < 1)
+    return 1;
+
+  // covered arc; test epochs are offset by a fraction of the step, so that
+  // they do not coincide with the nodes
+  const double span = (size() - 1) * step / 86400e0;
+  const double dt = span / n;
+  dso::CelTerQuantities qe, qi;
+  Eigen::Matrix<double, 3, 3> rc2i, rpom;
+  double era;
+  for (int i = 0; i < n; i++) {
+    const double mjd = mjd_first + (i + 0.37e0) * dt;
+    if (dso::c2t_quantities(mjd, eop_table, qe) || interpolate(mjd, qi))
+      return 1;
+    // exact and interpolated celestial-to-terrestrial matrices
+    dso::c2t_matrices(mjd, qe, rc2i, era, rpom);
+    const Eigen::Matrix<double, 3, 3> ce =
+        rpom * (Eigen::AngleAxisd(era, -Eigen::Vector3d::UnitZ()) * rc2i);
+    dso::c2t_matrices(mjd, qi, rc2i, era, rpom);
+    const Eigen::Matrix<double, 3, 3> ci =
+        rpom * (Eigen::AngleAxisd(era, -Eigen::Vector3d::UnitZ()) * rc2i);
+    // angle of the (small) rotation ci * ce^T
+    const Eigen::AngleAxisd d(Eigen::Matrix<double, 3, 3>(ci * ce.transpose()));
+    max_angle = std::max(max_angle, std::abs(d.angle()));
+  }
+
+  return 0;
+}
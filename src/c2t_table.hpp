@@ -0,0 +1,215 @@
+#ifndef __DSO_CELESTIAL_TERRESTRIAL_TABLE_HPP__
+#define __DSO_CELESTIAL_TERRESTRIAL_TABLE_HPP__
+
+#include "cip_chebyshev.hpp"
+#include "eop.hpp"
+#include "eigen3/Eigen/Eigen"
+#include <vector>
+
+namespace dso {
+
+/// @brief The (smooth) parameters of the celestial-to-terrestrial
+///        transformation (IAU 2006/2000A, CIO based) at some epoch; the
+///        transformation matrices follow via dso::c2t_matrices.
+struct CelTerQuantities {
+  /// CIP coordinates, including the (interpolated) corrections dX, dY [rad]
+  double X, Y;
+  /// CIO locator s [rad]
+  double s;
+  /// UT1 - TAI [sec]; continuous across leap seconds
+  double ut1_tai;
+  /// polar motion coordinates [rad]
+  double xp, yp;
+  /// TIO locator s' [rad]
+  double sp;
+  /// length of day [sec/day]
+  double lod;
+}; // CelTerQuantities
+
+/// @brief Compute the celestial-to-terrestrial parameters at the given
+///        epoch (EOP interpolation, X/Y series, s and s'); this is the
+///        expensive part of dso::gcrs2itrs.
+/// @param[in] mjd_tai TAI date as MJD
+/// @param[in] eop_table EOP look-up table (see dso::parse_iers_C04)
+/// @param[out] q The parameters at mjd_tai
+/// @param[in] cip If given (and fitted for the epoch), X, Y and s are
+///            computed off of this Chebyshev fit instead of the series
+/// @return Anything other than 0 denotes an error (EOP interpolation failed)
+int c2t_quantities(double mjd_tai, const dso::EopLookUpTable &eop_table,
+                   CelTerQuantities &q,
+                   const dso::CipChebyshev *cip = nullptr) noexcept;
+
+/// @brief Same as above, but using a high-rate (pre-corrected) EOP table
+///        (see dso::EopHighRateTable), hence no evaluation of the sub-daily
+///        correction series
+int c2t_quantities(double mjd_tai, const dso::EopHighRateTable &eop_table,
+                   CelTerQuantities &q,
+                   const dso::CipChebyshev *cip = nullptr) noexcept;
+
+/// @brief Batch version of dso::c2t_quantities, for n epochs; epochs are
+///        split in (contiguous) chunks, one per thread.
+/// @param[in] mjd_tai Array of n TAI dates as MJD
+/// @param[in] n Number of epochs
+/// @param[in] eop_table EOP look-up table (see dso::parse_iers_C04)
+/// @param[out] q Array of (at least) n instances, the parameters per epoch
+/// @param[in] nthreads Maximum number of threads to use
+/// @return Anything other than 0 denotes an error (for any epoch)
+int c2t_quantities(const double *mjd_tai, int n,
+                   const dso::EopLookUpTable &eop_table, CelTerQuantities *q,
+                   int nthreads = 1) noexcept;
+
+/// @brief Same as above, but using a high-rate EOP table (see
+///        dso::EopHighRateTable)
+int c2t_quantities(const double *mjd_tai, int n,
+                   const dso::EopHighRateTable &eop_table,
+                   CelTerQuantities *q, int nthreads = 1) noexcept;
+
+/// @brief Form the celestial-to-terrestrial matrices (see dso::gcrs2itrs)
+///        off of the given parameters.
+/// @param[in] mjd_tai TAI date as MJD (used for the Earth Rotation Angle)
+/// @param[in] q Parameters at mjd_tai
+/// @param[out] rc2i Celestial-to-intermediate matrix
+/// @param[out] era Earth Rotation Angle [rad]
+/// @param[out] rpom Polar motion matrix
+void c2t_matrices(double mjd_tai, const CelTerQuantities &q,
+                  Eigen::Matrix<double, 3, 3> &rc2i, double &era,
+                  Eigen::Matrix<double, 3, 3> &rpom) noexcept;
+
+/// @brief A table of the celestial-to-terrestrial parameters (see
+///        dso::CelTerQuantities) over an arc, at a fixed cadence, to be
+///        interpolated instead of calling dso::gcrs2itrs at every epoch.
+///
+/// Parameters are interpolated via Lagrange polynomials on the (uniform)
+/// grid, using the order+1 nodes around the epoch; the Earth Rotation Angle
+/// is computed (exactly) off of the interpolated UT1-TAI. An interpolation
+/// costs some hundred flops plus the few trigonometric functions of the
+/// matrices (no series evaluation nor EOP interpolation).
+///
+/// Error budget (interpolation vs the exact path, i.e. dso::gcrs2itrs): for
+/// a harmonic term of amplitude A and period P, the error is bounded by
+/// A (2πh/P)^(n+1) max|Π(u-k)| / (n+1)!, with h the node spacing and n the
+/// order. With the defaults (h = 1 hour, n = 8), this is ~2e-6 A for the
+/// semi-diurnal ocean-tide and libration terms of polar motion and UT1
+/// (A < 1 mas, i.e. < 2e-6 mas), and negligible for the (≥ 5 day)
+/// nutation terms of X, Y. What remains is the lack of smoothness of the
+/// daily EOP Lagrange interpolation (dso::EopLookUpTable::interpolate) at
+/// the day boundaries; use verify to measure the actual error for a given
+/// arc (typically well below 1 μas, i.e. < 0.05 mm on the Earth's surface).
+///
+/// Example:
+///   dso::CelTerTable c2t;
+///   if (c2t.build(mjd_start, mjd_end, eops)) { ... error ... }
+///   params.c2t_table = &c2t; // see dso::update_time_cache
+class CelTerTable {
+public:
+  /// @brief Constructor
+  /// @param[in] _step Node spacing [sec]
+  /// @param[in] _order Order of the Lagrange interpolation (uses order+1
+  ///            nodes); should be even
+  explicit CelTerTable(double _step = 3600e0, int _order = 8) noexcept
+      : step(_step), order(_order) {}
+
+  /// @brief (Re-)build the table for the arc [mjd_start, mjd_end] (TAI);
+  ///        the table is extended by order/2 nodes on each side, so that
+  ///        interpolation is centered everywhere within the arc.
+  /// @param[in] nthreads Maximum number of threads to use for the nodes
+  ///            (see the batch dso::c2t_quantities)
+  /// @return Anything other than 0 denotes an error (e.g. EOP table does not
+  ///         cover the arc)
+  int build(double mjd_start, double mjd_end,
+            const dso::EopLookUpTable &eop_table, int nthreads = 1) noexcept;
+
+  /// @brief Same as above, but using a high-rate EOP table (see
+  ///        dso::EopHighRateTable), i.e. no evaluation of the sub-daily EOP
+  ///        corrections at the nodes. The high-rate table must cover the
+  ///        extended arc (order/2 nodes on each side), in TT.
+  int build(double mjd_start, double mjd_end,
+            const dso::EopHighRateTable &eop_table,
+            int nthreads = 1) noexcept;
+
+  /// @brief Number of nodes
+  int size() const noexcept { return nodes.size(); }
+
+  /// @brief Check if the given TAI epoch is covered by the table
+  bool contains(double mjd_tai) const noexcept {
+    return !nodes.empty() && mjd_tai >= mjd_first &&
+           mjd_tai <= mjd_first + (size() - 1) * step / 86400e0;
+  }
+
+  /// @brief Interpolate the parameters at the given epoch
+  /// @return Anything other than 0 denotes an error (epoch not covered)
+  int interpolate(double mjd_tai, CelTerQuantities &q) const noexcept;
+
+  /// @brief Same as dso::gcrs2itrs, but using the table
+  /// @return Anything other than 0 denotes an error (epoch not covered)
+  int gcrs2itrs(double mjd_tai, Eigen::Matrix<double, 3, 3> &rc2i,
+                double &era, Eigen::Matrix<double, 3, 3> &rpom,
+                double &xlod) const noexcept;
+
+  /// @brief Compare the table against the exact path (dso::c2t_quantities)
+  ///        at n epochs evenly spaced over the covered arc (off the nodes).
+  /// @param[in] eop_table The EOP look-up table used to build the table
+  /// @param[out] max_angle Maximum angle of the rotation between the
+  ///            interpolated and the exact celestial-to-terrestrial matrix
+  ///            [rad]
+  /// @param[in] n Number of test epochs
+  /// @return Anything other than 0 denotes an error
+  int verify(const dso::EopLookUpTable &eop_table, double &max_angle,
+             int n = 1000) const noexcept;
+
+private:
+  /// node spacing [sec] and interpolation order
+  double step;
+  int order;
+  /// epoch of the first node, TAI MJD
+  double mjd_first{0e0};
+  /// parameters at the nodes
+  std::vector<CelTerQuantities> nodes;
+
+  /// @brief Build the nodes, using any EOP source (see build)
+  template <typename EopSource>
+  int build_nodes(double mjd_start, double mjd_end, const EopSource &eop_table,
+                  int nthreads) noexcept;
+}; // CelTerTable
+
+/// @brief Batch celestial-to-terrestrial transformation of n states, at n
+///        epochs.
+///
+/// States are given in structure-of-arrays layout, i.e. as n x 3 (position)
+/// or n x 6 (position and velocity) matrices, one row per epoch (so that
+/// each column, e.g. all x components, is contiguous). For velocities, the
+/// rotation of the terrestrial frame is accounted for (as in
+/// dso::ycel2ter). The transformation matrix is computed once per distinct
+/// epoch (i.e. for consecutive rows with the same epoch, e.g. positions of
+/// several beacons) and applied to all of its rows at once. For long
+/// spans, the rows are split in (contiguous) chunks, one per thread.
+/// Input and output may be the same matrix.
+/// @param[in] mjd_tai Array of n epochs, TAI MJD
+/// @param[in] cel Celestial states, n x 3 or n x 6 [m] and [m/sec]
+/// @param[out] ter Terrestrial states, same size as cel
+/// @param[in] table Celestial-to-terrestrial table (must cover all epochs)
+/// @param[in] nthreads Maximum number of threads to use
+/// @return Anything other than 0 denotes an error
+int cel2ter(const double *mjd_tai, const Eigen::MatrixXd &cel,
+            Eigen::MatrixXd &ter, const dso::CelTerTable &table,
+            int nthreads = 1) noexcept;
+
+/// @brief Same as above, computing the transformation via dso::gcrs2itrs
+int cel2ter(const double *mjd_tai, const Eigen::MatrixXd &cel,
+            Eigen::MatrixXd &ter, const dso::EopLookUpTable &eop_table,
+            int nthreads = 1) noexcept;
+
+/// @brief Batch terrestrial-to-celestial transformation of n states, at n
+///        epochs; the inverse of dso::cel2ter (see there for details)
+int ter2cel(const double *mjd_tai, const Eigen::MatrixXd &ter,
+            Eigen::MatrixXd &cel, const dso::CelTerTable &table,
+            int nthreads = 1) noexcept;
+
+/// @brief Same as above, computing the transformation via dso::gcrs2itrs
+int ter2cel(const double *mjd_tai, const Eigen::MatrixXd &ter,
+            Eigen::MatrixXd &cel, const dso::EopLookUpTable &eop_table,
+            int nthreads = 1) noexcept;
+
+} // namespace dso
+
+#endif
@@ -0,0 +1,39 @@
+#ifndef __DSO_CHEBYSHEV_SERIES_HPP__
+#define __DSO_CHEBYSHEV_SERIES_HPP__
+
+namespace dso {
+
+/// @brief Evaluate the Chebyshev series Σ c_k T_k(x), k=0,...,n-1, via
+///        Clenshaw's recurrence:
+///        b_k = c_k + 2x b_{k+1} - b_{k+2}, sum = c_0 + x b_1 - b_2
+///
+/// Convention: all coefficients, including c_0, are used as given, i.e.
+/// the series is NOT the Σ' (first term halved) form. Fits via the discrete
+/// cosine transform, c_j = (2/n) Σ f(x_k) T_j(x_k), should thus store
+/// c_0 halved (i.e. with a factor of 1/n).
+///
+/// The coefficients are given via a callable, so that they can be scalars
+/// or vectors (e.g. all components of a state, as Eigen column vectors),
+/// stored in any layout.
+/// @param[in] n Number of coefficients (i.e. degree + 1), n >= 1
+/// @param[in] x Evaluation point, in [-1, 1]
+/// @param[in] coef Callable; coef(k) returns the coefficient c_k, of type T
+///            (or an expression convertible to T)
+/// @param[in] zero A zero value of type T (e.g. 0e0, or a zero vector of
+///            the right size)
+/// @return The sum of the series at x
+template <typename T, typename CoefFn>
+T clenshaw(int n, double x, const CoefFn &coef, const T &zero) noexcept {
+  T b1 = zero, b2 = zero;
+  const double x2 = 2e0 * x;
+  for (int k = n - 1; k >= 1; k--) {
+    T b = coef(k) + x2 * b1 - b2;
+    b2 = b1;
+    b1 = b;
+  }
+  return coef(0) + x * b1 - b2;
+}
+
+} // namespace dso
+
+#endif
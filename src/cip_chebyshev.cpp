@@ -0,0 +1,124 @@
+#include "cip_chebyshev.hpp"
+#include "chebyshev.hpp"
+#include "datetime/dtcalendar.hpp"
+#include "iers2010/iau.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+namespace {
+/// day (segment) of a TT epoch
+long day_of(double mjd_tt) noexcept { return (long)std::floor(mjd_tt); }
+} // unnamed namespace
+
+void dso::CipChebyshev::fit(long day, Segment &seg) const noexcept {
+  const int n = degree + 1;
+  seg.day = day;
+  seg.cx.assign(n, 0e0);
+  seg.cy.assign(n, 0e0);
+  seg.cs.assign(n, 0e0);
+
+  // series at the Chebyshev nodes of [day, day+1)
+  std::vector<double> fx(n), fy(n), fs(n);
+  for (int k = 0; k < n; k++) {
+    const double u = std::cos(M_PI * (k + 0.5e0) / n);
+    const double fday = 0.5e0 * (u + 1e0);
+    // keep the integral day in the first part of the date
+    const double jd1 = dso::mjd0_jd + day;
+    iers2010::sofa::xy06(jd1, fday, fx[k], fy[k]);
+    fs[k] = iers2010::sofa::s06(jd1, fday, fx[k], fy[k]);
+  }
+
+  // coefficients (discrete cosine transform); the first one is halved (see
+  // dso::clenshaw)
+  for (int j = 0; j < n; j++) {
+    double sx = 0e0, sy = 0e0, ss = 0e0;
+    for (int k = 0; k < n; k++) {
+      const double c = std::cos(M_PI * j * (k + 0.5e0) / n);
+      sx += fx[k] * c;
+      sy += fy[k] * c;
+      ss += fs[k] * c;
+    }
+    const double w = (j ? 2e0 : 1e0) / n;
+    seg.cx[j] = w * sx;
+    seg.cy[j] = w * sy;
+    seg.cs[j] = w * ss;
+  }
+}
+
+const dso::CipChebyshev::Segment *
+dso::CipChebyshev::find(long day) const noexcept {
+  auto it = std::lower_bound(
+      segments.begin(), segments.end(), day,
+      [](const Segment &seg, long d) { return seg.day < d; });
+  return (it != segments.end() && it->day == day) ? &(*it) : nullptr;
+}
+
+int dso::CipChebyshev::build(double mjd_tt_start, double mjd_tt_end) noexcept {
+  if (mjd_tt_end < mjd_tt_start || degree < 1) {
+    fprintf(stderr,
+            "[ERROR] Invalid interval or degree for CIP fit (traceback: %s)\n",
+            __func__);
+    return 1;
+  }
+  for (long day = day_of(mjd_tt_start); day <= day_of(mjd_tt_end); day++) {
+    if (find(day))
+      continue;
+    Segment seg;
+    fit(day, seg);
+    segments.insert(std::upper_bound(segments.begin(), segments.end(), day,
+                                     [](long d, const Segment &s) {
+                                       return d < s.day;
+                                     }),
+                    std::move(seg));
+  }
+  return 0;
+}
+
+bool dso::CipChebyshev::contains(double mjd_tt) const noexcept {
+  return find(day_of(mjd_tt)) != nullptr;
+}
+
+int dso::CipChebyshev::num_segments() const noexcept { return segments.size(); }
+
+int dso::CipChebyshev::evaluate(double mjd_tt, double &X, double &Y,
+                                double &s) const noexcept {
+  const long day = day_of(mjd_tt);
+  const Segment *seg = find(day);
+  if (!seg) {
+    fprintf(stderr,
+            "[ERROR] No CIP fit for MJD=%.6f [TT] (traceback: %s)\n", mjd_tt,
+            __func__);
+    return 1;
+  }
+  // map the day to [-1, 1]
+  const double u = 2e0 * (mjd_tt - day) - 1e0;
+  const int n = seg->cx.size();
+  X = dso::clenshaw(n, u, [&](int k) { return seg->cx[k]; }, 0e0);
+  Y = dso::clenshaw(n, u, [&](int k) { return seg->cy[k]; }, 0e0);
+  s = dso::clenshaw(n, u, [&](int k) { return seg->cs[k]; }, 0e0);
+  return 0;
+}
+
+int dso::CipChebyshev::evaluate_or_fit(double mjd_tt, double &X, double &Y,
+                                       double &s) noexcept {
+  if (!contains(mjd_tt) && build(mjd_tt, mjd_tt))
+    return 1;
+  return evaluate(mjd_tt, X, Y, s);
+}
+
+void dso::CipChebyshev::verify(double &max_xy, double &max_s,
+                               int n) const noexcept {
+  max_xy = max_s = 0e0;
+  for (const auto &seg : segments) {
+    for (int i = 0; i < n; i++) {
+      const double fday = (i + 0.5e0) / n;
+      double X, Y, s, Xf, Yf, sf;
+      iers2010::sofa::xy06(dso::mjd0_jd + seg.day, fday, X, Y);
+      s = iers2010::sofa::s06(dso::mjd0_jd + seg.day, fday, X, Y);
+      evaluate(seg.day + fday, Xf, Yf, sf);
+      max_xy = std::max(max_xy, std::max(std::abs(X - Xf), std::abs(Y - Yf)));
+      max_s = std::max(max_s, std::abs(s - sf));
+    }
+  }
+}
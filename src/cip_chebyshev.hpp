@@ -0,0 +1,76 @@
+#ifndef __DSO_CIP_CHEBYSHEV_FIT_HPP__
+#define __DSO_CIP_CHEBYSHEV_FIT_HPP__
+
+#include <vector>
+
+namespace dso {
+
+/// @brief Chebyshev approximation of the CIP coordinates X, Y and the CIO
+///        locator s (IAU 2006/2000A, i.e. iers2010::sofa::xy06 and
+///        iers2010::sofa::s06), over day-long segments.
+///
+/// Each (TT) day is fitted with Chebyshev polynomials of the given degree,
+/// interpolating the full series at the Chebyshev nodes of the day; values
+/// are then computed via Clenshaw's recurrence (a few dozen flops instead
+/// of the ~1300 nutation terms). The shortest periods of (significant)
+/// terms are a few days, hence the fit converges fast: the error is ~1e-4
+/// μas for degree 6 and at the level of rounding (~3e-6 μas) for the
+/// default degree 8 (see verify). Note that the (EOP-derived) CIP
+/// corrections dX, dY are not included.
+///
+/// Segments are fitted either in advance (build) or on first use
+/// (evaluate_or_fit); the const evaluate only uses already fitted segments
+/// and is safe to call concurrently.
+class CipChebyshev {
+public:
+  /// @brief Constructor
+  /// @param[in] _degree Degree of the Chebyshev polynomials
+  explicit CipChebyshev(int _degree = 8) noexcept : degree(_degree) {}
+
+  /// @brief Fit all (day-long) segments covering [mjd_tt_start,
+  ///        mjd_tt_end]
+  /// @return Anything other than 0 denotes an error
+  int build(double mjd_tt_start, double mjd_tt_end) noexcept;
+
+  /// @brief Check if the segment of the given (TT) epoch is fitted
+  bool contains(double mjd_tt) const noexcept;
+
+  /// @brief X, Y [rad] and s [rad] at the given epoch (MJD, TT), off of an
+  ///        already fitted segment.
+  /// @return Anything other than 0 denotes an error (segment not fitted)
+  int evaluate(double mjd_tt, double &X, double &Y, double &s) const noexcept;
+
+  /// @brief Same as evaluate, but fits the segment of the epoch first, if
+  ///        needed (not to be called concurrently)
+  int evaluate_or_fit(double mjd_tt, double &X, double &Y, double &s) noexcept;
+
+  /// @brief Maximum error of the fit w.r.t. the full series (xy06 and
+  ///        s06), at n epochs per fitted segment (off the nodes).
+  /// @param[out] max_xy Maximum error of X, Y [rad]
+  /// @param[out] max_s Maximum error of s [rad]
+  void verify(double &max_xy, double &max_s, int n = 97) const noexcept;
+
+  /// @brief Number of fitted segments
+  int num_segments() const noexcept;
+
+private:
+  /// Chebyshev coefficients of a (day-long) segment; (degree+1) per series
+  struct Segment {
+    long day;
+    std::vector<double> cx, cy, cs;
+  }; // Segment
+
+  /// fit the segment of the given day
+  void fit(long day, Segment &seg) const noexcept;
+
+  /// the (fitted) segment of the given day, or nullptr
+  const Segment *find(long day) const noexcept;
+
+  int degree;
+  /// fitted segments, sorted by day
+  std::vector<Segment> segments;
+}; // CipChebyshev
+
+} // namespace dso
+
+#endif
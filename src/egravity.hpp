@@ -6,6 +6,7 @@
 #include "harmonic_coeffs.hpp"
 #include "matvec/matvec.hpp"
 #include <cassert>
+#include <vector>
 #ifdef DEBUG
 #include <cstdio>
 #endif
@@ -156,14 +157,46 @@ grav_potential_accel(int degree, int order,
       partials);
 }
 
+/// @brief Acceleration due to the zonal part (order m=0) of the harmonic
+///        gravity field of the central body.
+/// This is a specialized version of grav_potential_accel for order=0; it
+/// does not need (or touch) any V/W Lagrange polynomials matrices, since the
+/// needed terms (V(n,0), V(n,1) and W(n,1)) are computed on the fly.
+/// @param[in] pos Position vector in an Earth-fixed coordinate system [m]
+/// @param[in] degree Maximum degree; less or equal to the degree of the hc
+/// @param[in] hc Spherical harmonics coefficients (un-normalized); the values
+///               of Re and GM are extracted from this instance
+/// @return Acceleration in the same Earth-fixed coordinate system [m/sec^2]
+Eigen::Matrix<double, 3, 1>
+grav_potential_accel_zonal(const Eigen::Matrix<double, 3, 1> &pos, int degree,
+                           const dso::HarmonicCoeffs &hc) noexcept;
+
+/// @brief Acceleration and its partials w.r.t. position (i.e. the gradient),
+///        due to the zonal part (order m=0) of the harmonic gravity field of
+///        the central body.
+/// Same as the above, but also computes the (symmetric) partials matrix,
+/// which needs the additional V(n,2) and W(n,2) terms (also computed on the
+/// fly).
+/// @param[out] partials Partials of the acceleration w.r.t. the position
+///               vector, d(acc)/dr (3x3)
+Eigen::Matrix<double, 3, 1>
+grav_potential_accel_zonal(const Eigen::Matrix<double, 3, 1> &pos, int degree,
+                           const dso::HarmonicCoeffs &hc,
+                           Eigen::Matrix<double, 3, 3> &partials) noexcept;
+
 // Here, the values of Re and GM are extracted from the Gravity model, aka
 // the passed in hc instance
 // Lagrange polynomials are computed using the position [x,y,z]=pos(0:3)
+// If order is 0, the zonal-only version (grav_potential_accel_zonal) is
+// used, and V and W are left untouched.
 inline Eigen::Matrix<double, 3, 1>
 grav_potential_accel(const Eigen::Matrix<double, 3, 1> &pos, int degree,
                      int order, dso::Mat2D<MatrixStorageType::Trapezoid> &V,
                      dso::Mat2D<MatrixStorageType::Trapezoid> &W,
                      const dso::HarmonicCoeffs &hc) noexcept {
+  // zonal-only fast path
+  if (!order)
+    return grav_potential_accel_zonal(pos, degree, hc);
   // validate the size of V and W
   assert(V.rows() >= degree + 2 && V.cols() >= order + 2);
   assert(W.rows() >= degree + 2 && W.cols() >= order + 2);
@@ -178,12 +211,17 @@ grav_potential_accel(const Eigen::Matrix<double, 3, 1> &pos, int degree,
 // Note that if we want the partials, V and W indexes must span [0,degree+2]
 // (hence the actual number should be degree+3).
 // Lagrange polynomials are computed using the position [x,y,z]=pos(0:3)
+// If order is 0, the zonal-only version (grav_potential_accel_zonal) is
+// used, and V and W are left untouched.
 inline Eigen::Matrix<double, 3, 1>
 grav_potential_accel(const Eigen::Matrix<double, 3, 1> &pos, int degree,
                      int order, dso::Mat2D<MatrixStorageType::Trapezoid> &V,
                      dso::Mat2D<MatrixStorageType::Trapezoid> &W,
                      const dso::HarmonicCoeffs &hc,
                      Eigen::Matrix<double, 3, 3> &partials) noexcept {
+  // zonal-only fast path
+  if (!order)
+    return grav_potential_accel_zonal(pos, degree, hc, partials);
   // validate the size of V and W
   assert(V.rows() == degree + 3 && V.cols() == order + 3);
   assert(W.rows() == degree + 3 && W.cols() == order + 3);
@@ -193,6 +231,55 @@ grav_potential_accel(const Eigen::Matrix<double, 3, 1> &pos, int degree,
   return grav_potential_accel(degree, order, hc.Re(), hc.GM(), V, W, hc,
                               partials);
 }
+
+/// @brief Number of positions processed at once (one per SIMD lane) by
+///        dso::GravityLanes
+constexpr const int GravityNumLanes = 4;
+
+/// @brief Batched evaluation of the geopotential acceleration, for a number
+///        of positions (e.g. the members of an ensemble) at once.
+///
+/// The positions are processed in groups of GravityNumLanes; within a group,
+/// the Lagrange polynomials recursion and the harmonic sums are carried out
+/// for all positions simultaneously (one position per SIMD lane), sharing
+/// the loads of the (C, S) coefficients. The results are the same as the
+/// ones of (the scalar) dso::grav_potential_accel.
+/// The instance holds the V and W work space, allocated at construction.
+class GravityLanes {
+public:
+  using Lane = Eigen::Array<double, GravityNumLanes, 1>;
+
+  /// @brief Constructor
+  /// @param[in] degree Maximum degree of the expansion
+  /// @param[in] order Maximum order of the expansion (<= degree)
+  GravityLanes(int degree, int order) noexcept;
+
+  int degree() const noexcept { return m_degree; }
+  int order() const noexcept { return m_order; }
+
+  /// @brief Acceleration for K positions (given and returned in SoA layout)
+  /// @param[in] K Number of positions
+  /// @param[in] x, y, z Position components in an Earth-fixed coordinate
+  ///            system [m], arrays of size K
+  /// @param[in] hc Spherical harmonics coefficients (un-normalized); the
+  ///            values of Re and GM are extracted from this instance
+  /// @param[out] ax, ay, az Acceleration components in the same Earth-fixed
+  ///            coordinate system [m/sec^2], arrays of size K
+  void accel(int K, const double *x, const double *y, const double *z,
+             const dso::HarmonicCoeffs &hc, double *ax, double *ay,
+             double *az) noexcept;
+
+private:
+  /// acceleration for GravityNumLanes positions
+  void accel(const Lane &x, const Lane &y, const Lane &z,
+             const dso::HarmonicCoeffs &hc, Lane &ax, Lane &ay,
+             Lane &az) noexcept;
+  /// index of (n,m) in the V and W arrays (lower triangle, row-wise)
+  static int idx(int n, int m) noexcept { return n * (n + 1) / 2 + m; }
+
+  int m_degree, m_order;
+  std::vector<Lane, Eigen::aligned_allocator<Lane>> V, W;
+}; // GravityLanes
 } // namespace dso
 
 #endif
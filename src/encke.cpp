@@ -0,0 +1,133 @@
+#include "encke.hpp"
+#include <cassert>
+#include <cmath>
+#include <cstdio>
+
+namespace {
+/// maximum number of times the integrator is called again (to continue
+/// towards the output point) after reaching its maximum number of steps
+constexpr const int max_continuations = 20;
+} // unnamed namespace
+
+void dso::EnckeEquations(
+    double tsec, // TAI
+    // deviation from the reference orbit (+ any additional equations)
+    const Eigen::VectorXd &dy,
+    // derivative of the above
+    Eigen::Ref<Eigen::VectorXd> dyp,
+    // auxiliary parametrs
+    dso::IntegrationParameters &params) noexcept {
+
+  assert(params.encke);
+  dso::EnckeReference &ref = *params.encke;
+  assert(dy.size() == ref.y.size());
+
+  // reference (two-body) orbit at epoch
+  const Eigen::Matrix<double, 6, 1> yref = ref.state(tsec);
+
+  // full state and full equations of motion
+  ref.y = dy;
+  ref.y.head<6>() += yref;
+  ref.f(tsec, ref.y, ref.yp, params);
+
+  // deviation; velocity is exact, acceleration is the full acceleration
+  // minus the two-body acceleration of the reference orbit
+  const double rho = yref.head<3>().norm();
+  dyp = ref.yp;
+  dyp.head<3>() = dy.segment<3>(3);
+  dyp.segment<3>(3) += (ref.GM / (rho * rho * rho)) * yref.head<3>();
+
+  return;
+}
+
+dso::EnckePropagator::EnckePropagator(dso::ODEfun f, int neqn, double GM,
+                                      dso::IntegrationParameters &params,
+                                      double t0, const Eigen::VectorXd &y0,
+                                      double rerr, double aerr,
+                                      double _rect_interval,
+                                      double _rect_ratio) noexcept
+    : ref(f, neqn, GM),
+      integrator(dso::EnckeEquations, neqn, rerr, aerr, &params),
+      rect_interval(_rect_interval), rect_ratio(_rect_ratio), y(y0), dy(y0),
+      dyout(y0) {
+  params.encke = &ref;
+  rectify(t0);
+}
+
+void dso::EnckePropagator::rectify(double t) noexcept {
+  ref.rectify(t, y.head<6>());
+  // deviation is (almost) zero; keep the round-off of the state-to-elements
+  // transformation though, so that the state is preserved
+  dy = y;
+  dy.head<6>() -= ref.state(t);
+  integrator.flag() = 1;
+}
+
+int dso::EnckePropagator::set_rectification(double interval,
+                                             double ratio) noexcept {
+  if (!(interval > 0e0) || !(ratio > 0e0)) {
+    fprintf(stderr,
+            "[ERROR] Invalid rectification interval/ratio %.3e/%.3e "
+            "(traceback: %s)\n",
+            interval, ratio, __func__);
+    return 1;
+  }
+  rect_interval = interval;
+  rect_ratio = ratio;
+  return 0;
+}
+
+void dso::EnckePropagator::set_state(double t,
+                                     const Eigen::VectorXd &ynew) noexcept {
+  y = ynew;
+  rectify(t);
+}
+
+int dso::EnckePropagator::propagate(double &t, double tout) noexcept {
+  // make sure we are using our reference orbit
+  integrator.params->encke = &ref;
+
+  const double dir = (tout < t) ? -1e0 : 1e0;
+  bool done = (t == tout);
+  while (!done) {
+    // rectify if due
+    if (dir * (t - ref.t0) >= rect_interval)
+      rectify(t);
+
+    // integrate up to tout or the next (scheduled) rectification
+    double tnext = ref.t0 + dir * rect_interval;
+    const bool chunk = (dir * (tout - tnext) > 0e0);
+    if (!chunk)
+      tnext = tout;
+
+    // keep on going if the maximum number of steps is reached (flag 4, or 5
+    // if the equations appear to be stiff), but not for ever
+    int error, calls = 0;
+    do {
+      error = integrator.de(t, tnext, dy, dyout);
+    } while (error && (integrator.flag() == 4 || integrator.flag() == 5) &&
+             ++calls <= max_continuations);
+
+    if (error) {
+      fprintf(stderr,
+              "[ERROR] Failed Encke propagation to t=%.3f, flag=%d "
+              "(traceback: %s)\n",
+              tnext, integrator.flag(), __func__);
+      return 1;
+    }
+
+    // full state
+    dy = dyout;
+    const Eigen::Matrix<double, 6, 1> yref = ref.state(t);
+    y = dy;
+    y.head<6>() += yref;
+
+    // rectify if the deviation has grown too large
+    if (dy.head<3>().norm() > rect_ratio * yref.head<3>().norm())
+      rectify(t);
+
+    done = !chunk;
+  }
+
+  return 0;
+}
@@ -0,0 +1,172 @@
+#ifndef __DSO_ENCKE_ORBIT_PROPAGATION_HPP__
+#define __DSO_ENCKE_ORBIT_PROPAGATION_HPP__
+
+#include "astrodynamics.hpp"
+#include "integrators/odefun.hpp"
+#include "integrators/sgode.hpp"
+#include "orbit_integration.hpp"
+#include "eigen3/Eigen/Eigen"
+
+namespace dso {
+
+/// @brief The (two-body) reference orbit of an Encke-type propagation, see
+///        dso::EnckeEquations.
+///
+/// The reference orbit is the osculating Keplerian orbit at the epoch of the
+/// last rectification t0; it is propagated analytically (via
+/// dso::propagate_state).
+struct EnckeReference {
+  /// right-hand side of the full equations of motion (e.g.
+  /// dso::VariationalEquations)
+  ODEfun f;
+  /// gravitational parameter of the reference orbit; should match the one
+  /// of the central term of the force model (e.g. harmonics.GM())
+  double GM;
+  /// epoch of (last) rectification [sec]
+  double t0;
+  /// osculating elements at t0
+  dso::OrbitalElements elements;
+  /// work space: full state and its derivative
+  Eigen::VectorXd y, yp;
+  /// number of rectifications so far
+  long nrect{0};
+
+  /// @brief Constructor
+  /// @param[in] _f Right-hand side of the full equations of motion
+  /// @param[in] neqn Number of equations (of the full equations of motion)
+  /// @param[in] _GM Gravitational parameter for the reference orbit
+  EnckeReference(ODEfun _f, int neqn, double _GM) noexcept
+      : f(_f), GM(_GM), t0(0e0), y(neqn), yp(neqn) {}
+
+  /// @brief (Re-) set the reference orbit to the osculating orbit at t
+  void rectify(double t, const Eigen::Matrix<double, 6, 1> &state) noexcept {
+    t0 = t;
+    elements = dso::state2elements(GM, state);
+    ++nrect;
+  }
+
+  /// @brief State of the reference orbit at t
+  Eigen::Matrix<double, 6, 1> state(double t) const noexcept {
+    return dso::propagate_state(GM, elements, t - t0);
+  }
+}; // EnckeReference
+
+/// @brief Encke formulation of the equations of motion; integrates the
+///        deviation of the state from a (two-body) reference orbit, aka
+///        δ = y - y_ref(t).
+///
+/// The vector dy has the same layout as the state of the full equations of
+/// motion (i.e. params.encke->f); the first six elements hold the deviation
+/// δ, while any remaining elements (e.g. the state transition matrix of
+/// dso::VariationalEquations) are integrated as they are. The full force
+/// model is evaluated at y_ref(t) + δ and the two-body acceleration at
+/// y_ref(t) is subtracted.
+/// The reference orbit used is the one pointed to by params.encke (must not
+/// be nullptr).
+void EnckeEquations(double tsec, const Eigen::VectorXd &dy,
+                    Eigen::Ref<Eigen::VectorXd> dyp,
+                    dso::IntegrationParameters &params) noexcept;
+
+/// @brief Encke-type propagation, i.e. integration of the deviation from a
+///        periodically rectified two-body reference orbit (see
+///        dso::EnckeEquations).
+///
+/// The reference orbit is rectified (and the integrator restarted) every
+/// rect_interval seconds, or whenever the position deviation exceeds
+/// rect_ratio times the reference orbit radius, whichever comes first.
+/// Since the deviation is small, the error tolerances effectively apply in
+/// an absolute sense (e.g. aerr in [m] for the position).
+///
+/// Use this only for near-Keplerian arcs, i.e. when the perturbations are
+/// small compared to the central term (e.g. high altitude orbits, or short
+/// arcs). Each rectification restarts the (multistep) integrator, i.e. it
+/// costs a (low order, small step) start-up phase; if the deviation grows
+/// fast (e.g. low orbits with strong drag or a large J2 effect over long
+/// arcs), rectifications become frequent and a plain (Cowell) propagation
+/// of the full equations of motion is cheaper. Both thresholds (interval
+/// and ratio) can be tuned, see set_rectification.
+///
+/// Example:
+///   dso::EnckePropagator encke(dso::VariationalEquations, 6+6*(6+Np),
+///                              harmonics.GM(), params, 0e0, y0, 1e-12, 1e-4);
+///   double t = 0e0;
+///   if (encke.propagate(t, 60e0)) { ... error ... }
+///   const Eigen::VectorXd &y = encke.state();
+/// Note that times are given in seconds since params.mjd_tai (as in
+/// dso::VariationalEquations).
+class EnckePropagator {
+public:
+  /// @brief Constructor
+  /// @param[in] f Right-hand side of the full equations of motion (e.g.
+  ///            dso::VariationalEquations)
+  /// @param[in] neqn Number of equations
+  /// @param[in] GM Gravitational parameter of the reference orbit
+  /// @param[in] params Integration parameters; the instance's encke pointer
+  ///            is set to the propagator's reference orbit
+  /// @param[in] t0 Initial epoch [sec]
+  /// @param[in] y0 Initial (full) state, of size neqn
+  /// @param[in] rerr Relative error tolerance
+  /// @param[in] aerr Absolute error tolerance
+  /// @param[in] rect_interval Maximum interval between rectifications [sec]
+  /// @param[in] rect_ratio Maximum ratio of position deviation over radius
+  ///            before rectification
+  EnckePropagator(ODEfun f, int neqn, double GM,
+                  dso::IntegrationParameters &params, double t0,
+                  const Eigen::VectorXd &y0, double rerr, double aerr,
+                  double rect_interval = 21600e0,
+                  double rect_ratio = 1e-2) noexcept;
+
+  /// @brief Destructor; resets the encke pointer of the integration
+  ///        parameters (if pointing to this instance's reference orbit)
+  ~EnckePropagator() noexcept {
+    if (integrator.params && integrator.params->encke == &ref)
+      integrator.params->encke = nullptr;
+  }
+
+  EnckePropagator(const EnckePropagator &) = delete;
+  EnckePropagator &operator=(const EnckePropagator &) = delete;
+
+  /// @brief Current (full) state
+  const Eigen::VectorXd &state() const noexcept { return y; }
+
+  /// @brief Replace the current state (e.g. after a measurement update); the
+  ///        reference orbit is rectified and the integrator restarted
+  void set_state(double t, const Eigen::VectorXd &ynew) noexcept;
+
+  /// @brief Change the rectification thresholds (applied from the next
+  ///        call to propagate on).
+  /// @param[in] interval Maximum interval between rectifications [sec]
+  /// @param[in] ratio Maximum ratio of position deviation over radius
+  ///            before rectification
+  /// @return Anything other than 0 denotes an error (non-positive values)
+  int set_rectification(double interval, double ratio) noexcept;
+
+  /// @brief Maximum interval between rectifications [sec]
+  double rectification_interval() const noexcept { return rect_interval; }
+
+  /// @brief Maximum ratio of position deviation over radius
+  double rectification_ratio() const noexcept { return rect_ratio; }
+
+  /// @brief Propagate from t to tout [sec].
+  /// @return Anything other than 0 denotes an error (including too many
+  ///         steps, i.e. more than a few thousand, needed to reach the
+  ///         next rectification or tout)
+  int propagate(double &t, double tout) noexcept;
+
+  /// @brief Number of rectifications so far
+  long num_rectifications() const noexcept { return ref.nrect; }
+
+private:
+  /// rectify reference orbit at t (using the current state y)
+  void rectify(double t) noexcept;
+
+  dso::EnckeReference ref;
+  dso::SGOde integrator;
+  double rect_interval, rect_ratio;
+  /// full state and deviation (from the reference orbit)
+  Eigen::VectorXd y, dy, dyout;
+}; // EnckePropagator
+
+} // namespace dso
+
+#endif
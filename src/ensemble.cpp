@@ -0,0 +1,191 @@
+#include "ensemble.hpp"
+#include "iers2010/iersc.hpp"
+#include "astrodynamics.hpp"
+#include "geodesy/geodesy.hpp"
+#include "geodesy/units.hpp"
+#include <cmath>
+#include <cstdio>
+
+namespace {
+using SoAMatrix = Eigen::Matrix<double, Eigen::Dynamic, 3>;
+
+/// maximum number of times the integrator is called again (to continue
+/// towards the output point) after reaching its maximum number of steps
+constexpr const int max_continuations = 20;
+
+/// Point mass (third body) acceleration for all members, accumulated in acc;
+/// same as dso::point_mass_accel
+void third_body_accel(double GM, const Eigen::Matrix<double, 3, 1> &robj,
+                      const Eigen::Ref<const SoAMatrix> &r,
+                      Eigen::Ref<SoAMatrix> acc) noexcept {
+  // indirect part, same for all members
+  const Eigen::Matrix<double, 1, 3> indirect =
+      robj.transpose() / std::pow(robj.norm(), 3);
+  for (int k = 0; k < r.rows(); k++) {
+    // relative position vector of satellite w.r.t. point mass
+    const Eigen::Matrix<double, 1, 3> d = r.row(k) - robj.transpose();
+    const double dn = d.norm();
+    acc.row(k) -= GM * (d / (dn * dn * dn) + indirect);
+  }
+}
+} // unnamed namespace
+
+void dso::ensemble_pack(const std::vector<Eigen::Matrix<double, 6, 1>> &states,
+                        Eigen::VectorXd &y) noexcept {
+  const int K = states.size();
+  y.resize(6 * K);
+  for (int k = 0; k < K; k++)
+    for (int i = 0; i < 6; i++)
+      y(i * K + k) = states[k](i);
+}
+
+Eigen::Matrix<double, 6, 1> dso::ensemble_member(const Eigen::VectorXd &y,
+                                                 int k) noexcept {
+  const int K = y.size() / 6;
+  Eigen::Matrix<double, 6, 1> state;
+  for (int i = 0; i < 6; i++)
+    state(i) = y(i * K + k);
+  return state;
+}
+
+void dso::EnsembleEquations(
+    double tsec, // TAI
+    // states (inertial RF), SoA layout, size 6*K
+    const Eigen::VectorXd &y,
+    // state derivatives (inertial RF), SoA layout, size 6*K
+    Eigen::Ref<Eigen::VectorXd> yp,
+    // auxiliary parametrs
+    dso::IntegrationParameters &params) noexcept {
+
+  assert(params.ensemble);
+  dso::EnsembleWorkspace &ws = *params.ensemble;
+  const int K = ws.K;
+  assert(y.size() == 6 * K);
+  ++ws.nfev;
+
+  // no copies here; map positions/velocities and their derivatives
+  const Eigen::Map<const SoAMatrix> r(y.data(), K, 3);
+  const Eigen::Map<const SoAMatrix> v(y.data() + 3 * K, K, 3);
+  Eigen::Map<SoAMatrix> rp(yp.data(), K, 3);
+  Eigen::Map<SoAMatrix> vp(yp.data() + 3 * K, K, 3);
+
+  // current mjd, TAI
+  const double cmjd = params.mjd_tai + tsec / dso::sec_per_day;
+
+  // time-only quantities of the force model, once for all members (cached,
+  // see dso::update_time_cache)
+  const dso::ForceModelTimeCache &tc = dso::update_time_cache(cmjd, params);
+
+  // celestial to terrestrial matrix for epoch
+  const Eigen::Matrix<double, 3, 3> c2t =
+      tc.rpom *
+      (Eigen::AngleAxisd(tc.era_at(cmjd), -Eigen::Vector3d::UnitZ()) * tc.rc2i);
+
+  // positions to ITRS; the rows of r are the members, hence r * c2t^T
+  ws.rgeo.noalias() = r * c2t.transpose();
+
+  // gravity-induced acceleration, batched (Earth-fixed RF)
+  ws.gravity.accel(K, ws.rgeo.col(0).data(), ws.rgeo.col(1).data(),
+                   ws.rgeo.col(2).data(), params.harmonics,
+                   ws.gacc.col(0).data(), ws.gacc.col(1).data(),
+                   ws.gacc.col(2).data());
+
+  // back to the inertial RF
+  vp.noalias() = ws.gacc * c2t;
+
+  // velocities
+  rp = v;
+
+  // third body perturbations, Sun and Moon [m/sec^2] in celestial RF; note
+  // that GM's are given in [km^3/sec^2] (see dso::SunMoon)
+  third_body_accel(params.GMSun * 1e9, tc.rsun, r, vp);
+  third_body_accel(params.GMMon * 1e9, tc.rmon, r, vp);
+
+  // Drag
+  // Warning only valid for Jason-3
+  // no atmosphere model (or data) attached; no drag
+  if (!params.AtmDataFeed || !params.nrlmsise00)
+    return;
+  // the quaternion (once for all members); date and space weather of the
+  // atmospheric model are set by dso::update_time_cache
+  if (tc.qerror) {
+    fprintf(stderr, "ERROR Failed to find quaternion for datetime\n");
+    assert(false);
+    return;
+  }
+
+  // plate normals in the inertial RF
+  const Eigen::Quaternion<double> qi = tc.q.conjugate().normalized();
+
+  constexpr const double omegav[] = {0e0, 0e0, iers2010::OmegaEarth};
+  const Eigen::Matrix<double, 3, 1> omega{omegav};
+  const double CdOverM = *(params.drag_coef) / *(params.SatMass);
+  dso::nrlmsise00::OutParams aout;
+  for (int k = 0; k < K; k++) {
+    const Eigen::Matrix<double, 3, 1> rk = r.row(k).transpose();
+    // Velocity relative to the Earth's atmosphere
+    const Eigen::Matrix<double, 3, 1> vrel =
+        v.row(k).transpose() - omega.cross(rk);
+    const Eigen::Matrix<double, 3, 1> vr = vrel.normalized();
+    // cross-section area; loop over flat plates of satellite
+    double ProjArea = 0e0;
+    for (int i = 0; i < params.numMacroModelComponents; i++) {
+      const Eigen::Matrix<double, 3, 1> nb(params.macromodel[i].m_normal);
+      const double ctheta = (qi * nb).dot(vr);
+      if (ctheta > 0e0)
+        ProjArea += params.macromodel[i].m_surf * ctheta;
+    }
+    // atmospheric density (at the member's Earth-fixed position)
+    params.AtmDataFeed->set_spatial_from_cartesian(ws.rgeo.row(k).transpose());
+    assert(!params.nrlmsise00->gtd7d(&(params.AtmDataFeed->params_), &aout));
+    const double atmdens = aout.d[5];
+    // same as dso::drag_accel
+    vp.row(k) -=
+        (0.5e0 * CdOverM * ProjArea * atmdens * vrel.norm()) * vrel.transpose();
+  }
+
+  return;
+}
+
+dso::EnsemblePropagator::EnsemblePropagator(
+    dso::IntegrationParameters &params,
+    const std::vector<Eigen::Matrix<double, 6, 1>> &states, double rerr,
+    double aerr) noexcept
+    : ws(states.size(), params.degree, params.order),
+      integrator(dso::EnsembleEquations, 6 * states.size(), rerr, aerr,
+                 &params) {
+  params.ensemble = &ws;
+  dso::ensemble_pack(states, y);
+  yout = y;
+}
+
+void dso::EnsemblePropagator::set_member(
+    int k, const Eigen::Matrix<double, 6, 1> &state) noexcept {
+  for (int i = 0; i < 6; i++)
+    y(i * ws.K + k) = state(i);
+  integrator.flag() = 1;
+}
+
+int dso::EnsemblePropagator::propagate(double &t, double tout) noexcept {
+  // make sure we are using our work space
+  integrator.params->ensemble = &ws;
+
+  // keep on going if the maximum number of steps is reached (flag 4, or 5
+  // if the equations appear to be stiff), but not for ever
+  int error, calls = 0;
+  do {
+    error = integrator.de(t, tout, y, yout);
+  } while (error && (integrator.flag() == 4 || integrator.flag() == 5) &&
+           ++calls <= max_continuations);
+
+  if (error) {
+    fprintf(stderr,
+            "[ERROR] Failed propagating ensemble to t=%.3f, flag=%d "
+            "(traceback: %s)\n",
+            tout, integrator.flag(), __func__);
+    return 1;
+  }
+
+  y = yout;
+  return 0;
+}
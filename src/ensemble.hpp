@@ -0,0 +1,127 @@
+#ifndef __DSO_ENSEMBLE_ORBIT_PROPAGATION_HPP__
+#define __DSO_ENSEMBLE_ORBIT_PROPAGATION_HPP__
+
+#include "egravity.hpp"
+#include "integrators/sgode.hpp"
+#include "orbit_integration.hpp"
+#include "eigen3/Eigen/Eigen"
+#include <vector>
+
+namespace dso {
+
+/// @brief Work space for dso::EnsembleEquations, i.e. the evaluation of the
+///        force model for K states (the members of an ensemble) at once.
+///
+/// All arrays follow a Structure-of-Arrays (SoA) layout, aka a (K x 3)
+/// column-major matrix holds the x components of all members, followed by
+/// the y and then the z components.
+struct EnsembleWorkspace {
+  /// number of members
+  int K;
+  /// batched (SIMD lanes) geopotential
+  dso::GravityLanes gravity;
+  /// positions and accelerations in the Earth-fixed frame (K x 3)
+  Eigen::Matrix<double, Eigen::Dynamic, 3> rgeo, gacc;
+  /// number of calls to dso::EnsembleEquations
+  long nfev{0};
+
+  /// @brief Constructor
+  /// @param[in] num_members Number of members (K)
+  /// @param[in] degree Degree of the geopotential expansion
+  /// @param[in] order Order of the geopotential expansion
+  EnsembleWorkspace(int num_members, int degree, int order) noexcept
+      : K(num_members), gravity(degree, order), rgeo(num_members, 3),
+        gacc(num_members, 3) {}
+}; // EnsembleWorkspace
+
+/// @brief Equations of motion (state only, no variational equations) for
+///        K states at once.
+///
+/// This uses the same force model as dso::VariationalEquations
+/// (geopotential, Sun/Moon and, if an atmosphere model is attached,
+/// atmospheric drag), but all time-only
+/// quantities, aka the celestial-to-terrestrial matrix (EOP), the positions
+/// of Sun and Moon, the satellite attitude and the space-weather input of
+/// the atmospheric model, are computed once per call and shared among the
+/// members. The geopotential is evaluated via dso::GravityLanes and the
+/// third-body and drag terms are computed on the SoA arrays.
+///
+/// The state vector (of size 6*K) is in SoA layout, aka
+/// [x(K), y(K), z(K), vx(K), vy(K), vz(K)] (see dso::ensemble_pack), so
+/// that this can be used as the right-hand side of any of the integrators
+/// (e.g. dso::SGOde). Note that the step size is then common for all
+/// members.
+/// The work space used is the one pointed to by params.ensemble (must not be
+/// nullptr).
+void EnsembleEquations(double tsec, const Eigen::VectorXd &y,
+                       Eigen::Ref<Eigen::VectorXd> yp,
+                       dso::IntegrationParameters &params) noexcept;
+
+/// @brief Pack K states to an (SoA) ensemble state vector
+void ensemble_pack(const std::vector<Eigen::Matrix<double, 6, 1>> &states,
+                   Eigen::VectorXd &y) noexcept;
+
+/// @brief Extract the state of member k from an (SoA) ensemble state vector
+Eigen::Matrix<double, 6, 1> ensemble_member(const Eigen::VectorXd &y,
+                                            int k) noexcept;
+
+/// @brief Propagate K states over the same interval(s), with a shared step
+///        size, using dso::EnsembleEquations.
+///
+/// Example:
+///   dso::EnsemblePropagator ens(params, sigma_points, 1e-10, 1e-8);
+///   double t = 0e0;
+///   if (ens.propagate(t, 60e0)) { ... error ... }
+///   const auto y5 = ens.member(5);
+/// Note that times are given in seconds since params.mjd_tai (as in
+/// dso::VariationalEquations).
+class EnsemblePropagator {
+public:
+  /// @brief Constructor
+  /// @param[in] params Integration parameters; the instance's ensemble
+  ///            pointer is set to the propagator's work space
+  /// @param[in] states Initial states of the members (inertial frame)
+  /// @param[in] rerr Relative error tolerance
+  /// @param[in] aerr Absolute error tolerance
+  EnsemblePropagator(dso::IntegrationParameters &params,
+                     const std::vector<Eigen::Matrix<double, 6, 1>> &states,
+                     double rerr, double aerr) noexcept;
+
+  /// @brief Destructor; resets the ensemble pointer of the integration
+  ///        parameters (if pointing to this instance's work space)
+  ~EnsemblePropagator() noexcept {
+    if (integrator.params && integrator.params->ensemble == &ws)
+      integrator.params->ensemble = nullptr;
+  }
+
+  EnsemblePropagator(const EnsemblePropagator &) = delete;
+  EnsemblePropagator &operator=(const EnsemblePropagator &) = delete;
+
+  int num_members() const noexcept { return ws.K; }
+
+  /// @brief Current state of member k
+  Eigen::Matrix<double, 6, 1> member(int k) const noexcept {
+    return ensemble_member(y, k);
+  }
+
+  /// @brief Replace the state of member k; the integrator is restarted at
+  ///        the next call to propagate
+  void set_member(int k, const Eigen::Matrix<double, 6, 1> &state) noexcept;
+
+  /// @brief Propagate all members from t to tout [sec].
+  /// @return Anything other than 0 denotes an error (including too many
+  ///         steps, i.e. more than a few thousand, needed to reach tout)
+  int propagate(double &t, double tout) noexcept;
+
+  /// @brief Number of force model (ensemble) evaluations so far
+  long num_fevals() const noexcept { return ws.nfev; }
+
+private:
+  dso::EnsembleWorkspace ws;
+  dso::SGOde integrator;
+  Eigen::VectorXd y, yout;
+}; // EnsemblePropagator
+
+} // namespace dso
+
+#endif
@@ -2,7 +2,10 @@
 #define __DSO__IERS_BULLTEIN_PARSERS_HPP__
 
 #include "datetime/dtcalendar.hpp"
+#include <algorithm>
+#include <cassert>
 #include <cstring>
+#include <memory>
 
 namespace dso {
 
@@ -17,23 +20,60 @@ struct EopRecord {
 ///        been constructed by a call to dso::parse_iers_C04) the mjd array is
 ///        in TT (whereas the IERS-distributed C04 files contain date
 ///        information in UTC).
+///        Copies are cheap: they share the (reference-counted) memmory pool,
+///        which is treated as immutable and only duplicated when a copy is
+///        modified (copy-on-write); use deep_copy for an independent copy.
+///        Note that pointers obtained via the non-const accessors should not
+///        be kept (and written through) after the instance is copied.
 class EopLookUpTable {
 private:
   ///< Actual size of arrays aka number of epochs
   int sz{0};
   ///< Capacity of memmory, not the same as the actual number of epochs stored!
   int capacity{0};
-  ///< Memmory pool
-  double *mem_arena{nullptr};
-  ///< arrays of EOP values extracted from C04
-  double *mjda{nullptr}, ///< [TT], start index = 0
-      *xpa{nullptr},     ///< [", arcsec], start index = 1
-      *ypa{nullptr},     ///< [", arcsec], start index = 2
-      *ut1a{nullptr},    ///< [sec], start index = 3
-      *dxa{nullptr},     ///< [", arcsec], start index = 4
-      *dya{nullptr},     ///< [", arcsec], start index = 5
-      *loda{nullptr},    ///< [sec/day], start index = 6
-      *omegaa{nullptr};  ///< [?], start index = 7
+  ///< Memmory pool, holding the arrays of EOP values extracted from C04 (each
+  ///< of size capacity), in the order:
+  ///<  mjd   [TT],          start index = 0
+  ///<  xp    [", arcsec],   start index = 1
+  ///<  yp    [", arcsec],   start index = 2
+  ///<  ut1   [sec],         start index = 3
+  ///<  dx    [", arcsec],   start index = 4
+  ///<  dy    [", arcsec],   start index = 5
+  ///<  lod   [sec/day],     start index = 6
+  ///<  omega [?],           start index = 7
+  ///< The pool is shared between copies (reference counted); it is only
+  ///< duplicated before modification (copy-on-write, see detach).
+  std::shared_ptr<double[]> mem_arena;
+
+  /// @brief Start of the k-th array (see mem_arena); for reading
+  const double *array(int k) const noexcept {
+    return mem_arena.get() + k * capacity;
+  }
+  /// @brief Start of the k-th array (see mem_arena); for writing, hence
+  ///        the pool is detached first (if shared)
+  double *array(int k) noexcept {
+    detach();
+    return mem_arena.get() + k * capacity;
+  }
+
+  /// @brief Make sure this instance is the only owner of its memmory pool,
+  ///        copying its contents (sz epochs) if needed
+  void detach() noexcept {
+    if (mem_arena && mem_arena.use_count() > 1)
+      reallocate(capacity);
+  }
+
+  /// @brief (Re-)allocate the memmory pool with the given capacity (>= sz),
+  ///        preserving the contents (sz epochs)
+  void reallocate(int new_capacity) noexcept {
+    std::shared_ptr<double[]> arena(new double[new_capacity * 8]);
+    if (mem_arena)
+      for (int k = 0; k < 8; k++)
+        std::memcpy(arena.get() + k * new_capacity,
+                    mem_arena.get() + k * capacity, sz * sizeof(double));
+    mem_arena = std::move(arena);
+    capacity = new_capacity;
+  }
 
 public:
   int size() const noexcept { return sz; }
@@ -42,214 +82,166 @@ public:
 #ifdef DEBUG
     assert(i >= 0 && i < sz);
 #endif
-    return mjda + i;
+    return array(0) + i;
   }
   double *xp(int i = 0) noexcept {
 #ifdef DEBUG
     assert(i >= 0 && i < sz);
 #endif
-    return xpa + i;
+    return array(1) + i;
   }
   double *yp(int i = 0) noexcept {
 #ifdef DEBUG
     assert(i >= 0 && i < sz);
 #endif
-    return ypa + i;
+    return array(2) + i;
   }
   double *dut(int i = 0) noexcept {
 #ifdef DEBUG
     assert(i >= 0 && i < sz);
 #endif
-    return ut1a + i;
+    return array(3) + i;
   }
   double *dx(int i = 0) noexcept {
 #ifdef DEBUG
     assert(i >= 0 && i < sz);
 #endif
-    return dxa + i;
+    return array(4) + i;
   }
   double *dy(int i = 0) noexcept {
 #ifdef DEBUG
     assert(i >= 0 && i < sz);
 #endif
-    return dya + i;
+    return array(5) + i;
   }
   double *lod(int i = 0) noexcept {
 #ifdef DEBUG
     assert(i >= 0 && i < sz);
 #endif
-    return loda + i;
+    return array(6) + i;
   }
   double *omega(int i = 0) noexcept {
 #ifdef DEBUG
     assert(i >= 0 && i < sz);
 #endif
-    return omegaa + i;
+    return array(7) + i;
   }
   const double *mjd(int i = 0) const noexcept {
 #ifdef DEBUG
     assert(i >= 0 && i < sz);
 #endif
-    return mjda + i;
+    return array(0) + i;
   }
   const double *xp(int i = 0) const noexcept {
 #ifdef DEBUG
     assert(i >= 0 && i < sz);
 #endif
-    return xpa + i;
+    return array(1) + i;
   }
   const double *yp(int i = 0) const noexcept {
 #ifdef DEBUG
     assert(i >= 0 && i < sz);
 #endif
-    return ypa + i;
+    return array(2) + i;
   }
   const double *dut(int i = 0) const noexcept {
 #ifdef DEBUG
     assert(i >= 0 && i < sz);
 #endif
-    return ut1a + i;
+    return array(3) + i;
   }
   const double *dx(int i = 0) const noexcept {
 #ifdef DEBUG
     assert(i >= 0 && i < sz);
 #endif
-    return dxa + i;
+    return array(4) + i;
   }
   const double *dy(int i = 0) const noexcept {
 #ifdef DEBUG
     assert(i >= 0 && i < sz);
 #endif
-    return dya + i;
+    return array(5) + i;
   }
   const double *lod(int i = 0) const noexcept {
 #ifdef DEBUG
     assert(i >= 0 && i < sz);
 #endif
-    return loda + i;
+    return array(6) + i;
   }
   const double *omega(int i = 0) const noexcept {
 #ifdef DEBUG
     assert(i >= 0 && i < sz);
 #endif
-    return omegaa + i;
+    return array(7) + i;
   }
 
   /// @brief Default constructor (uses a capacity of 10 elements)
   EopLookUpTable(int _capacity = 10) noexcept
       : sz{_capacity}, capacity{_capacity},
-        mem_arena(new double[_capacity * 8]), mjda(mem_arena),
-        xpa(mem_arena + _capacity), ypa(mem_arena + 2 * _capacity),
-        ut1a(mem_arena + 3 * _capacity), dxa(mem_arena + 4 * _capacity),
-        dya(mem_arena + 5 * _capacity), loda(mem_arena + 6 * _capacity),
-        omegaa(mem_arena + 7 * _capacity) {}
+        mem_arena(new double[_capacity * 8]) {}
 
-  /// @brief Resize; alocation/dealocation depends on capacity
+  /// @brief Resize; alocation/dealocation depends on capacity. Values of
+  ///        (up to sz_) epochs already in the table are preserved.
   void resize(int sz_) noexcept {
-    // no need to dealocate/alocate; just change the effective size
-    if (sz_ < capacity) {
-      sz = sz_;
-      return;
-    } else {
+    sz = std::min(sz, sz_);
+    if (sz_ > capacity) {
       // requested size (sz_) > current capacity. need to allocate memory!
-      delete[] mem_arena;
-      sz = sz_;
-      capacity = sz_;
-      mem_arena = new double[capacity * 8];
-      mjda = mem_arena;
-      xpa = mem_arena + capacity;
-      ypa = mem_arena + 2 * capacity;
-      ut1a = mem_arena + 3 * capacity;
-      dxa = mem_arena + 4 * capacity;
-      dya = mem_arena + 5 * capacity;
-      loda = mem_arena + 6 * capacity;
-      omegaa = mem_arena + 7 * capacity;
+      reallocate(sz_);
+    } else {
+      // no need to alocate; just change the effective size (a shared pool
+      // is detached first though)
+      detach();
     }
+    sz = sz_;
   }
 
-  /// @brief destructor
-  ~EopLookUpTable() noexcept {
-    if (mem_arena)
-      delete[] mem_arena;
-    sz = capacity = 0;
-  }
+  /// @brief Copy constructor; cheap, the copy shares the (immutable)
+  ///        memmory pool with eopt until either instance is modified (via
+  ///        any of the non-const member functions). Shared instances can
+  ///        be used concurrently (e.g. for interpolation) by any number of
+  ///        threads; note however that (the reference count of) a single
+  ///        instance should not be copied while another thread modifies it.
+  EopLookUpTable(const EopLookUpTable &eopt) noexcept = default;
 
-  /// @brief Move constructor
+  /// @brief Assignment operator; shares the memmory pool (see copy
+  ///        constructor)
+  EopLookUpTable &operator=(const EopLookUpTable &eopt) noexcept = default;
+
+  /// @brief Move constructor; the moved-from instance is left empty
   EopLookUpTable(EopLookUpTable &&eopt) noexcept
-      : sz{eopt.sz}, capacity{eopt.sz}, mem_arena{eopt.mem_arena},
-        mjda{eopt.mjda}, xpa{eopt.xpa}, ypa{eopt.ypa}, ut1a{eopt.ut1a},
-        dxa{eopt.dxa}, dya{eopt.dya}, loda{eopt.loda}, omegaa{eopt.omegaa} {
+      : sz{eopt.sz}, capacity{eopt.capacity},
+        mem_arena{std::move(eopt.mem_arena)} {
     eopt.sz = eopt.capacity = 0;
-    eopt.mem_arena = nullptr;
   }
 
-  /// @brief Assignment operator
-  EopLookUpTable &operator=(const EopLookUpTable &eopt) noexcept {
-    if (this != &eopt) {
-      if (sz != eopt.sz) {
-        this->resize(eopt.sz);
-      }
-      mjda = (double *)std::memcpy(mem_arena, eopt.mem_arena, sz);
-      xpa = (double *)std::memcpy(mem_arena + 1 * capacity,
-                                  eopt.mem_arena + 1 * eopt.capacity, sz);
-      ypa = (double *)std::memcpy(mem_arena + 2 * capacity,
-                                  eopt.mem_arena + 2 * eopt.capacity, sz);
-      ut1a = (double *)std::memcpy(mem_arena + 3 * capacity,
-                                   eopt.mem_arena + 3 * eopt.capacity, sz);
-      dxa = (double *)std::memcpy(mem_arena + 4 * capacity,
-                                  eopt.mem_arena + 4 * eopt.capacity, sz);
-      dya = (double *)std::memcpy(mem_arena + 5 * capacity,
-                                  eopt.mem_arena + 5 * eopt.capacity, sz);
-      loda = (double *)std::memcpy(mem_arena + 6 * capacity,
-                                   eopt.mem_arena + 6 * eopt.capacity, sz);
-      omegaa = (double *)std::memcpy(mem_arena + 7 * capacity,
-                                     eopt.mem_arena + 7 * eopt.capacity, sz);
-    }
-    return *this;
-  }
-
-  /// @brief Move assignment operator
+  /// @brief Move assignment operator; the moved-from instance is left empty
   EopLookUpTable &operator=(EopLookUpTable &&eopt) noexcept {
     if (this != &eopt) {
-      // just move elements ...
       sz = eopt.sz;
-      capacity = eopt.sz;
-      mem_arena = eopt.mem_arena;
-      mjda = eopt.mjda;
-      xpa = eopt.xpa;
-      ypa = eopt.ypa;
-      ut1a = eopt.ut1a;
-      dxa = eopt.dxa;
-      dya = eopt.dya;
-      loda = eopt.loda;
-      omegaa = eopt.omegaa;
-      // leave move-from instance blank
-      eopt.sz = 0;
-      eopt.capacity = 0;
-      eopt.mem_arena = nullptr;
+      capacity = eopt.capacity;
+      mem_arena = std::move(eopt.mem_arena);
+      eopt.sz = eopt.capacity = 0;
     }
     return *this;
   }
 
-  /// @brief Copy constructor. The created copy will have a capacity and size
-  ///        (both) equal to eopt's size.
-  EopLookUpTable(const EopLookUpTable &eopt) noexcept
-      : sz{eopt.sz}, capacity{eopt.sz}, mem_arena(new double[capacity * 8]),
-        mjda((double *)std::memcpy(mem_arena, eopt.mem_arena, sz)),
-        xpa((double *)std::memcpy(mem_arena + 1 * capacity,
-                                  eopt.mem_arena + 1 * eopt.capacity, sz)),
-        ypa((double *)std::memcpy(mem_arena + 2 * capacity,
-                                  eopt.mem_arena + 2 * eopt.capacity, sz)),
-        ut1a((double *)std::memcpy(mem_arena + 3 * capacity,
-                                   eopt.mem_arena + 3 * eopt.capacity, sz)),
-        dxa((double *)std::memcpy(mem_arena + 4 * capacity,
-                                  eopt.mem_arena + 4 * eopt.capacity, sz)),
-        dya((double *)std::memcpy(mem_arena + 5 * capacity,
-                                  eopt.mem_arena + 5 * eopt.capacity, sz)),
-        loda((double *)std::memcpy(mem_arena + 6 * capacity,
-                                   eopt.mem_arena + 6 * eopt.capacity, sz)),
-        omegaa((double *)std::memcpy(mem_arena + 7 * capacity,
-                                     eopt.mem_arena + 7 * eopt.capacity, sz)) {}
+  /// @brief Destructor
+  ~EopLookUpTable() noexcept = default;
+
+  /// @brief An independent (deep) copy, with a capacity equal to the size
+  ///        of the instance.
+  EopLookUpTable deep_copy() const noexcept {
+    EopLookUpTable copy(sz);
+    for (int k = 0; k < 8; k++)
+      std::memcpy(copy.mem_arena.get() + k * sz, array(k),
+                  sz * sizeof(double));
+    return copy;
+  }
+
+  /// @brief Check if the instance shares its memmory pool with eopt
+  bool shares_storage(const EopLookUpTable &eopt) const noexcept {
+    return mem_arena && mem_arena == eopt.mem_arena;
+  }
 
   /// @brief Compute the effect of zonal Earth tides on the rotation of the
   ///        Earth (using iers2010::rg_zont2 on UT1-UTC, LOD and
@@ -276,10 +268,7 @@ public:
   /// interpolation
   ///        of given order
   /// @param fmjd_tt Point to interpolate at [MJD] TT
-  /// @param eopr Interpolation results stored in an EopRecord instance;
-  /// note
-  ///             that omega (Earth rotation rate) values are NOT
-  ///             used/interpolated
+  /// @param eopr Interpolation results stored in an EopRecord instance
   /// @param order Order of the Lagrangian interpolation (that is the
   /// window, aka
   ///             used points is order+1). This parameter should be an odd
@@ -287,8 +276,115 @@ public:
   /// @return Anything other than 0 denotes an error
   int interpolate_lagrange(double fmjd_tt, EopRecord &eopr,
                            int order = 5) const noexcept;
+
+  /// @brief Batch version of interpolate, for n epochs.
+  ///
+  /// Epochs should (preferably) be in chronological order; the window of
+  /// each epoch is then found without searching the table.
+  /// @param[in] fmjd_tt Array of n interpolation epochs, mjd [TT]
+  /// @param[in] n Number of epochs
+  /// @param[out] eopr Array of (at least) n EopRecord instances
+  /// @return Anything other than 0 denotes an error
+  int interpolate(const double *fmjd_tt, int n, EopRecord *eopr,
+                  int order = 5) const noexcept;
+
+  /// @brief Batch version of interpolate_lagrange, for n epochs (see the
+  ///        batch version of interpolate)
+  int interpolate_lagrange(const double *fmjd_tt, int n, EopRecord *eopr,
+                           int order = 5) const noexcept;
+
+private:
+  /// Maximum number of points (aka order+1) for Lagrangian interpolation
+  static constexpr const int max_lagrange_points = 16;
+
+  /// @brief Locate the interpolation window (order+1 points, around the
+  ///        epoch) and compute the Lagrange weights, once for all series.
+  /// @param[in] fmjd_tt Interpolation epoch, mjd [TT]
+  /// @param[in] order Order of interpolation
+  /// @param[in,out] first On input, the index of the first point of a
+  ///            previous window (used as search hint; any value is fine), on
+  ///            output the index of the first point of the window
+  /// @param[out] w Lagrange weights, of size order+1
+  /// @return Anything other than 0 denotes an error (e.g. epoch out of range)
+  int lagrange_weights(double fmjd_tt, int order, int &first,
+                       double *w) const noexcept;
+
+  /// @brief Apply the weights to all (xp, yp, dut, dx, dy, lod, omega)
+  ///        series of the window starting at first
+  void lagrange_apply(int first, int np, const double *w,
+                      EopRecord &eopr) const noexcept;
+
+  /// @brief Add the effects of zonal tides, ocean tides and libration to
+  ///        (Lagrange-) interpolated values (see interpolate)
+  void correct(double fmjd_tt, EopRecord &eopr) const noexcept;
 }; // EopLookUpTable
 
+/// @brief A high-rate table of (fully corrected) EOP values over an arc, to
+///        avoid the evaluation of the sub-daily correction series (zonal
+///        tides, ocean tides and libration, see
+///        EopLookUpTable::interpolate) at every epoch.
+///
+/// The table is built off of EopLookUpTable::interpolate at a fixed cadence
+/// (default 10 min); values in between are computed via (low order)
+/// Lagrangian interpolation on the uniform grid. For the shortest periods
+/// of the corrections (semi-diurnal, amplitudes < 1 mas in polar motion and
+/// < 0.1 ms in UT1), cubic interpolation at 10 min yields errors of ~1e-6
+/// of the amplitude.
+///
+/// Example:
+///   dso::EopHighRateTable heop;
+///   if (heop.build(eops, mjd_start_tt, mjd_end_tt)) { ... error ... }
+///   dso::EopRecord eopr;
+///   heop.interpolate(fmjd_tt, eopr);
+///   params.eop_high_rate = &heop; // see dso::update_time_cache
+class EopHighRateTable {
+public:
+  /// @brief Constructor
+  /// @param[in] _step Spacing of the table [sec]
+  /// @param[in] _order Order of interpolation (uses order+1 points, at most
+  ///            16)
+  explicit EopHighRateTable(double _step = 600e0, int _order = 3) noexcept
+      : step(_step), order(_order) {}
+
+  ~EopHighRateTable() noexcept { delete[] mem_arena; }
+
+  EopHighRateTable(const EopHighRateTable &) = delete;
+  EopHighRateTable &operator=(const EopHighRateTable &) = delete;
+
+  /// @brief (Re-)build the table for the arc [start, end] (mjd, TT); the
+  ///        table is extended by (order+1)/2 points on each side.
+  /// @param[in] eops Daily EOP values (must cover the arc plus the margins
+  ///            of its own interpolation)
+  /// @return Anything other than 0 denotes an error
+  int build(const EopLookUpTable &eops, double fmjd_tt_start,
+            double fmjd_tt_end) noexcept;
+
+  /// @brief Number of epochs in table
+  int size() const noexcept { return sz; }
+
+  /// @brief Check if the given epoch (mjd, TT) is covered by the table
+  bool contains(double fmjd_tt) const noexcept {
+    return sz && fmjd_tt >= mjd_first &&
+           fmjd_tt <= mjd_first + (sz - 1) * (step / 86400e0);
+  }
+
+  /// @brief Interpolate (fully corrected) EOP values at the given epoch
+  ///        (same as EopLookUpTable::interpolate)
+  /// @return Anything other than 0 denotes an error (epoch not covered)
+  int interpolate(double fmjd_tt, EopRecord &eopr) const noexcept;
+
+private:
+  /// spacing [sec] and order of interpolation
+  double step;
+  int order;
+  /// first epoch (mjd, TT) and number of epochs
+  double mjd_first{0e0};
+  int sz{0};
+  /// xp, yp, dut, dx, dy, lod and omega series, one after the other (each
+  /// of size sz)
+  double *mem_arena{nullptr};
+}; // EopHighRateTable
+
 /// @brief Extract data EOP from an EopFile for given dates
 ///        The function will extract EOP for the time interval: [start,end)
 ///        off of this instance.
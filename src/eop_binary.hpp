@@ -0,0 +1,134 @@
+#ifndef __DSO_EOP_BINARY_STORE_HPP__
+#define __DSO_EOP_BINARY_STORE_HPP__
+
+#include "eop.hpp"
+#include <cstdint>
+#include <ctime>
+
+namespace dso {
+
+/// @brief Header of a binary EOP file (see dso::EopBinaryStore); followed by
+///        the xp, yp, UT1-UTC, LOD, dX and dY arrays (in that order, each of
+///        nrec doubles, native byte order).
+struct EopBinaryHeader {
+  /// "DSOEOPB" (null-terminated)
+  char magic[8];
+  /// format version
+  std::uint32_t version;
+  /// byte order marker; 0x01020304 in the byte order of the writer
+  std::uint32_t byte_order;
+  /// number of (daily) records
+  std::int64_t nrec;
+  /// MJD (UTC) of the first record; record i is at mjd_first + i
+  std::int64_t mjd_first;
+  /// time of conversion (seconds since epoch)
+  std::int64_t created;
+  /// size and modification time of the source (C04) file at conversion
+  std::int64_t source_size;
+  std::int64_t source_mtime;
+  /// padding, so that the arrays are aligned to 64 bytes
+  char reserved[8];
+}; // EopBinaryHeader
+
+/// @brief Convert an IERS C04 file (see dso::parse_iers_C04) to the binary
+///        format of dso::EopBinaryStore.
+///
+/// The whole file is converted; records must be daily and continuous. The
+/// output file is written under a temporary name and renamed at the end, so
+/// that processes reading (mapping) a previous version are not affected.
+/// @param[in] c04fn The C04 file
+/// @param[in] binfn The binary file to create (or replace)
+/// @return Anything other than 0 denotes an error
+int c04_to_binary(const char *c04fn, const char *binfn) noexcept;
+
+/// @brief A (read-only) EOP store, memory-mapped off of a binary file
+///        created via dso::c04_to_binary.
+///
+/// Records are at uniform daily spacing (0h UTC), hence an epoch maps to an
+/// index via plain arithmetic (no search). The file is mapped shared and
+/// read-only, so that any number of (worker) processes use the same pages
+/// of the page cache instead of parsing the C04 file each.
+///
+/// Example:
+///   dso::EopBinaryStore store;
+///   if (store.open("eopc04.bin") || store.is_stale("eopc04.txt")) {
+///     dso::c04_to_binary("eopc04.txt", "eopc04.bin"); ... re-open ...
+///   }
+///   dso::EopLookUpTable eops;
+///   store.extract(start, end, eops); // same as dso::parse_iers_C04
+class EopBinaryStore {
+public:
+  EopBinaryStore() noexcept {};
+  ~EopBinaryStore() noexcept { close(); }
+  EopBinaryStore(const EopBinaryStore &) = delete;
+  EopBinaryStore &operator=(const EopBinaryStore &) = delete;
+
+  /// @brief Map a binary EOP file (closing any previously mapped one)
+  /// @return Anything other than 0 denotes an error (e.g. missing file,
+  ///         invalid header, different byte order)
+  int open(const char *binfn) noexcept;
+
+  /// @brief Unmap the file
+  void close() noexcept;
+
+  /// @brief Number of (daily) records
+  int size() const noexcept { return hdr ? hdr->nrec : 0; }
+
+  /// @brief First and last MJD (UTC) in store
+  long first_mjd() const noexcept { return hdr ? hdr->mjd_first : 0; }
+  long last_mjd() const noexcept {
+    return hdr ? hdr->mjd_first + hdr->nrec - 1 : 0;
+  }
+
+  /// @brief Index of the record at (UTC) mjd, or -1 if not in store
+  int index(long mjd) const noexcept {
+    return (hdr && mjd >= hdr->mjd_first && mjd <= last_mjd())
+               ? (int)(mjd - hdr->mjd_first)
+               : -1;
+  }
+
+  /// @brief Pointers to the arrays; values as in the C04 file (i.e.
+  ///        [arcsec] and [sec])
+  const double *xp() const noexcept { return data; }
+  const double *yp() const noexcept { return data + size(); }
+  const double *dut() const noexcept { return data + 2 * size(); }
+  const double *lod() const noexcept { return data + 3 * size(); }
+  const double *dx() const noexcept { return data + 4 * size(); }
+  const double *dy() const noexcept { return data + 5 * size(); }
+
+  /// @brief Fill in an EopLookUpTable for the interval [start, end) (UTC),
+  ///        exactly as dso::parse_iers_C04 would (i.e. with the mjd array in
+  ///        TT)
+  /// @return Anything other than 0 denotes an error (e.g. interval not
+  ///         covered, or empty/reversed interval, i.e. end <= start)
+  int extract(dso::modified_julian_day start, dso::modified_julian_day end,
+              EopLookUpTable &eoptable) const noexcept;
+
+  /// @brief Check if the store covers the interval [start, end) (UTC)
+  bool covers(dso::modified_julian_day start,
+              dso::modified_julian_day end) const noexcept {
+    return index(start.as_underlying_type()) >= 0 &&
+           index(end.as_underlying_type() - 1) >= 0;
+  }
+
+  /// @brief Check if the source (C04) file has changed (size or
+  ///        modification time) since the conversion; a missing source file
+  ///        is not considered a change
+  bool is_stale(const char *c04fn) const noexcept;
+
+  /// @brief Age of the store, i.e. time since conversion [sec]
+  double age() const noexcept {
+    return hdr ? std::difftime(std::time(nullptr), (std::time_t)hdr->created)
+               : 0e0;
+  }
+
+private:
+  const EopBinaryHeader *hdr{nullptr};
+  const double *data{nullptr};
+  void *map{nullptr};
+  std::size_t map_size{0};
+}; // EopBinaryStore
+
+} // namespace dso
+
+#endif
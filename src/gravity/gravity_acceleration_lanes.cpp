@@ -0,0 +1,128 @@
+#include "egravity.hpp"
+#include <algorithm>
+#include <cmath>
+
+dso::GravityLanes::GravityLanes(int degree, int order) noexcept
+    : m_degree(degree), m_order(order) {
+  // we need V and W up to degree+1 (and order+1)
+  const int sz = idx(degree + 2, 0);
+  V.resize(sz);
+  W.resize(sz);
+}
+
+void dso::GravityLanes::accel(const Lane &x, const Lane &y, const Lane &z,
+                              const dso::HarmonicCoeffs &hc, Lane &ax,
+                              Lane &ay, Lane &az) noexcept {
+  const double R = hc.Re();
+  const int l = m_degree + 1;
+  const int k = m_order + 1;
+
+  // same as dso::lagrange_polynomials, one position per lane
+  const Lane r2 = x * x + y * y + z * z;
+  const Lane rho = (R * R) / r2;
+  const Lane x0 = R * x / r2;
+  const Lane y0 = R * y / r2;
+  const Lane z0 = R * z / r2;
+
+  // zonal terms V(n,0); W(n,0)=0
+  V[idx(0, 0)] = R / r2.sqrt();
+  W[idx(0, 0)] = Lane::Zero();
+  V[idx(1, 0)] = z0 * V[idx(0, 0)];
+  W[idx(1, 0)] = Lane::Zero();
+  for (int n = 2; n <= l; n++) {
+    V[idx(n, 0)] = ((2e0 * n - 1e0) * z0 * V[idx(n - 1, 0)] -
+                    (n - 1) * rho * V[idx(n - 2, 0)]) /
+                   n;
+    W[idx(n, 0)] = Lane::Zero();
+  }
+
+  // tesseral and sectorial terms
+  for (int m = 1; m <= k; m++) {
+    // Eq. 3.29 for V_mm and W_mm
+    const Lane &Vm1 = V[idx(m - 1, m - 1)];
+    const Lane &Wm1 = W[idx(m - 1, m - 1)];
+    V[idx(m, m)] = (2 * m - 1) * (x0 * Vm1 - y0 * Wm1);
+    W[idx(m, m)] = (2 * m - 1) * (x0 * Wm1 + y0 * Vm1);
+
+    if (m < l) {
+      V[idx(m + 1, m)] = (2 * m + 1) * z0 * V[idx(m, m)];
+      W[idx(m + 1, m)] = (2 * m + 1) * z0 * W[idx(m, m)];
+    }
+
+    // Eq. 3.30 for V_nm and W_nm
+    for (int n = m + 2; n <= l; n++) {
+      V[idx(n, m)] = ((2 * n - 1) * z0 * V[idx(n - 1, m)] -
+                      (n + m - 1) * rho * V[idx(n - 2, m)]) /
+                     (n - m);
+      W[idx(n, m)] = ((2 * n - 1) * z0 * W[idx(n - 1, m)] -
+                      (n + m - 1) * rho * W[idx(n - 2, m)]) /
+                     (n - m);
+    }
+  }
+
+  // harmonic sums; same as dso::grav_potential_accel
+  Lane xacc = Lane::Zero(), yacc = Lane::Zero(), zacc = Lane::Zero();
+
+  // m = 0 part
+  for (int i = 0; i <= m_degree; i++) {
+    const double Cn0 = hc.C(i, 0);
+    zacc -= (i + 1) * Cn0 * V[idx(i + 1, 0)];
+    xacc -= Cn0 * V[idx(i + 1, 1)];
+    yacc -= Cn0 * W[idx(i + 1, 1)];
+  }
+
+  // m != 0
+  Lane xacc2 = Lane::Zero(), yacc2 = Lane::Zero(), zacc2 = Lane::Zero();
+  for (int i = 1; i <= m_degree; i++) {
+    for (int j = 1; j <= std::min(i, m_order); j++) {
+      const double Cnm = hc.C(i, j);
+      const double Snm = hc.S(i, j);
+      const Lane &Vnp1mm1 = V[idx(i + 1, j - 1)];
+      const Lane &Vnp1mp0 = V[idx(i + 1, j)];
+      const Lane &Vnp1mp1 = V[idx(i + 1, j + 1)];
+      const Lane &Wnp1mm1 = W[idx(i + 1, j - 1)];
+      const Lane &Wnp1mp0 = W[idx(i + 1, j)];
+      const Lane &Wnp1mp1 = W[idx(i + 1, j + 1)];
+      const double fac = (i - j + 1) * (i - j + 2) / 2e0;
+
+      xacc2 += 0.5e0 * (-Cnm * Vnp1mp1 - Snm * Wnp1mp1) +
+               fac * (Cnm * Vnp1mm1 + Snm * Wnp1mm1);
+      yacc2 += 0.5e0 * (-Cnm * Wnp1mp1 + Snm * Vnp1mp1) +
+               fac * (-Cnm * Wnp1mm1 + Snm * Vnp1mm1);
+      zacc2 += (i - j + 1) * (-Cnm * Vnp1mp0 - Snm * Wnp1mp0);
+    }
+  }
+
+  const double scale = hc.GM() / (R * R);
+  ax = (xacc + xacc2) * scale;
+  ay = (yacc + yacc2) * scale;
+  az = (zacc + zacc2) * scale;
+}
+
+void dso::GravityLanes::accel(int K, const double *x, const double *y,
+                              const double *z, const dso::HarmonicCoeffs &hc,
+                              double *ax, double *ay, double *az) noexcept {
+  constexpr const int L = GravityNumLanes;
+  Lane lx, ly, lz, lax, lay, laz;
+
+  for (int k0 = 0; k0 < K; k0 += L) {
+    // gather positions; the last (incomplete) group is padded with copies of
+    // the last position
+    for (int l = 0; l < L; l++) {
+      const int k = std::min(k0 + l, K - 1);
+      lx(l) = x[k];
+      ly(l) = y[k];
+      lz(l) = z[k];
+    }
+
+    accel(lx, ly, lz, hc, lax, lay, laz);
+
+    // scatter results
+    const int nl = std::min(L, K - k0);
+    for (int l = 0; l < nl; l++) {
+      ax[k0 + l] = lax(l);
+      ay[k0 + l] = lay(l);
+      az[k0 + l] = laz(l);
+    }
+  }
+}
@@ -0,0 +1,143 @@
+#include "egravity.hpp"
+#include <cmath>
+
+/// @file zonal_acceleration.cpp
+/// Specialized evaluation of the geopotential acceleration (and gradient)
+/// when only zonal terms (order m=0) are considered.
+///
+/// For m=0, the acceleration only needs V(n,0), V(n,1) and W(n,1) (and the
+/// gradient additionally needs V(n,2) and W(n,2)); see Montenbruck, Gill,
+/// ch. 3.2.5.
+/// Since (Eq. 3.29),
+///   V(n,1) = x0 * q(n),               W(n,1) = y0 * q(n), and
+///   V(n,2) = (x0^2 - y0^2) * s(n),    W(n,2) = 2 * x0 * y0 * s(n)
+/// where q(n) and s(n) follow the same column recursion as V(n,m) (Eq. 3.30)
+/// for m=1 and m=2 respectively, we only need to carry three scalar
+/// sequences (V(n,0), q(n), s(n)). These are computed with rolling
+/// recursions, accumulating the sums on the fly, hence no (trapezoid) matrix
+/// is needed.
+
+namespace {
+/// @brief Normalized coordinates and the V(0,0) term, as used in the
+///        Lagrange polynomials recursion (see dso::lagrange_polynomials)
+struct ZonalRecursionStart {
+  double x0, y0, z0, rho, v00;
+  ZonalRecursionStart(const Eigen::Matrix<double, 3, 1> &pos,
+                      double Re) noexcept {
+    const double r2 = pos.squaredNorm();
+    rho = Re * Re / r2;
+    x0 = Re * pos(0) / r2;
+    y0 = Re * pos(1) / r2;
+    z0 = Re * pos(2) / r2;
+    v00 = Re / std::sqrt(r2);
+  }
+}; // ZonalRecursionStart
+} // unnamed namespace
+
+Eigen::Matrix<double, 3, 1>
+dso::grav_potential_accel_zonal(const Eigen::Matrix<double, 3, 1> &pos,
+                                int degree,
+                                const dso::HarmonicCoeffs &hc) noexcept {
+  const ZonalRecursionStart rs(pos, hc.Re());
+
+  // V(n,0) for n-2, n-1, n (start at n=1)
+  double vnm2 = 0e0;
+  double vnm1 = rs.v00;
+  double vn = rs.z0 * rs.v00;
+  // q(n) for n-2, n-1, n (start at n=1); V(0,1) = W(0,1) = 0
+  double qnm2 = 0e0;
+  double qnm1 = 0e0;
+  double qn = rs.v00;
+
+  // sums over degree; for degree i we need V(i+1,0), V(i+1,1), W(i+1,1)
+  double zsum(0e0), qsum(0e0);
+  for (int n = 1; n <= degree + 1; n++) {
+    if (n > 1) {
+      vnm2 = vnm1;
+      vnm1 = vn;
+      vn = ((2e0 * n - 1e0) * rs.z0 * vnm1 - (n - 1) * rs.rho * vnm2) / n;
+      qnm2 = qnm1;
+      qnm1 = qn;
+      qn = ((2e0 * n - 1e0) * rs.z0 * qnm1 - n * rs.rho * qnm2) / (n - 1);
+    }
+    const double Cn0 = hc.C(n - 1, 0);
+    zsum += n * Cn0 * vn;
+    qsum += Cn0 * qn;
+  }
+
+  const double fac = hc.GM() / (hc.Re() * hc.Re());
+  Eigen::Matrix<double, 3, 1> acc;
+  acc << -fac * rs.x0 * qsum, -fac * rs.y0 * qsum, -fac * zsum;
+  return acc;
+}
+
+Eigen::Matrix<double, 3, 1>
+dso::grav_potential_accel_zonal(const Eigen::Matrix<double, 3, 1> &pos,
+                                int degree, const dso::HarmonicCoeffs &hc,
+                                Eigen::Matrix<double, 3, 3> &partials) noexcept {
+  const ZonalRecursionStart rs(pos, hc.Re());
+
+  // V(n,0), q(n) and s(n) for n-2, n-1, n (start at n=1); s(1) = s(0) = 0
+  double vnm2 = 0e0, vnm1 = rs.v00, vn = rs.z0 * rs.v00;
+  double qnm2 = 0e0, qnm1 = 0e0, qn = rs.v00;
+  double snm2 = 0e0, snm1 = 0e0, sn = 0e0;
+
+  // acceleration: degree i needs the terms at n=i+1
+  double zsum(0e0), qsum(0e0);
+  // partials: degree i needs the terms at n=i+2
+  double ssum(0e0), fqsum(0e0), fvsum(0e0);
+
+  for (int n = 1; n <= degree + 2; n++) {
+    if (n > 1) {
+      vnm2 = vnm1;
+      vnm1 = vn;
+      vn = ((2e0 * n - 1e0) * rs.z0 * vnm1 - (n - 1) * rs.rho * vnm2) / n;
+      qnm2 = qnm1;
+      qnm1 = qn;
+      qn = ((2e0 * n - 1e0) * rs.z0 * qnm1 - n * rs.rho * qnm2) / (n - 1);
+      snm2 = snm1;
+      snm1 = sn;
+      sn = (n == 2) ? (3e0 * rs.v00)
+                    : (((2e0 * n - 1e0) * rs.z0 * snm1 -
+                        (n + 1) * rs.rho * snm2) /
+                       (n - 2));
+    }
+
+    if (n <= degree + 1) {
+      const double Cn0 = hc.C(n - 1, 0);
+      zsum += n * Cn0 * vn;
+      qsum += Cn0 * qn;
+    }
+
+    if (n >= 2) {
+      const double Cn0 = hc.C(n - 2, 0);
+      /* (i+2)! / i! for i = n - 2 */
+      const double fac = (double)((n - 1) * n);
+      ssum += Cn0 * sn;
+      fqsum += (n - 1) * Cn0 * qn;
+      fvsum += fac * Cn0 * vn;
+    }
+  }
+
+  // acceleration
+  const double afac = hc.GM() / (hc.Re() * hc.Re());
+  Eigen::Matrix<double, 3, 1> acc;
+  acc << -afac * rs.x0 * qsum, -afac * rs.y0 * qsum, -afac * zsum;
+
+  // partials; note that the gradient is symmetric and traceless
+  const double x2my2 = rs.x0 * rs.x0 - rs.y0 * rs.y0;
+  const double twoxy = 2e0 * rs.x0 * rs.y0;
+  partials(0, 0) = 0.5e0 * (x2my2 * ssum - fvsum);     // dax/dx
+  partials(1, 0) = 0.5e0 * twoxy * ssum;               // dax/dy
+  partials(2, 0) = rs.x0 * fqsum;                      // dax/dz
+  partials(2, 1) = rs.y0 * fqsum;                      // day/dz
+  partials(2, 2) = fvsum;                              // daz/dz
+  partials(1, 1) = -(partials(0, 0) + partials(2, 2)); // day/dy
+  partials(0, 1) = partials(1, 0);
+  partials(0, 2) = partials(2, 0);
+  partials(1, 2) = partials(2, 1);
+
+  partials *= (hc.GM() / hc.Re() / hc.Re() / hc.Re());
+
+  return acc;
+}
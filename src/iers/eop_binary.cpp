@@ -0,0 +1,226 @@
+#include "eop_binary.hpp"
+#include "datetime/utcdates.hpp"
+#include <charconv>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+constexpr const char eop_magic[8] = "DSOEOPB";
+constexpr const std::uint32_t eop_version = 1;
+constexpr const std::uint32_t eop_byte_order = 0x01020304;
+constexpr const std::size_t MAX_LINE_CHARS = 256;
+
+/// first and last MJD of the (data) records of a C04 file
+int c04_span(const char *c04fn, long &first, long &last) noexcept {
+  std::ifstream fin(c04fn);
+  if (!fin.is_open())
+    return 1;
+  char line[MAX_LINE_CHARS];
+  first = last = -1;
+  while (fin.getline(line, MAX_LINE_CHARS)) {
+    if (*line && (*line != ' ' && *line != '#')) {
+      // skip the data (YYYY MM DD) which is 12 chars length
+      const char *start = line + 12;
+      while (*start == ' ')
+        ++start;
+      long imjd;
+      auto fcr = std::from_chars(start, line + std::strlen(line), imjd);
+      if (fcr.ec != std::errc() || fcr.ptr == start)
+        return 1;
+      if (first < 0)
+        first = imjd;
+      last = imjd;
+    }
+  }
+  return first < 0;
+}
+} // unnamed namespace
+
+int dso::c04_to_binary(const char *c04fn, const char *binfn) noexcept {
+  // span of the file
+  long first, last;
+  if (c04_span(c04fn, first, last)) {
+    fprintf(stderr,
+            "[ERROR] Failed reading EOP (C04) file %s (traceback: %s)\n",
+            c04fn, __func__);
+    return 1;
+  }
+
+  // parse the whole file (records must be continuous)
+  dso::EopLookUpTable eops(last - first + 1);
+  if (dso::parse_iers_C04(c04fn, dso::modified_julian_day(first),
+                          dso::modified_julian_day(last + 1), eops)) {
+    fprintf(stderr,
+            "[ERROR] Failed parsing EOP (C04) file %s; note that records "
+            "should be daily and continuous (traceback: %s)\n",
+            c04fn, __func__);
+    return 1;
+  }
+
+  // header
+  struct stat st;
+  if (stat(c04fn, &st)) {
+    fprintf(stderr, "[ERROR] Failed to stat file %s (traceback: %s)\n", c04fn,
+            __func__);
+    return 1;
+  }
+  dso::EopBinaryHeader hdr;
+  std::memset(&hdr, 0, sizeof(hdr));
+  std::memcpy(hdr.magic, eop_magic, sizeof(eop_magic));
+  hdr.version = eop_version;
+  hdr.byte_order = eop_byte_order;
+  hdr.nrec = eops.size();
+  hdr.mjd_first = first;
+  hdr.created = (std::int64_t)std::time(nullptr);
+  hdr.source_size = (std::int64_t)st.st_size;
+  hdr.source_mtime = (std::int64_t)st.st_mtime;
+
+  // write to a temporary file and rename
+  char tmpfn[512];
+  if (std::snprintf(tmpfn, sizeof(tmpfn), "%s.tmp", binfn) >=
+      (int)sizeof(tmpfn)) {
+    fprintf(stderr, "[ERROR] Filename too long %s (traceback: %s)\n", binfn,
+            __func__);
+    return 1;
+  }
+  FILE *fout = std::fopen(tmpfn, "wb");
+  if (!fout) {
+    fprintf(stderr, "[ERROR] Failed opening file %s (traceback: %s)\n", tmpfn,
+            __func__);
+    return 1;
+  }
+  const std::size_t n = eops.size();
+  bool ok = (std::fwrite(&hdr, sizeof(hdr), 1, fout) == 1);
+  const dso::EopLookUpTable &ceops = eops;
+  for (const double *series : {ceops.xp(), ceops.yp(), ceops.dut(),
+                               ceops.lod(), ceops.dx(), ceops.dy()})
+    ok = ok && (std::fwrite(series, sizeof(double), n, fout) == n);
+  ok = (std::fclose(fout) == 0) && ok;
+  if (!ok || std::rename(tmpfn, binfn)) {
+    fprintf(stderr,
+            "[ERROR] Failed writing binary EOP file %s (traceback: %s)\n",
+            binfn, __func__);
+    std::remove(tmpfn);
+    return 1;
+  }
+
+  return 0;
+}
+
+int dso::EopBinaryStore::open(const char *binfn) noexcept {
+  close();
+
+  const int fd = ::open(binfn, O_RDONLY);
+  if (fd < 0) {
+    fprintf(stderr,
+            "[ERROR] Failed opening binary EOP file %s (traceback: %s)\n",
+            binfn, __func__);
+    return 1;
+  }
+  struct stat st;
+  if (fstat(fd, &st) || (std::size_t)st.st_size < sizeof(EopBinaryHeader)) {
+    fprintf(stderr, "[ERROR] Invalid binary EOP file %s (traceback: %s)\n",
+            binfn, __func__);
+    ::close(fd);
+    return 1;
+  }
+
+  // map (shared, read-only); the mapping survives closing the descriptor
+  void *ptr = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+  ::close(fd);
+  if (ptr == MAP_FAILED) {
+    fprintf(stderr,
+            "[ERROR] Failed mapping binary EOP file %s (traceback: %s)\n",
+            binfn, __func__);
+    return 1;
+  }
+  map = ptr;
+  map_size = st.st_size;
+
+  // validate header
+  const EopBinaryHeader *h = static_cast<const EopBinaryHeader *>(map);
+  const bool valid =
+      !std::memcmp(h->magic, eop_magic, sizeof(eop_magic)) &&
+      h->version == eop_version && h->byte_order == eop_byte_order &&
+      h->nrec > 0 &&
+      map_size == sizeof(EopBinaryHeader) + 6 * h->nrec * sizeof(double);
+  if (!valid) {
+    fprintf(stderr,
+            "[ERROR] Invalid binary EOP file %s (bad header, version, byte "
+            "order or size) (traceback: %s)\n",
+            binfn, __func__);
+    close();
+    return 1;
+  }
+  hdr = h;
+  data = reinterpret_cast<const double *>(static_cast<const char *>(map) +
+                                          sizeof(EopBinaryHeader));
+
+  return 0;
+}
+
+void dso::EopBinaryStore::close() noexcept {
+  if (map)
+    munmap(map, map_size);
+  map = nullptr;
+  map_size = 0;
+  hdr = nullptr;
+  data = nullptr;
+}
+
+int dso::EopBinaryStore::extract(dso::modified_julian_day start,
+                                 dso::modified_julian_day end,
+                                 dso::EopLookUpTable &eoptable) const noexcept {
+  if (end.as_underlying_type() <= start.as_underlying_type()) {
+    fprintf(stderr,
+            "[ERROR] Invalid EOP interval [%ld, %ld); end must be after start "
+            "(traceback: %s)\n",
+            (long)start.as_underlying_type(), (long)end.as_underlying_type(),
+            __func__);
+    return 1;
+  }
+
+  if (!covers(start, end)) {
+    fprintf(stderr,
+            "[ERROR] Binary EOP store [%ld, %ld] does not cover the requested "
+            "interval (traceback: %s)\n",
+            first_mjd(), last_mjd(), __func__);
+    return 1;
+  }
+
+  const int first = index(start.as_underlying_type());
+  const int days = end.as_underlying_type() - start.as_underlying_type();
+  eoptable.resize(days);
+  for (int i = 0; i < days; i++) {
+    // UTC date to TT (same as dso::parse_iers_C04)
+    dso::modified_julian_day tai_mjd;
+    const double tai_fday = dso::utc2tai(
+        dso::modified_julian_day(start.as_underlying_type() + i), 0e0,
+        tai_mjd);
+    *(eoptable.mjd(i)) = tai_fday + (32.184e0 / 86400e0) +
+                         static_cast<double>(tai_mjd.as_underlying_type());
+  }
+  // direct copies of the series
+  std::memcpy(eoptable.xp(), xp() + first, days * sizeof(double));
+  std::memcpy(eoptable.yp(), yp() + first, days * sizeof(double));
+  std::memcpy(eoptable.dut(), dut() + first, days * sizeof(double));
+  std::memcpy(eoptable.lod(), lod() + first, days * sizeof(double));
+  std::memcpy(eoptable.dx(), dx() + first, days * sizeof(double));
+  std::memcpy(eoptable.dy(), dy() + first, days * sizeof(double));
+  std::memset(eoptable.omega(), 0, days * sizeof(double));
+
+  return 0;
+}
+
+bool dso::EopBinaryStore::is_stale(const char *c04fn) const noexcept {
+  struct stat st;
+  if (!hdr || stat(c04fn, &st))
+    return false;
+  return (std::int64_t)st.st_size != hdr->source_size ||
+         (std::int64_t)st.st_mtime != hdr->source_mtime;
+}
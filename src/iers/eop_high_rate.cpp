@@ -0,0 +1,88 @@
+#include "eop.hpp"
+#include "lagrange.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+int dso::EopHighRateTable::build(const dso::EopLookUpTable &eops,
+                                 double fmjd_tt_start,
+                                 double fmjd_tt_end) noexcept {
+  delete[] mem_arena;
+  mem_arena = nullptr;
+  sz = 0;
+  if (fmjd_tt_end < fmjd_tt_start || order < 1 || order > 15 ||
+      step <= 0e0) {
+    fprintf(stderr,
+            "[ERROR] Invalid arc or table parameters (traceback: %s)\n",
+            __func__);
+    return 1;
+  }
+
+  // epochs, extended by (order+1)/2 on each side
+  const double h = step / 86400e0;
+  const int margin = (order + 1) / 2;
+  const int n =
+      (int)std::ceil((fmjd_tt_end - fmjd_tt_start) / h) + 1 + 2 * margin;
+  mjd_first = fmjd_tt_start - margin * h;
+
+  mem_arena = new double[7 * n];
+  dso::EopRecord eopr;
+  for (int i = 0; i < n; i++) {
+    if (eops.interpolate(mjd_first + i * h, eopr)) {
+      fprintf(stderr,
+              "[ERROR] Failed interpolating EOP at MJD=%.6f (traceback: %s)\n",
+              mjd_first + i * h, __func__);
+      delete[] mem_arena;
+      mem_arena = nullptr;
+      return 1;
+    }
+    mem_arena[i] = eopr.xp;
+    mem_arena[n + i] = eopr.yp;
+    mem_arena[2 * n + i] = eopr.dut;
+    mem_arena[3 * n + i] = eopr.dx;
+    mem_arena[4 * n + i] = eopr.dy;
+    mem_arena[5 * n + i] = eopr.lod;
+    mem_arena[6 * n + i] = eopr.omega;
+  }
+  sz = n;
+
+  return 0;
+}
+
+int dso::EopHighRateTable::interpolate(double fmjd_tt,
+                                       dso::EopRecord &eopr) const noexcept {
+  if (!contains(fmjd_tt)) {
+    fprintf(stderr,
+            "[ERROR] Epoch MJD=%.6f out of high-rate EOP table range "
+            "(traceback: %s)\n",
+            fmjd_tt, __func__);
+    return 1;
+  }
+
+  // window of order+1 points around the epoch
+  const double u = (fmjd_tt - mjd_first) * 86400e0 / step;
+  const int np = std::min(order + 1, sz);
+  const int first =
+      std::max(0, std::min((int)std::floor(u) - (np - 1) / 2, sz - np));
+
+  // Lagrange weights on the uniform grid (nodes at 0, 1, ..., np-1)
+  double w[16];
+  dso::lagrange_weights(u - first, np, w);
+
+  double v[7] = {0e0, 0e0, 0e0, 0e0, 0e0, 0e0, 0e0};
+  for (int j = 0; j < np; j++) {
+    const double *node = mem_arena + first + j;
+    for (int k = 0; k < 7; k++)
+      v[k] += w[j] * node[k * sz];
+  }
+  eopr.xp = v[0];
+  eopr.yp = v[1];
+  eopr.dut = v[2];
+  eopr.dx = v[3];
+  eopr.dy = v[4];
+  eopr.lod = v[5];
+  eopr.omega = v[6];
+  eopr.mjd = fmjd_tt;
+
+  return 0;
+}
@@ -1,37 +1,78 @@
 #include "eop.hpp"
+#include "lagrange.hpp"
 #include "iers2010/iers2010.hpp"
 #include "datetime/utcdates.hpp"
 #include <datetime/dtfund.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+int dso::EopLookUpTable::lagrange_weights(double tt_fmjd, int order,
+                                          int &first, double *w) const noexcept {
+  const int np = order + 1;
+  const double *mjda = array(0);
+  if (order < 1 || np > max_lagrange_points || sz < np ||
+      tt_fmjd < mjda[0] || tt_fmjd > mjda[sz - 1]) {
+    fprintf(stderr,
+            "[ERROR] Cannot interpolate EOP/ERP parameters for MJD=%.6f, "
+            "order=%d (table spans [%.3f, %.3f]) (traceback: %s)\n",
+            tt_fmjd, order, sz ? mjda[0] : 0e0, sz ? mjda[sz - 1] : 0e0,
+            __func__);
+    return 1;
+  }
+
+  // locate i, such that mjd[i] <= t < mjd[i+1]; try the hint (i.e. the
+  // window of the previous call) first, then binary search
+  int i = first + (np - 1) / 2;
+  if (i < 0 || i >= sz - 1 || !(mjda[i] <= tt_fmjd && tt_fmjd < mjda[i + 1])) {
+    if (i >= 0 && i < sz - 2 && mjda[i + 1] <= tt_fmjd &&
+        tt_fmjd < mjda[i + 2]) {
+      ++i;
+    } else {
+      i = (int)(std::upper_bound(mjda, mjda + sz, tt_fmjd) - mjda) - 1;
+    }
+  }
+
+  // window of np points around [mjd[i], mjd[i+1]), within the table
+  first = std::max(0, std::min(i - (np - 1) / 2, sz - np));
+
+  // Lagrange basis at t
+  dso::lagrange_weights(tt_fmjd, mjda + first, np, w);
+
+  return 0;
+}
+
+void dso::EopLookUpTable::lagrange_apply(int first, int np, const double *w,
+                                         dso::EopRecord &eopr) const noexcept {
+  // all series are stored in the same arena, one after the other (with a
+  // stride of capacity); accumulate all of them in one pass over the window
+  double v[7] = {0e0, 0e0, 0e0, 0e0, 0e0, 0e0, 0e0};
+  for (int j = 0; j < np; j++) {
+    const double *node = array(0) + first + j;
+    for (int k = 0; k < 7; k++)
+      v[k] += w[j] * node[(k + 1) * capacity];
+  }
+  eopr.xp = v[0];
+  eopr.yp = v[1];
+  eopr.dut = v[2];
+  eopr.dx = v[3];
+  eopr.dy = v[4];
+  eopr.lod = v[5];
+  eopr.omega = v[6];
+}
 
 int dso::EopLookUpTable::interpolate_lagrange(
-    double tt_fmjd, dso::EopRecord &eopr, int order) const noexcept 
-{
-  int status = 0;
-  int index = -1;
-  status +=
-      iers2010::interp::lagint(mjd(), xp(), sz, tt_fmjd, eopr.xp, index, order);
-  status +=
-      iers2010::interp::lagint(mjd(), yp(), sz, tt_fmjd, eopr.yp, index, order);
-  status += iers2010::interp::lagint(mjd(), dut(), sz, tt_fmjd, eopr.dut, index,
-                                     order);
-  status +=
-      iers2010::interp::lagint(mjd(), dx(), sz, tt_fmjd, eopr.dx, index, order);
-  status +=
-      iers2010::interp::lagint(mjd(), dy(), sz, tt_fmjd, eopr.dy, index, order);
-  status += iers2010::interp::lagint(mjd(), lod(), sz, tt_fmjd, eopr.lod, index,
-                                     order);
-  status += iers2010::interp::lagint(mjd(), dx(), sz, tt_fmjd, eopr.dx, index,
-                                     order);
-  status += iers2010::interp::lagint(mjd(), dy(), sz, tt_fmjd, eopr.dy, index,
-                                     order);
-
-  if (status) {
+    double tt_fmjd, dso::EopRecord &eopr, int order) const noexcept {
+  int first = -1;
+  double w[max_lagrange_points];
+  if (lagrange_weights(tt_fmjd, order, first, w)) {
     fprintf(stderr,
             "[ERROR] Failed to interpolate EOP/ERP parameters for requested "
             "MJD=%.6f (traceback: %s)\n",
             tt_fmjd, __func__);
     return 1;
   }
+  lagrange_apply(first, order + 1, w, eopr);
 
   // remember to assign date to the filled-in instance
   eopr.mjd = tt_fmjd;
@@ -39,12 +80,57 @@ int dso::EopLookUpTable::interpolate_lagrange(
   return 0;
 }
 
+int dso::EopLookUpTable::interpolate_lagrange(const double *tt_fmjd, int n,
+                                              dso::EopRecord *eopr,
+                                              int order) const noexcept {
+  // the window of the previous epoch is used as a hint for the next one, so
+  // that (chronologically ordered) epochs need no search
+  int first = -1;
+  double w[max_lagrange_points];
+  for (int i = 0; i < n; i++) {
+    if (lagrange_weights(tt_fmjd[i], order, first, w)) {
+      fprintf(stderr,
+              "[ERROR] Failed to interpolate EOP/ERP parameters for requested "
+              "MJD=%.6f (index %d) (traceback: %s)\n",
+              tt_fmjd[i], i, __func__);
+      return 1;
+    }
+    lagrange_apply(first, order + 1, w, eopr[i]);
+    eopr[i].mjd = tt_fmjd[i];
+  }
+
+  return 0;
+}
+
 int dso::EopLookUpTable::interpolate(double tt_fmjd,
                                      dso::EopRecord &eopr, int order) const noexcept {
 
   // perform simple interpolation (lagrangian)
-  dso::EopLookUpTable::interpolate_lagrange(tt_fmjd, eopr, order);
+  if (interpolate_lagrange(tt_fmjd, eopr, order))
+    return 1;
+
+  // add (sub-daily) corrections
+  correct(tt_fmjd, eopr);
+
+  return 0;
+}
 
+int dso::EopLookUpTable::interpolate(const double *tt_fmjd, int n,
+                                     dso::EopRecord *eopr,
+                                     int order) const noexcept {
+  // perform simple interpolation (lagrangian), for all epochs
+  if (interpolate_lagrange(tt_fmjd, n, eopr, order))
+    return 1;
+
+  // add (sub-daily) corrections
+  for (int i = 0; i < n; i++)
+    correct(tt_fmjd[i], eopr[i]);
+
+  return 0;
+}
+
+void dso::EopLookUpTable::correct(double tt_fmjd,
+                                  dso::EopRecord &eopr) const noexcept {
   // TT as Julian centuries since J2000 (try to keep accuracy)
   double imjd;
   const double tt_fday = std::modf(tt_fmjd, &imjd);
@@ -77,8 +163,6 @@ int dso::EopLookUpTable::interpolate(double tt_fmjd,
   eopr.yp += cy;
 
   eopr.mjd = tt_fmjd; // TT MJD
-
-  return 0;
 }
 
   void dso::EopLookUpTable::regularize() noexcept {
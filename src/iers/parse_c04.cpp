@@ -111,6 +111,7 @@ int dso::parse_iers_C04(const char *c04fn, dso::modified_julian_day start_mjd,
         *(eoptable.lod(sz)) = data[3];
         *(eoptable.dx(sz)) = data[4];
         *(eoptable.dy(sz)) = data[5];
+        *(eoptable.omega(sz)) = 0e0;
 
         ++sz;
       } else if (cmjd >= end_mjd) {
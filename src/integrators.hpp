@@ -2,7 +2,15 @@
 #define __DSO_ORBIT_INTEGRATORS_HPP__
 
 #include "eigen3/Eigen/Eigen"
+#include "integrators/integrator_stats.hpp"
 #include "integrators/sgode.hpp"
+#include "integrators/dense_trajectory.hpp"
+#include "integrators/events.hpp"
+#include "integrators/gauss_jackson.hpp"
+#include "integrators/dormand_prince853.hpp"
+#include "integrators/sgoden.hpp"
+#include "integrators/chebyshev_trajectory.hpp"
+#include "integrators/picard_chebyshev.hpp"
 
 namespace dso {
 }// dso
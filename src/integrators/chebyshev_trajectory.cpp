@@ -0,0 +1,55 @@
+#include "chebyshev_trajectory.hpp"
+#include "chebyshev.hpp"
+#include <cstdio>
+
+int dso::ChebyshevTrajectory::find(double t) const noexcept {
+  if (!covers(t))
+    return -1;
+
+  // first segment with (direction-wise) t1 >= t
+  const double d = dir();
+  int lo = 0, hi = size() - 1;
+  while (lo < hi) {
+    const int mid = lo + (hi - lo) / 2;
+    if (d * (m_segments[mid].t1 - t) < 0e0)
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+  return lo;
+}
+
+int dso::ChebyshevTrajectory::interpolate(double t, Eigen::VectorXd &y,
+                                          Eigen::VectorXd *yp) const noexcept {
+  const int idx = find(t);
+  if (idx < 0) {
+    fprintf(stderr,
+            "[ERROR] Requested time %.9f outside trajectory span (traceback: "
+            "%s)\n",
+            t, __func__);
+    return 1;
+  }
+  const Segment &seg = m_segments[idx];
+
+  const double tau = (2e0 * t - seg.t0 - seg.t1) / (seg.t1 - seg.t0);
+  const Eigen::VectorXd zero = Eigen::VectorXd::Zero(m_neqn);
+  y = dso::clenshaw(
+      seg.ycoef.cols(), tau, [&](int k) { return seg.ycoef.col(k); }, zero);
+  if (yp)
+    *yp = dso::clenshaw(
+        seg.ypcoef.cols(), tau, [&](int k) { return seg.ypcoef.col(k); },
+        zero);
+
+  return 0;
+}
+
+int dso::ChebyshevTrajectory::state_and_stm(
+    double t, Eigen::Matrix<double, 6, 1> &state,
+    Eigen::Matrix<double, 6, 6> &stm) const noexcept {
+  Eigen::VectorXd y(m_neqn);
+  if (interpolate(t, y))
+    return 1;
+  state = y.block<6, 1>(0, 0);
+  stm = Eigen::Map<const Eigen::Matrix<double, 6, 6>>(y.data() + 6);
+  return 0;
+}
@@ -0,0 +1,85 @@
+#ifndef __DSO_CHEBYSHEV_TRAJECTORY_HPP__
+#define __DSO_CHEBYSHEV_TRAJECTORY_HPP__
+
+#include "eigen3/Eigen/Eigen"
+#include <vector>
+
+namespace dso {
+
+/// @brief A trajectory represented by (piecewise) Chebyshev series, e.g. as
+///        computed by dso::PicardChebyshev.
+///
+/// The trajectory is made up of consecutive segments [t0, t1]; within each
+/// segment, the solution y(t) and its derivative y'(t) are given as
+/// Chebyshev series of the normalized time τ = (2t - t0 - t1) / (t1 - t0),
+/// aka y(t) = Σ c_k T_k(τ).
+///
+/// The query interface is the same as the one of dso::DenseTrajectory (aka
+/// tbegin, tend, covers, interpolate and state_and_stm), so that both can
+/// be used interchangeably (e.g. in template code).
+class ChebyshevTrajectory {
+  /// A segment, valid in the interval [t0, t1]
+  struct Segment {
+    double t0, t1;
+    /// coefficients of the solution (neqn, order+2), order being the degree
+    /// of the series of the derivative (see dso::PicardChebyshev)
+    Eigen::MatrixXd ycoef;
+    /// coefficients of the derivative (neqn, order+1)
+    Eigen::MatrixXd ypcoef;
+  }; // Segment
+
+public:
+  /// @brief Constructor
+  /// @param[in] neqn Number of equations
+  explicit ChebyshevTrajectory(int neqn) noexcept : m_neqn(neqn) {}
+
+  /// @brief Append a segment; t0 should be the end of the last segment
+  ///        (if any)
+  void append(double t0, double t1, const Eigen::MatrixXd &ycoef,
+              const Eigen::MatrixXd &ypcoef) noexcept {
+    m_segments.push_back(Segment{t0, t1, ycoef, ypcoef});
+  }
+
+  /// @brief Drop all segments
+  void clear() noexcept { m_segments.clear(); }
+
+  /// @brief Number of segments
+  int size() const noexcept { return m_segments.size(); }
+
+  /// @brief First and last time covered by the trajectory
+  double tbegin() const noexcept { return m_segments.front().t0; }
+  double tend() const noexcept { return m_segments.back().t1; }
+
+  /// @brief Check if t is covered by the trajectory
+  bool covers(double t) const noexcept {
+    return size() && dir() * (t - tbegin()) >= 0e0 &&
+           dir() * (tend() - t) >= 0e0;
+  }
+
+  /// @brief Evaluate the solution at t (and optionally its derivative)
+  /// @return Anything other than 0 denotes an error (t not covered)
+  int interpolate(double t, Eigen::VectorXd &y,
+                  Eigen::VectorXd *yp = nullptr) const noexcept;
+
+  /// @brief Evaluate the state and state transition matrix at t, assuming
+  ///        the state + variational equations layout used in
+  ///        dso::VariationalEquations, i.e. y = [y, Φ(*,0), ..., Φ(*,5), ...]
+  /// @return Anything other than 0 denotes an error (t not covered)
+  int state_and_stm(double t, Eigen::Matrix<double, 6, 1> &state,
+                    Eigen::Matrix<double, 6, 6> &stm) const noexcept;
+
+private:
+  /// direction of integration
+  double dir() const noexcept {
+    return (m_segments.front().t1 < m_segments.front().t0) ? -1e0 : 1e0;
+  }
+  /// index of the (first) segment covering t, or -1
+  int find(double t) const noexcept;
+
+  int m_neqn;
+  std::vector<Segment> m_segments;
+}; // ChebyshevTrajectory
+
+} // dso
+
+#endif
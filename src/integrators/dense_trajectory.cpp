@@ -0,0 +1,131 @@
+#include "dense_trajectory.hpp"
+#include "sgode.hpp"
+#include <cstdio>
+
+void dso::DenseTrajectory::record(const dso::SGOde &integrator) noexcept {
+  const double x = integrator.x;
+  const double h = integrator.hold;
+
+  // if the integrator was restarted, drop any step that lies (even
+  // partially) past the new step's start
+  const double d = (h < 0e0) ? -1e0 : 1e0;
+  while (m_size && d * (at(m_size - 1).x - (x - h)) > 0e0)
+    --m_size;
+
+  // get a slot for the new step
+  Step *step;
+  if (m_size < (int)m_steps.size()) {
+    // reuse an already allocated slot
+    step = &at(m_size);
+    ++m_size;
+  } else if (!m_max_steps || (int)m_steps.size() < m_max_steps) {
+    // allocate a new slot; note that m_head is always 0 here
+    m_steps.emplace_back();
+    m_steps.back().coef = Eigen::MatrixXd(m_neqn, 14);
+    step = &m_steps.back();
+    ++m_size;
+  } else {
+    // streaming mode and full; drop the oldest step
+    step = &at(0);
+    m_head = (m_head + 1) % m_steps.size();
+  }
+
+  step->x = x;
+  step->h = h;
+  step->kold = integrator.kold;
+  // psi is the first column of SGOde::Arrays13
+  for (int i = 0; i < 12; i++)
+    step->psi[i] = integrator.Arrays13[i];
+  step->coef.leftCols(step->kold + 1) =
+      integrator.Phi.leftCols(step->kold + 1);
+  step->coef.col(13) = integrator.ArraysNeqn.col(2);
+}
+
+int dso::DenseTrajectory::find(double t) const noexcept {
+  if (!covers(t))
+    return -1;
+
+  // first step with (direction-wise) x >= t
+  const double d = dir();
+  int lo = 0, hi = size() - 1;
+  while (lo < hi) {
+    const int mid = lo + (hi - lo) / 2;
+    if (d * (at(mid).x - t) < 0e0)
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+  return lo;
+}
+
+int dso::DenseTrajectory::interpolate(double t, Eigen::VectorXd &y,
+                                      Eigen::VectorXd *yp) const noexcept {
+  const int idx = find(t);
+  if (idx < 0) {
+    fprintf(stderr,
+            "[ERROR] Requested time %.9f outside dense output span (traceback: "
+            "%s)\n",
+            t, __func__);
+    return 1;
+  }
+  const Step &step = at(idx);
+
+  // same as SGOde::intrp
+  double MemPool[3 * 13];
+  double *__restrict__ g = MemPool;
+  double *__restrict__ w = MemPool + 13;
+  double *__restrict__ rho = MemPool + 26;
+
+  const double hi = t - step.x;
+  const int ki = step.kold + 1;
+  const int kip1 = ki + 1;
+
+  g[0] = 1e0;
+  rho[0] = 1e0;
+
+  // initialize w(*) for computing g(*)
+  for (int i = 0; i < ki; i++)
+    w[i] = 1e0 / (double)(i + 1);
+
+  // compute g(*)
+  double term = 0e0;
+  for (int j = 1; j < ki; j++) {
+    const int jm1 = j - 1;
+    const double psijm1 = step.psi[jm1];
+    const double gamma = (hi + term) / psijm1;
+    const double eta = hi / psijm1;
+    const int limit = kip1 - j;
+    for (int i = 0; i < limit - 1; i++) {
+      w[i] = gamma * w[i] - eta * w[i + 1];
+    }
+    g[j] = w[0];
+    rho[j] = gamma * rho[jm1];
+    term = psijm1;
+  }
+
+  // interpolate
+  y = Eigen::VectorXd::Zero(m_neqn);
+  if (yp)
+    *yp = Eigen::VectorXd::Zero(m_neqn);
+  for (int j = 0; j < ki; j++) {
+    const int i = kip1 - j - 2;
+    y += (g[i] * step.coef.col(i));
+    if (yp)
+      *yp += (rho[i] * step.coef.col(i));
+  }
+
+  y = step.coef.col(13) + hi * y;
+
+  return 0;
+}
+
+int dso::DenseTrajectory::state_and_stm(
+    double t, Eigen::Matrix<double, 6, 1> &state,
+    Eigen::Matrix<double, 6, 6> &stm) const noexcept {
+  Eigen::VectorXd y(m_neqn);
+  if (interpolate(t, y))
+    return 1;
+  state = y.block<6, 1>(0, 0);
+  stm = Eigen::Map<const Eigen::Matrix<double, 6, 6>>(y.data() + 6);
+  return 0;
+}
@@ -0,0 +1,108 @@
+#ifndef __DSO_SGODE_DENSE_TRAJECTORY_HPP__
+#define __DSO_SGODE_DENSE_TRAJECTORY_HPP__
+
+#include "eigen3/Eigen/Eigen"
+#include <vector>
+
+namespace dso {
+
+class SGOde;
+
+/// @brief Dense output for the dso::SGOde integrator.
+///
+/// Records the interpolating polynomial of every accepted integration step
+/// (i.e. the integrator's x, yy, psi and the modified divided differences
+/// Phi, of order kold), so that the solution (and its derivative) can be
+/// evaluated at any time covered by the integration, without
+/// re-integrating. The evaluation is the same as in dso::SGOde::intrp.
+///
+/// Steps are stored sorted by the independent variable, so lookup is a
+/// binary search (O(log n)). If a maximum number of steps is given at
+/// construction, the storage works as a ring buffer (streaming mode): when
+/// full, the oldest step is dropped and its storage reused, so that memory
+/// is bounded and no allocation takes place while integrating.
+///
+/// To use, attach the instance to an integrator (SGOde::dense); each
+/// accepted step is then recorded within SGOde::de. If the integrator is
+/// restarted at some point inside the recorded span, steps past that point
+/// are dropped.
+class DenseTrajectory {
+  /// A recorded step, valid in the interval [x-h, x]
+  struct Step {
+    double x;
+    double h;
+    int kold;
+    double psi[12];
+    /// columns 0,...,kold hold Phi(*,0..kold), last column holds yy
+    Eigen::MatrixXd coef;
+  }; // Step
+
+public:
+  /// @brief Constructor
+  /// @param[in] neqn Number of equations (same as the integrator's)
+  /// @param[in] max_steps Maximum number of steps to keep; if 0, there is
+  ///            no limit
+  DenseTrajectory(int neqn, int max_steps = 0) noexcept
+      : m_neqn(neqn), m_max_steps(max_steps) {
+    if (m_max_steps)
+      m_steps.reserve(m_max_steps);
+  }
+
+  /// @brief Record the last (accepted) step of an integrator
+  void record(const SGOde &integrator) noexcept;
+
+  /// @brief Drop all recorded steps
+  void clear() noexcept {
+    m_size = 0;
+    m_head = 0;
+  }
+
+  /// @brief Number of recorded steps
+  int size() const noexcept { return m_size; }
+
+  /// @brief First and last time covered by the recorded steps
+  double tbegin() const noexcept { return at(0).x - at(0).h; }
+  double tend() const noexcept { return at(size() - 1).x; }
+
+  /// @brief Check if t is covered by the recorded steps
+  bool covers(double t) const noexcept {
+    return size() && dir() * (t - tbegin()) >= 0e0 &&
+           dir() * (tend() - t) >= 0e0;
+  }
+
+  /// @brief Evaluate the solution at t (and optionally its derivative)
+  /// @return Anything other than 0 denotes an error (t not covered)
+  int interpolate(double t, Eigen::VectorXd &y,
+                  Eigen::VectorXd *yp = nullptr) const noexcept;
+
+  /// @brief Evaluate the state and state transition matrix at t, assuming
+  ///        the state + variational equations layout used in
+  ///        dso::VariationalEquations, i.e. y = [y, Φ(*,0), ..., Φ(*,5), ...]
+  /// @return Anything other than 0 denotes an error (t not covered)
+  int state_and_stm(double t, Eigen::Matrix<double, 6, 1> &state,
+                    Eigen::Matrix<double, 6, 6> &stm) const noexcept;
+
+private:
+  /// i-th step in (logical) chronological order
+  const Step &at(int i) const noexcept {
+    return m_steps[(m_head + i) % m_steps.size()];
+  }
+  Step &at(int i) noexcept { return m_steps[(m_head + i) % m_steps.size()]; }
+  /// direction of integration
+  double dir() const noexcept { return (at(0).h < 0e0) ? -1e0 : 1e0; }
+  /// index of the (first) step covering t, or -1
+  int find(double t) const noexcept;
+
+  int m_neqn;
+  int m_max_steps;
+  /// number of recorded steps
+  int m_size{0};
+  /// index of the oldest step in m_steps (only != 0 in streaming mode)
+  int m_head{0};
+  /// storage; slots are reused once allocated
+  std::vector<Step> m_steps;
+}; // DenseTrajectory
+
+} // dso
+
+#endif
@@ -0,0 +1,421 @@
+#include "dormand_prince853.hpp"
+#include "events.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <limits>
+
+namespace {
+constexpr const double umach = std::numeric_limits<double>::epsilon();
+constexpr const double fouru = 4e0 * umach;
+
+// maximum number of steps allowed in one call to de
+constexpr const int maxnum = 500;
+
+// step size control: safety factor and limits of step size change
+constexpr const double safe = 0.9e0;
+constexpr const double facmin = 0.333e0;
+constexpr const double facmax = 6e0;
+
+// DOP853 coefficients (Hairer, Nørsett & Wanner), see dop853.f; ns stages
+// per step, nse including the derivative at the end of the step and the
+// extra stages needed for the continuous extension
+constexpr const int ns = 12;
+constexpr const int nse = 16;
+constexpr const double c[nse] = {
+    0e0, 0.526001519587677318785587544488e-01,
+    0.789002279381515978178381316732e-01, 0.118350341907227396726757197510e0,
+    0.281649658092772603273242802490e0, 0.333333333333333333333333333333e0,
+    0.25e0, 0.307692307692307692307692307692e0,
+    0.651282051282051282051282051282e0, 0.6e0,
+    0.857142857142857142857142857142e0, 1e0, 1e0, 0.1e0, 0.2e0,
+    0.777777777777777777777777777778e0};
+// lower triangular part of a(i,j), row-wise; row i has i elements. Row 12
+// holds the 8th order weights (i.e. stage 12 is the derivative at the end
+// of the step), rows 13-15 the extra stages of the continuous extension
+constexpr const double a[nse * (nse - 1) / 2] = {
+    // 1
+    5.26001519587677318785587544488e-2,
+    // 2
+    1.97250569845378994544595329183e-2, 5.91751709536136983633785987549e-2,
+    // 3
+    2.95875854768068491816892993775e-2, 0e0, 8.87627564304205475450678981324e-2,
+    // 4
+    2.41365134159266685502369798665e-1, 0e0,
+    -8.84549479328286085344864962717e-1, 9.24834003261792003115737966543e-1,
+    // 5
+    3.7037037037037037037037037037e-2, 0e0, 0e0,
+    1.70828608729473871279604482173e-1, 1.25467687566822425016691814123e-1,
+    // 6
+    3.7109375e-2, 0e0, 0e0, 1.70252211019544039314978060272e-1,
+    6.02165389804559606850219397283e-2, -1.7578125e-2,
+    // 7
+    3.70920001185047927108779319836e-2, 0e0, 0e0,
+    1.70383925712239993810214054705e-1, 1.07262030446373284651809199168e-1,
+    -1.53194377486244017527936158236e-2, 8.27378916381402288758473766002e-3,
+    // 8
+    6.24110958716075717114429577812e-1, 0e0, 0e0,
+    -3.36089262944694129406857109825e0, -8.68219346841726006818189891453e-1,
+    2.75920996994467083049415600797e1, 2.01540675504778934086186788979e1,
+    -4.34898841810699588477366255144e1,
+    // 9
+    4.77662536438264365890433908527e-1, 0e0, 0e0,
+    -2.48811461997166764192642586468e0, -5.90290826836842996371446475743e-1,
+    2.12300514481811942347288949897e1, 1.52792336328824235832596922938e1,
+    -3.32882109689848629194453265587e1, -2.03312017085086261358222928593e-2,
+    // 10
+    -9.3714243008598732571704021658e-1, 0e0, 0e0,
+    5.18637242884406370830023853209e0, 1.09143734899672957818500254654e0,
+    -8.14978701074692612513997267357e0, -1.85200656599969598641566180701e1,
+    2.27394870993505042818970056734e1, 2.49360555267965238987089396762e0,
+    -3.0467644718982195003823669022e0,
+    // 11
+    2.27331014751653820792359768449e0, 0e0, 0e0,
+    -1.05344954667372501984066689879e1, -2.00087205822486249909675718444e0,
+    -1.79589318631187989172765950534e1, 2.79488845294199600508499808837e1,
+    -2.85899827713502369474065508674e0, -8.87285693353062954433549289258e0,
+    1.23605671757943030647266201528e1, 6.43392746015763530355970484046e-1,
+    // 12
+    5.42937341165687622380535766363e-2, 0e0, 0e0, 0e0, 0e0,
+    4.45031289275240888144113950566e0, 1.89151789931450038304281599044e0,
+    -5.8012039600105847814672114227e0, 3.1116436695781989440891606237e-1,
+    -1.52160949662516078556178806805e-1, 2.01365400804030348374776537501e-1,
+    4.47106157277725905176885569043e-2,
+    // 13
+    5.61675022830479523392909219681e-2, 0e0, 0e0, 0e0, 0e0, 0e0,
+    2.53500210216624811088794765333e-1, -2.46239037470802489917441475441e-1,
+    -1.24191423263816360469010140626e-1, 1.5329179827876569731206322685e-1,
+    8.20105229563468988491666602057e-3, 7.56789766054569976138603589584e-3,
+    -8.298e-3,
+    // 14
+    3.18346481635021405060768473261e-2, 0e0, 0e0, 0e0, 0e0,
+    2.83009096723667755288322961402e-2, 5.35419883074385676223797384372e-2,
+    -5.49237485713909884646569340306e-2, 0e0, 0e0,
+    -1.08347328697249322858509316994e-4, 3.82571090835658412954920192323e-4,
+    -3.40465008687404560802977114492e-4, 1.41312443674632500278074618366e-1,
+    // 15
+    -4.28896301583791923408573538692e-1, 0e0, 0e0, 0e0, 0e0,
+    -4.69762141536116384314449447206e0, 7.68342119606259904184240953878e0,
+    4.06898981839711007970213554331e0, 3.56727187455281109270669543021e-1, 0e0,
+    0e0, 0e0, -1.39902416515901462129418009734e-3,
+    2.9475147891527723389556272149e0, -9.15095847217987001081870187138e0};
+// 8th order weights (row 12 of a)
+constexpr const double *b = a + ns * (ns - 1) / 2;
+// differences of the 8th and the embedded 5th order weights
+constexpr const double e5[ns] = {
+    0.1312004499419488073250102996e-1, 0e0, 0e0, 0e0, 0e0,
+    -0.1225156446376204440720569753e+1, -0.4957589496572501915214079952e0,
+    0.1664377182454986536961530415e+1, -0.3503288487499736816886487290e0,
+    0.3341791187130174790297318841e0, 0.8192320648511571246570742613e-1,
+    -0.2235530786388629525884427845e-1};
+// embedded 3rd order weights
+constexpr const double bh3[ns] = {
+    0.244094488188976377952755905512e0, 0e0, 0e0, 0e0, 0e0, 0e0, 0e0, 0e0,
+    0.733846688281611857341361741547e0, 0e0, 0e0,
+    0.220588235294117647058823529412e-1};
+// coefficients of the (4 highest order) terms of the continuous extension
+constexpr const double d[4][nse] = {
+    {-0.84289382761090128651353491142e+1, 0e0, 0e0, 0e0, 0e0,
+     0.56671495351937776962531783590e0, -0.30689499459498916912797304727e+1,
+     0.23846676565120698287728149680e+1, 0.21170345824450282767155149946e+1,
+     -0.87139158377797299206789907490e0, 0.22404374302607882758541771650e+1,
+     0.63157877876946881815570249290e0, -0.88990336451333310820698117400e-1,
+     0.18148505520854727256656404962e+2, -0.91946323924783554000451984436e+1,
+     -0.44360363875948939664310572000e+1},
+    {0.10427508642579134603413151009e+2, 0e0, 0e0, 0e0, 0e0,
+     0.24228349177525818288430175319e+3, 0.16520045171727028198505394887e+3,
+     -0.37454675472269020279518312152e+3, -0.22113666853125306036270938578e+2,
+     0.77334326684722638389603898808e+1, -0.30674084731089398182061213626e+2,
+     -0.93321305264302278729567221706e+1, 0.15697238121770843886131091075e+2,
+     -0.31139403219565177677282850411e+2, -0.93529243588444783865713862664e+1,
+     0.35816841486394083752465898540e+2},
+    {0.19985053242002433820987653617e+2, 0e0, 0e0, 0e0, 0e0,
+     -0.38703730874935176555105901742e+3, -0.18917813819516756882830838328e+3,
+     0.52780815920542364900561016686e+3, -0.11573902539959630126141871134e+2,
+     0.68812326946963000169666922661e+1, -0.10006050966910838403183860980e+1,
+     0.77771377980534432092869265740e0, -0.27782057523535084065932004339e+1,
+     -0.60196695231264120758267380846e+2, 0.84320405506677161018159903784e+2,
+     0.11992291136182789328035130030e+2},
+    {-0.25693933462703749003312586129e+2, 0e0, 0e0, 0e0, 0e0,
+     -0.15418974869023643374053993627e+3, -0.23152937917604549567536039109e+3,
+     0.35763911791061412378285349910e+3, 0.93405324183624310003907691704e+2,
+     -0.37458323136451633156875139351e+2, 0.10409964950896230045147246184e+3,
+     0.29840293426660503123344363579e+2, -0.43533456590011143754432175058e+2,
+     0.96324553959188282948394950600e+2, -0.39177261675615439165231486172e+2,
+     -0.14972683625798562581422125276e+3}};
+} // unnamed namespace
+
+dso::DormandPrince853::DormandPrince853(
+    ODEfun _f, int _neqn, double rerr, double aerr,
+    dso::IntegrationParameters *_params) noexcept
+    : f(_f), neqn(_neqn), iflag(1), relerr(rerr), abserr(aerr), x(0e0),
+      h(0e0), xold(0e0), hold(0e0), params(_params) {
+  y = Eigen::VectorXd(neqn);
+  yp = Eigen::VectorXd(neqn);
+  yold = Eigen::VectorXd(neqn);
+  ypold = Eigen::VectorXd(neqn);
+  Kd = Eigen::MatrixXd(neqn, nse);
+  F = Eigen::MatrixXd(neqn, 7);
+  K = Eigen::MatrixXd(neqn, nse);
+  ytmp = Eigen::VectorXd(neqn);
+  ynew = Eigen::VectorXd(neqn);
+  yerr = Eigen::VectorXd(neqn);
+  yerr3 = Eigen::VectorXd(neqn);
+}
+
+double dso::DormandPrince853::step(double xs, const Eigen::VectorXd &ys,
+                                  double hs, Eigen::MatrixXd &Ks,
+                                  Eigen::VectorXd &yn) noexcept {
+  // stages (first one already in Ks.col(0))
+  const double *aij = a;
+  for (int i = 1; i < ns; i++) {
+    ytmp = ys;
+    for (int j = 0; j < i; j++, ++aij)
+      if (*aij != 0e0)
+        ytmp += (hs * *aij) * Ks.col(j);
+    f(xs + c[i] * hs, ytmp, Ks.col(i), *params);
+  }
+  stats.nfev += ns - 1;
+
+  // 8th order solution and (8th - 5th), (8th - 3rd) differences
+  yn = ys;
+  yerr.setZero();
+  yerr3.setZero();
+  for (int i = 0; i < ns; i++) {
+    if (b[i] != 0e0)
+      yn += (hs * b[i]) * Ks.col(i);
+    if (e5[i] != 0e0)
+      yerr += e5[i] * Ks.col(i);
+    if (b[i] != bh3[i])
+      yerr3 += (b[i] - bh3[i]) * Ks.col(i);
+  }
+
+  // scaled error; the 5th order estimate, corrected by the 3rd order one
+  // (see Hairer, Nørsett, Wanner, Solving ODEs I, ch. II.10). Note that
+  // the (weighted) 2-norm is used, not the RMS norm of dop853.f, so that
+  // tolerances have the same meaning as in dso::SGOde
+  double err5 = 0e0, err3 = 0e0;
+  for (int i = 0; i < neqn; i++) {
+    const double sc =
+        abserr + relerr * std::max(std::abs(ys(i)), std::abs(yn(i)));
+    err5 += (yerr(i) / sc) * (yerr(i) / sc);
+    err3 += (yerr3(i) / sc) * (yerr3(i) / sc);
+  }
+  const double den = err5 + 1e-2 * err3;
+  return (den > 0e0) ? std::abs(hs) * err5 / std::sqrt(den) : 0e0;
+}
+
+double dso::DormandPrince853::initial_step(double tout) noexcept {
+  // see Hairer, Nørsett, Wanner, Solving ODEs I, ch. II.4; note that yp
+  // holds f(x,y)
+  double d0 = 0e0, d1 = 0e0;
+  for (int i = 0; i < neqn; i++) {
+    const double sc = abserr + relerr * std::abs(y(i));
+    d0 = std::max(d0, std::abs(y(i)) / sc);
+    d1 = std::max(d1, std::abs(yp(i)) / sc);
+  }
+  double h0 = (d0 < 1e-5 || d1 < 1e-5) ? 1e-6 : 1e-2 * (d0 / d1);
+  h0 = std::min(h0, std::abs(tout - x));
+  const double dir = (tout > x) ? 1e0 : -1e0;
+
+  // explicit Euler step and derivative there
+  ytmp = y + (dir * h0) * yp;
+  f(x + dir * h0, ytmp, K.col(1), *params);
+  ++stats.nfev;
+  double d2 = 0e0;
+  for (int i = 0; i < neqn; i++) {
+    const double sc = abserr + relerr * std::abs(y(i));
+    d2 = std::max(d2, std::abs(K(i, 1) - yp(i)) / sc);
+  }
+  d2 /= h0;
+
+  const double dm = std::max(d1, d2);
+  const double h1 = (dm <= 1e-15) ? std::max(1e-6, h0 * 1e-3)
+                                  : std::pow(1e-2 / dm, 1e0 / 8e0);
+  return dir * std::min(1e2 * h0, h1);
+}
+
+int dso::DormandPrince853::dense(double t, Eigen::VectorXd &yout) noexcept {
+  if (!has_step) {
+    fprintf(stderr,
+            "[ERROR] No step available for continuous extension (traceback: "
+            "%s)\n",
+            __func__);
+    return 1;
+  }
+
+  if (!has_dense) {
+    // extra stages (Kd holds the stages of the last step, including the
+    // derivative at its end)
+    const double *aij = a + ns * (ns + 1) / 2;
+    for (int i = ns + 1; i < nse; i++) {
+      ytmp = yold;
+      for (int j = 0; j < i; j++, ++aij)
+        if (*aij != 0e0)
+          ytmp += (hold * *aij) * Kd.col(j);
+      f(xold + c[i] * hold, ytmp, Kd.col(i), *params);
+    }
+    stats.nfev += nse - ns - 1;
+
+    // coefficients of the interpolant
+    F.col(0) = y - yold;
+    F.col(1) = hold * ypold - F.col(0);
+    F.col(2) = 2e0 * F.col(0) - hold * (yp + ypold);
+    for (int k = 0; k < 4; k++) {
+      F.col(3 + k).setZero();
+      for (int j = 0; j < nse; j++)
+        if (d[k][j] != 0e0)
+          F.col(3 + k) += (hold * d[k][j]) * Kd.col(j);
+    }
+    has_dense = true;
+  }
+
+  // y(θ) = yold + θ (F0 + (1-θ) (F1 + θ (F2 + (1-θ) (F3 + θ (F4 + (1-θ)
+  //        (F5 + θ F6))))))
+  const double theta = (t - xold) / hold;
+  const double theta1 = 1e0 - theta;
+  yout = F.col(6);
+  for (int k = 5; k >= 0; k--)
+    yout = F.col(k) + ((k % 2) ? theta : theta1) * yout;
+  yout = yold + theta * yout;
+
+  return 0;
+}
+
+int dso::DormandPrince853::de(double &t, double tout, const Eigen::VectorXd &y0,
+                             Eigen::VectorXd &yout) noexcept {
+  // test for improper parameters
+  if (t == tout || relerr < 0e0 || abserr < 0e0 ||
+      (relerr == 0e0 && abserr == 0e0) || !iflag || std::abs(iflag) > 5) {
+    iflag = 6;
+    fprintf(stderr, "[ERROR] Invalid parameters to %s\n", __func__);
+    return 1;
+  }
+
+  // negative flag: do not step past tout
+  const int isn = (iflag < 0) ? -1 : 1;
+  iflag = std::abs(iflag);
+
+  // start (or restart on change of direction)
+  const double del = tout - t;
+  if (iflag == 1 || h * del <= 0e0) {
+    x = t;
+    y = y0;
+    f(x, y, yp, *params);
+    ++stats.nfev;
+    h = initial_step(tout);
+    ++stats.nstarts;
+    has_step = false;
+    has_dense = false;
+    // event functions at the start point
+    stop_pending = false;
+    if (events)
+      events->reset(x, y);
+  }
+
+  // not to step past tout, but the last step (of a previous call) did:
+  // redo it, up to tout, instead of interpolating (unless a terminal event
+  // comes first)
+  if (isn < 0 && has_step && (tout - xold) * (x - tout) > 0e0 &&
+      !(stop_pending && (tout - tstop) * del >= 0e0)) {
+    x = xold;
+    y = yold;
+    yp = ypold;
+    has_step = false;
+    has_dense = false;
+    stop_pending = false;
+    if (events)
+      events->rewind(x, y);
+  }
+
+  // do not go too far past the output point (or not past it at all)
+  const double tend = (isn < 0) ? tout : t + 10e0 * del;
+  int nostep = 0;
+
+  while (true) {
+    // terminal event (within the last step) reached before the output point?
+    if (stop_pending && (tout - tstop) * del >= 0e0) {
+      stop_pending = false;
+      dense(tstop, yout);
+      t = tstop;
+      iflag = isn * 2;
+      return 0;
+    }
+
+    // output point reached?
+    if (x == tout) {
+      yout = y;
+      t = tout;
+      iflag = isn * 2;
+      return 0;
+    }
+    if (has_step && (tout - xold) * (x - tout) >= 0e0) {
+      dense(tout, yout);
+      t = tout;
+      iflag = isn * 2;
+      return 0;
+    }
+
+    // test too many steps
+    if (nostep >= maxnum) {
+      iflag = isn * 4;
+      yout = y;
+      t = x;
+      return 1;
+    }
+
+    // limit step size; if the end point is (almost) within reach, hit it
+    // exactly, instead of leaving a tiny last step
+    h = std::copysign(std::min(std::abs(h), std::abs(tend - x)), h);
+    bool last = isn < 0 && std::abs(tend - x) <= 1.01e0 * std::abs(h);
+    if (last)
+      h = tend - x;
+
+    // try steps until one is accepted
+    K.col(0) = yp;
+    double fmax = facmax;
+    while (true) {
+      if (std::abs(h) < fouru * std::abs(x)) {
+        iflag = isn * 3;
+        yout = y;
+        t = x;
+        return 1;
+      }
+      const double err = step(x, y, h, K, ynew);
+      const double fac =
+          (err > 0e0) ? safe * std::pow(err, -1e0 / 8e0) : facmax;
+      if (err <= 1e0) {
+        // accept; keep the stages for the continuous extension
+        xold = x;
+        hold = h;
+        yold = y;
+        ypold = yp;
+        x = last ? tend : x + h;
+        y = ynew;
+        f(x, y, yp, *params);
+        ++stats.nfev;
+        K.col(ns) = yp;
+        K.swap(Kd);
+        has_step = true;
+        has_dense = false;
+        stats.accepted(x, hold, 8, err);
+        h *= std::min(fmax, std::max(facmin, fac));
+        // look for events within the step (on the continuous extension)
+        if (events)
+          stop_pending = events->check(
+              x, y,
+              [this](double ti, Eigen::VectorXd &yi) { dense(ti, yi); },
+              tstop);
+        break;
+      }
+      // reject; do not increase the step size right after a rejection
+      ++stats.nreject;
+      fmax = 1e0;
+      h *= std::max(facmin, fac);
+      last = false;
+    }
+    ++nostep;
+  }
+
+  return 100;
+}
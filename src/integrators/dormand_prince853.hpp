@@ -0,0 +1,137 @@
+#ifndef __DSO_DORMAND_PRINCE_853_ODE_HPP__
+#define __DSO_DORMAND_PRINCE_853_ODE_HPP__
+
+#include "integrator_stats.hpp"
+#include "odefun.hpp"
+#include "orbit_integration.hpp"
+
+namespace dso {
+
+class EventDetector;
+
+/// @brief Explicit Runge-Kutta integrator of order 8 (Dormand & Prince),
+///        with adaptive step size control and continuous extension (aka
+///        DOP853).
+///
+/// Coefficients, error control and continuous extension are the ones of
+/// DOP853, see Hairer E., Nørsett S. P., Wanner G., Solving Ordinary
+/// Differential Equations I, 2nd ed., Springer (1993), ch. II.5 and II.10.
+/// The 8th order solution is propagated, while the embedded 5th and 3rd
+/// order ones are used for error control. Each step costs 12 evaluations of
+/// the right-hand side: 11 stages, plus the derivative at the end of the
+/// step (which is reused as the first stage of the next one); rejected
+/// steps cost 11.
+///
+/// Being a one-step method, no start-up is needed, hence it is well suited
+/// for arcs with frequent restarts (manoeuvres, filter resets, ...).
+///
+/// The interface is the same as dso::SGOde. Tolerances are applied on the
+/// (weighted) 2-norm of the error estimate, as in dso::SGOde. The
+/// integrator may step past the output point tout (unless told not to);
+/// the solution at tout is then computed via the continuous extension, a
+/// 7th order interpolant which needs 3 extra evaluations of the right-hand
+/// side. These are only performed if an output (or event location) is
+/// actually requested within the step.
+class DormandPrince853 {
+public:
+  /// @brief Constructor
+  /// @param[in] _f Right-hand side
+  /// @param[in] _neqn Number of equations
+  /// @param[in] rerr Relative error tolerance
+  /// @param[in] aerr Absolute error tolerance
+  /// @param[in] _params Parameters passed in to the right-hand side
+  DormandPrince853(ODEfun _f, int _neqn, double rerr, double aerr,
+                   dso::IntegrationParameters *_params = nullptr) noexcept;
+
+  int flag() const noexcept { return iflag; }
+  int &flag() noexcept { return iflag; }
+
+  /// @brief Integrate from t to tout.
+  ///
+  /// Same interface and flags as SGOde::de: on the first call (flag() = 1)
+  /// the integrator is started at (t, y0); on subsequent calls (flag() = 2)
+  /// integration continues from its internal state and y0 is not used.
+  /// A negative flag (-1 or -2) means that the integrator should not step
+  /// past tout; the last step then ends exactly at tout and the solution
+  /// there is not interpolated. Use it for output points at which the
+  /// integration is to be restarted (manoeuvres, filter resets, ...): the
+  /// continuous extension is less accurate than the step solution, and
+  /// restarting off of interpolated states accumulates that error. The
+  /// sign of the flag is kept on return.
+  /// On return:
+  /// flag() = 2 success; t is set to tout and yout holds the solution at
+  ///            tout
+  /// flag() = 3 step size became too small (tolerances too small)
+  /// flag() = 4 too many steps needed to reach tout
+  /// flag() = 6 invalid input parameters
+  /// In case of error, t and yout are set to the last point reached.
+  int de(double &t, double tout, const Eigen::VectorXd &y0,
+         Eigen::VectorXd &yout) noexcept;
+
+  /// @brief Evaluate the continuous extension of the last step at t
+  ///        (which should lie within the last step)
+  int dense(double t, Eigen::VectorXd &yout) noexcept;
+
+  /// @brief Number of right-hand side evaluations so far
+  long num_fevals() const noexcept { return stats.nfev; }
+
+  /// @brief Number of accepted and rejected steps so far
+  long num_accepted() const noexcept { return stats.naccept; }
+  long num_rejected() const noexcept { return stats.nreject; }
+
+private:
+  /// an (attempted) step of size hs from (xs, ys), with f(xs,ys) in
+  /// Ks.col(0); result stored in yn, returns the (scaled) error estimate
+  double step(double xs, const Eigen::VectorXd &ys, double hs,
+              Eigen::MatrixXd &Ks, Eigen::VectorXd &yn) noexcept;
+  /// initial step size guess (Hairer, Nørsett, Wanner, II.4)
+  double initial_step(double tout) noexcept;
+
+  ODEfun f;
+  int neqn;
+  int iflag;
+  double relerr, abserr;
+  /// current (internal) point and solution, derivative at (x, y)
+  double x;
+  Eigen::VectorXd y, yp;
+  /// step size to try next
+  double h;
+  /// last accepted step: start point, size, solution and derivative at
+  /// start (end values are x, y and yp)
+  bool has_step{false};
+  double xold, hold;
+  Eigen::VectorXd yold, ypold;
+  /// stages of the last accepted step (the derivative at its end included)
+  /// and, if computed, the extra stages of the continuous extension
+  Eigen::MatrixXd Kd;
+  /// coefficients of the continuous extension (if computed)
+  bool has_dense{false};
+  Eigen::MatrixXd F;
+  /// stages
+  Eigen::MatrixXd K;
+  /// work space: stage argument, new solution and (5th, 3rd order) error
+  /// estimates
+  Eigen::VectorXd ytmp, ynew, yerr, yerr3;
+
+public:
+  /// May store a pointer to some king of parameters that are passed in the
+  /// ODE function
+  dso::IntegrationParameters *params{nullptr};
+  /// If not null, event functions are evaluated (and crossings located, on
+  /// the continuous extension) at every accepted step; the integration stops
+  /// at terminal events, see dso::EventDetector
+  dso::EventDetector *events{nullptr};
+  /// Statistics (evaluations, steps, restarts) and optional step trace; the
+  /// order reported is always 8
+  dso::IntegratorStats stats;
+
+private:
+  /// a terminal event was located in the last step, at tstop, but not yet
+  /// reached (output point before the event)
+  bool stop_pending{false};
+  double tstop;
+}; // DormandPrince853
+
+} // dso
+
+#endif
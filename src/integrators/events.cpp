@@ -0,0 +1,63 @@
+#include "events.hpp"
+#include "astrodynamics.hpp"
+#include "geodesy/geodesy.hpp"
+#include <cmath>
+
+void dso::EventDetector::reset(double t, const Eigen::VectorXd &y) noexcept {
+  m_tlast = t;
+  m_y = y;
+  for (int i = 0; i < size(); i++)
+    m_glast[i] = m_events[i].g(t, y);
+}
+
+void dso::EventDetector::rewind(double t, const Eigen::VectorXd &y) noexcept {
+  const double dir = m_tlast - t;
+  m_occurrences.erase(std::remove_if(m_occurrences.begin(),
+                                     m_occurrences.end(),
+                                     [=](const dso::EventOccurrence &o) {
+                                       return (o.t - t) * dir > 0e0;
+                                     }),
+                      m_occurrences.end());
+  reset(t, y);
+}
+
+dso::Event dso::shadow_event(dso::IntegrationParameters &params,
+                             int id) noexcept {
+  dso::Event event;
+  event.id = id;
+  event.g = [&params](double tsec, const Eigen::VectorXd &y) -> double {
+    const double cmjd = params.mjd_tai + tsec / dso::sec_per_day;
+    const dso::ForceModelTimeCache &tc = dso::update_time_cache(cmjd, params);
+    const dso::Vector3 r({y(0), y(1), y(2)});
+    const dso::Vector3 rsun({tc.rsun(0), tc.rsun(1), tc.rsun(2)});
+    return utest::conical_shadow(r, rsun) - .5e0;
+  };
+  return event;
+}
+
+dso::Event
+dso::beacon_elevation_event(dso::IntegrationParameters &params,
+                            const Eigen::Matrix<double, 3, 1> &beacon,
+                            double cut_off, int id) noexcept {
+  // ellipsoidal normal at the beacon
+  const Eigen::Matrix<double, 3, 1> lfh =
+      dso::car2ell<dso::ellipsoid::grs80>(beacon);
+  const double clat = std::cos(lfh(1));
+  Eigen::Matrix<double, 3, 1> up;
+  up << clat * std::cos(lfh(0)), clat * std::sin(lfh(0)), std::sin(lfh(1));
+  const double sin_cut_off = std::sin(cut_off);
+
+  dso::Event event;
+  event.id = id;
+  event.g = [&params, beacon, up,
+             sin_cut_off](double tsec, const Eigen::VectorXd &y) -> double {
+    const double cmjd = params.mjd_tai + tsec / dso::sec_per_day;
+    const dso::ForceModelTimeCache &tc = dso::update_time_cache(cmjd, params);
+    const Eigen::Matrix<double, 3, 1> r =
+        dso::rcel2ter(y.head<3>(), tc.rc2i, tc.era_at(cmjd), tc.rpom);
+    // beacon-to-satellite unit vector
+    const Eigen::Matrix<double, 3, 1> rho = (r - beacon).normalized();
+    return rho.dot(up) - sin_cut_off;
+  };
+  return event;
+}
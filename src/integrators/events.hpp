@@ -0,0 +1,254 @@
+#ifndef __DSO_INTEGRATOR_EVENTS_HPP__
+#define __DSO_INTEGRATOR_EVENTS_HPP__
+
+#include "eigen3/Eigen/Eigen"
+#include "orbit_integration.hpp"
+#include <algorithm>
+#include <functional>
+#include <vector>
+
+namespace dso {
+
+/// @brief An event, i.e. a (signed) function g(t, y) of the independent
+///        variable and the solution; the event occurs at the zero crossings
+///        of g.
+///
+/// Event functions should be continuous (at least across the crossings);
+/// e.g. for a shadow model, use a (signed) distance to the shadow boundary
+/// and not a 0/1 illumination flag.
+struct Event {
+  /// Which zero crossings to report
+  enum class Direction : char {
+    /// any crossing
+    Any,
+    /// g goes from negative to positive
+    Rising,
+    /// g goes from positive to negative
+    Falling
+  };
+
+  /// the event function, g(t, y)
+  std::function<double(double, const Eigen::VectorXd &)> g;
+  /// which crossings to report
+  Direction direction{Direction::Any};
+  /// if true, the integration stops at the (first) crossing
+  bool terminal{false};
+  /// user-defined identifier, reported back in dso::EventOccurrence
+  int id{0};
+}; // Event
+
+/// @brief A located event
+struct EventOccurrence {
+  /// id of the event (see Event::id)
+  int id;
+  /// time of the crossing
+  double t;
+  /// +1 for a rising crossing, -1 for a falling one
+  int direction;
+  /// solution at t
+  Eigen::VectorXd y;
+}; // EventOccurrence
+
+/// @brief Event detection and location for the integrators (see
+///        SGOde::events and DormandPrince853::events).
+///
+/// After every accepted step, the event functions are evaluated at the end
+/// of the step and compared with their values at the start of the step. On
+/// a sign change, the crossing is located (to within tol) by root finding on
+/// the integrator's interpolating polynomial (dense output), i.e. without
+/// any further steps or right-hand side evaluations.
+/// Note that only sign changes between step ends are detected; two
+/// crossings within one step (i.e. an event shorter than a step) are missed.
+///
+/// Terminal events make the integrator return at the event time, with
+/// flag() = 2; to handle a discontinuity of the right-hand side at the event
+/// (e.g. a user-supplied force model term switched on/off at shadow
+/// entry/exit; note that dso::VariationalEquations has no such term), update
+/// the model and restart the integrator there (flag() = 1), so that no step
+/// straddles the discontinuity.
+class EventDetector {
+public:
+  /// @brief Constructor
+  /// @param[in] _tol Tolerance for the location of crossings (independent
+  ///            variable units, e.g. [sec])
+  explicit EventDetector(double _tol = 1e-6) noexcept : tol(_tol) {}
+
+  /// @brief Add an event; returns its index
+  int add(const Event &event) noexcept {
+    m_events.push_back(event);
+    m_glast.push_back(0e0);
+    return m_events.size() - 1;
+  }
+
+  /// @brief Number of events
+  int size() const noexcept { return m_events.size(); }
+
+  /// @brief (Re-)set the start point; called by the integrator on start and
+  ///        restart
+  void reset(double t, const Eigen::VectorXd &y) noexcept;
+
+  /// @brief Back up to t, the start of the last (checked) step, which the
+  ///        integrator is about to redo: re-set the start point and drop the
+  ///        crossings located past t
+  void rewind(double t, const Eigen::VectorXd &y) noexcept;
+
+  /// @brief Check the step [tlast, t] for crossings.
+  ///
+  /// @param[in] t End of the (accepted) step
+  /// @param[in] y Solution at t
+  /// @param[in] interp Interpolating polynomial of the step, called as
+  ///            interp(tk, yk) to evaluate yk = y(tk), for tk within the step
+  /// @param[out] tstop If a terminal event occurs, the time of the (first)
+  ///            terminal crossing
+  /// @return true if a terminal event occurs within the step; crossings
+  ///         past tstop are then dropped and the next check starts at tstop
+  template <typename Interpolant>
+  bool check(double t, const Eigen::VectorXd &y, Interpolant &&interp,
+             double &tstop) noexcept;
+
+  /// @brief Located events so far (in chronological order within each step)
+  const std::vector<EventOccurrence> &occurrences() const noexcept {
+    return m_occurrences;
+  }
+
+  /// @brief Drop the located events
+  void clear() noexcept { m_occurrences.clear(); }
+
+  /// Tolerance for the location of crossings
+  double tol;
+
+private:
+  /// locate the root of event i in [ta, tb], with g values ga, gb of
+  /// opposite sign (Illinois variant of regula falsi); the result is within
+  /// tol of the root, on the side of tb
+  template <typename Interpolant>
+  double locate(int i, double ta, double ga, double tb, double gb,
+                Interpolant &&interp) noexcept;
+
+  std::vector<Event> m_events;
+  std::vector<EventOccurrence> m_occurrences;
+  /// time and event function values at the start of the current step
+  double m_tlast{0e0};
+  std::vector<double> m_glast;
+  /// work space
+  Eigen::VectorXd m_y;
+}; // EventDetector
+
+/// @brief Shadow (eclipse) event, using the conical shadow model of
+///        utest::conical_shadow.
+///
+/// The event function is the illuminated fraction of the Sun's disk minus
+/// 1/2; it is continuous (it varies across the penumbra) and negative in
+/// shadow, hence the event is located at the middle of the penumbra, entry
+/// being a Falling crossing and exit a Rising one. The first three elements
+/// of y should be the satellite position in the celestial (inertial) frame
+/// [m] and t should be seconds since params.mjd_tai (as in
+/// dso::VariationalEquations). The Sun position is taken off of the force
+/// model's time cache (see dso::update_time_cache), hence the same
+/// ephemeris tier as the force model is used.
+Event shadow_event(dso::IntegrationParameters &params, int id = 0) noexcept;
+
+/// @brief Beacon elevation event; the event function is
+///        sin(elevation) - sin(cut_off), hence rise is a Rising crossing and
+///        set a Falling one.
+///
+/// The first three elements of y should be the satellite position in the
+/// celestial (inertial) frame [m] and t should be seconds since
+/// params.mjd_tai (as in dso::VariationalEquations). The elevation is
+/// w.r.t. the ellipsoidal (GRS80) normal at the beacon. The celestial to
+/// terrestrial transformation is taken off of the force model's time cache
+/// (see dso::update_time_cache), hence it is tabulated/cached the same way
+/// as for the force model (e.g. via params.c2t_table).
+/// @param[in] params Integration parameters (reference epoch and force
+///            model time cache)
+/// @param[in] beacon Beacon position, Earth-fixed (ITRS) [m]
+/// @param[in] cut_off Elevation cut-off angle [rad]
+Event beacon_elevation_event(dso::IntegrationParameters &params,
+                             const Eigen::Matrix<double, 3, 1> &beacon,
+                             double cut_off, int id = 0) noexcept;
+
+} // dso
+
+template <typename Interpolant>
+double dso::EventDetector::locate(int i, double ta, double ga, double tb,
+                                  double gb, Interpolant &&interp) noexcept {
+  constexpr const int max_iter = 100;
+  int side = 0;
+  double tc = tb;
+  for (int it = 0; it < max_iter && std::abs(tb - ta) > tol; it++) {
+    tc = (ta * gb - tb * ga) / (gb - ga);
+    interp(tc, m_y);
+    const double gc = m_events[i].g(tc, m_y);
+    if (gc == 0e0)
+      return tc;
+    if ((gc > 0e0) == (gb > 0e0)) {
+      tb = tc;
+      gb = gc;
+      // retained the same end point twice; halve its value (Illinois)
+      if (side == -1)
+        ga /= 2e0;
+      side = -1;
+    } else {
+      ta = tc;
+      ga = gc;
+      if (side == +1)
+        gb /= 2e0;
+      side = +1;
+    }
+  }
+  // the end of the bracket past the crossing, so that (re)starting from
+  // there does not detect the same crossing again
+  return tb;
+}
+
+template <typename Interpolant>
+bool dso::EventDetector::check(double t, const Eigen::VectorXd &y,
+                               Interpolant &&interp, double &tstop) noexcept {
+  const double dir = (t < m_tlast) ? -1e0 : 1e0;
+  const int first = m_occurrences.size();
+  int stop = -1;
+
+  for (int i = 0; i < size(); i++) {
+    const double ga = m_glast[i];
+    const double gb = m_events[i].g(t, y);
+    m_glast[i] = gb;
+    // a sign change (a zero at the start of the step is not reported again)
+    if (ga == 0e0 || (ga > 0e0) == (gb > 0e0))
+      continue;
+    const int crossing = (gb > ga) ? 1 : -1;
+    if ((m_events[i].direction == Event::Direction::Rising && crossing < 0) ||
+        (m_events[i].direction == Event::Direction::Falling && crossing > 0))
+      continue;
+    const double tc = locate(i, m_tlast, ga, t, gb, interp);
+    interp(tc, m_y);
+    m_occurrences.push_back(EventOccurrence{m_events[i].id, tc, crossing, m_y});
+    if (m_events[i].terminal && (stop < 0 || dir * (tc - tstop) < 0e0)) {
+      tstop = tc;
+      stop = i;
+    }
+  }
+
+  // keep the occurrences of this step in chronological order
+  std::sort(m_occurrences.begin() + first, m_occurrences.end(),
+            [dir](const EventOccurrence &a, const EventOccurrence &b) {
+              return dir * (a.t - b.t) < 0e0;
+            });
+
+  if (stop < 0) {
+    m_tlast = t;
+    return false;
+  }
+
+  // terminal event; drop anything past it and restart from there
+  while ((int)m_occurrences.size() > first &&
+         dir * (m_occurrences.back().t - tstop) > 0e0)
+    m_occurrences.pop_back();
+  interp(tstop, m_y);
+  for (int i = 0; i < size(); i++)
+    m_glast[i] = m_events[i].g(tstop, m_y);
+  m_glast[stop] = 0e0;
+  m_tlast = tstop;
+  return true;
+}
+
+#endif
@@ -0,0 +1,310 @@
+#include "gauss_jackson.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#ifdef DEBUG
+#include <cassert>
+#endif
+
+namespace {
+/// binomial coefficient C(n,k), as double
+double binomial(int n, int k) noexcept {
+  double c = 1e0;
+  for (int i = 1; i <= k; i++)
+    c = c * (n - k + i) / i;
+  return c;
+}
+
+/// @brief Backward difference coefficients of the Adams and Störmer/Cowell
+///        formulae, computed from their generating functions, see e.g.
+///        Hairer, Nørsett, Wanner, Solving ODEs I, ch. III.1 and III.10.
+///        With L(t) = -ln(1-t)/t = Σ t^k/(k+1):
+///        Adams-Moulton    γ*(t) = 1/L(t)
+///        Adams-Bashforth  γ(t)  = γ*(t)/(1-t)
+///        Cowell           σ*(t) = 1/L(t)^2
+///        Störmer          σ(t)  = σ*(t)/(1-t)
+void difference_coefficients(int n, double *gamma, double *gammas,
+                             double *sigma, double *sigmas) noexcept {
+  // 1/L(t)
+  gammas[0] = 1e0;
+  for (int k = 1; k < n; k++) {
+    double c = 0e0;
+    for (int i = 1; i <= k; i++)
+      c -= gammas[k - i] / (i + 1);
+    gammas[k] = c;
+  }
+  // 1/L(t)^2
+  for (int k = 0; k < n; k++) {
+    double c = 0e0;
+    for (int i = 0; i <= k; i++)
+      c += gammas[i] * gammas[k - i];
+    sigmas[k] = c;
+  }
+  // multiply by 1/(1-t), aka cumulative sums
+  gamma[0] = gammas[0];
+  sigma[0] = sigmas[0];
+  for (int k = 1; k < n; k++) {
+    gamma[k] = gamma[k - 1] + gammas[k];
+    sigma[k] = sigma[k - 1] + sigmas[k];
+  }
+}
+} // unnamed namespace
+
+dso::GaussJackson::GaussJackson(ODEfun _f, int _neqn, double step,
+                                dso::IntegrationParameters *_params,
+                                int _order, int _nsub) noexcept
+    : f(_f), neqn(_neqn), order(_order), nsub(_nsub), iflag(1),
+      nblocks(_neqn / 6), h(std::abs(step)), tn(0e0), params(_params) {
+#ifdef DEBUG
+  assert(!(neqn % 6));
+  assert(order > 0);
+#endif
+  // backward difference coefficients, up to ∇^(order+2)
+  const int n = order + 3;
+  double *mem = new double[4 * n];
+  double *gamma = mem;
+  double *gammas = mem + n;
+  double *sigma = mem + 2 * n;
+  double *sigmas = mem + 3 * n;
+  difference_coefficients(n, gamma, gammas, sigma, sigmas);
+
+  // transform to ordinate form, for the back-values f_n, ..., f_{n-order};
+  // position: Σ_{j=2}^{order+2} σ_j ∇^(j-2) f_n
+  // velocity: Σ_{j=1}^{order+1} γ_j ∇^(j-1) f_n
+  // where ∇^k f_n = Σ_i (-1)^i C(k,i) f_{n-i}
+  ap = Eigen::VectorXd::Zero(order + 1);
+  ac = Eigen::VectorXd::Zero(order + 1);
+  bp = Eigen::VectorXd::Zero(order + 1);
+  bc = Eigen::VectorXd::Zero(order + 1);
+  for (int k = 0; k <= order; k++) {
+    for (int i = 0; i <= k; i++) {
+      const double c = ((i % 2) ? -1e0 : 1e0) * binomial(k, i);
+      ap(i) += sigma[k + 2] * c;
+      ac(i) += sigmas[k + 2] * c;
+      bp(i) += gamma[k + 1] * c;
+      bc(i) += gammas[k + 1] * c;
+    }
+  }
+  delete[] mem;
+
+  // start-up quadrature weights, i.e. the integrals of the Lagrange basis
+  // polynomials l_i(u) on the nodes u = 0, 1, ..., order:
+  //   V(k,i) = ∫_0^k l_i(u) du and W(k,i) = ∫_0^k (k-u) l_i(u) du
+  Vstart = Eigen::MatrixXd::Zero(order + 1, order + 1);
+  Wstart = Eigen::MatrixXd::Zero(order + 1, order + 1);
+  {
+    Eigen::VectorXd poly(order + 1);
+    for (int i = 0; i <= order; i++) {
+      // coefficients of l_i(u) = Π_{j!=i} (u-j)/(i-j), in increasing powers
+      poly.setZero();
+      poly(0) = 1e0;
+      int deg = 0;
+      for (int j = 0; j <= order; j++) {
+        if (j == i)
+          continue;
+        for (int p = deg + 1; p > 0; p--)
+          poly(p) = (poly(p - 1) - j * poly(p)) / (i - j);
+        poly(0) = -j * poly(0) / (i - j);
+        ++deg;
+      }
+      for (int k = 1; k <= order; k++) {
+        double kp = k; // k^(p+1)
+        for (int p = 0; p <= order; p++) {
+          Vstart(k, i) += poly(p) * kp / (p + 1);
+          Wstart(k, i) += poly(p) * kp * k / ((p + 1) * (p + 2));
+          kp *= k;
+        }
+      }
+    }
+  }
+
+  Acc = Eigen::MatrixXd(nblocks * 3, order + 1);
+  Y = Eigen::MatrixXd(neqn, order + 1);
+  s1 = Eigen::VectorXd(nblocks * 3);
+  s2 = Eigen::VectorXd(nblocks * 3);
+  yp = Eigen::VectorXd(neqn);
+}
+
+void dso::GaussJackson::accel(double t, const Eigen::VectorXd &y,
+                              Eigen::Ref<Eigen::VectorXd> acc) noexcept {
+  f(t, y, yp, *params);
+  ++stats.nfev;
+  for (int b = 0; b < nblocks; b++)
+    acc.segment<3>(3 * b) = yp.segment<3>(6 * b + 3);
+}
+
+void dso::GaussJackson::startup(double t0, const Eigen::VectorXd &y0) noexcept {
+  // classical Runge-Kutta, nsub sub-steps per step, to get the state at
+  // t0, t0+h, ..., t0+order*h; note that column i of Y holds t_{n-i}
+  ++stats.nstarts;
+  Eigen::VectorXd y = y0;
+  Eigen::VectorXd k1(neqn), k2(neqn), k3(neqn), k4(neqn);
+  const double dt = h / nsub;
+  double t = t0;
+  Y.col(order) = y;
+  for (int n = 1; n <= order; n++) {
+    for (int j = 0; j < nsub; j++) {
+      f(t, y, k1, *params);
+      f(t + dt / 2e0, y + (dt / 2e0) * k1, k2, *params);
+      f(t + dt / 2e0, y + (dt / 2e0) * k2, k3, *params);
+      f(t + dt, y + dt * k3, k4, *params);
+      stats.nfev += 4;
+      y += (dt / 6e0) * (k1 + 2e0 * k2 + 2e0 * k3 + k4);
+      t += dt;
+    }
+    // avoid accumulating round-off in t
+    t = t0 + n * h;
+    Y.col(order - n) = y;
+  }
+  tn = t0 + order * h;
+
+  // accelerations at the grid points
+  for (int i = 0; i <= order; i++)
+    accel(tn - i * h, Y.col(i), Acc.col(i));
+
+  // refine the start-up values: integrate (twice) the polynomial
+  // interpolating the accelerations at t_0, ..., t_order, i.e.
+  //   x_k = x_0 + k*h*v_0 + h^2 Σ_i W(k,i) f_i
+  //   v_k = v_0 + h Σ_i V(k,i) f_i
+  // and re-evaluate the accelerations, until convergence
+  const double h2 = h * h;
+  for (int it = 0; it < max_startup_iter; it++) {
+    double dxmax = 0e0;
+    for (int k = 1; k <= order; k++) {
+      Eigen::VectorXd yk = Y.col(order);
+      for (int b = 0; b < nblocks; b++) {
+        Eigen::Matrix<double, 3, 1> x = yk.segment<3>(6 * b) +
+                                        (k * h) * yk.segment<3>(6 * b + 3);
+        Eigen::Matrix<double, 3, 1> v = yk.segment<3>(6 * b + 3);
+        for (int i = 0; i <= order; i++) {
+          // note that f_i is stored in column order-i
+          x += h2 * Wstart(k, i) * Acc.col(order - i).segment<3>(3 * b);
+          v += h * Vstart(k, i) * Acc.col(order - i).segment<3>(3 * b);
+        }
+        dxmax = std::max(
+            dxmax,
+            (x - Y.col(order - k).segment<3>(6 * b)).cwiseAbs().maxCoeff() /
+                std::max(1e0, x.cwiseAbs().maxCoeff()));
+        yk.segment<3>(6 * b) = x;
+        yk.segment<3>(6 * b + 3) = v;
+      }
+      Y.col(order - k) = yk;
+    }
+    for (int k = 1; k <= order; k++)
+      accel(t0 + k * h, Y.col(order - k), Acc.col(order - k));
+    if (dxmax < 1e-15)
+      break;
+  }
+
+  // initialize the sums (s_{n+1} and S_{n+1}), so that the corrector
+  // formulae reproduce the state at t_n:
+  //   v_n / h   = s_{n+1} + Σ bc_i f_{n-i}
+  //   x_n / h^2 = S_n     + Σ ac_i f_{n-i}
+  //   S_{n+1}   = S_n + s_{n+1}
+  for (int b = 0; b < nblocks; b++) {
+    s1.segment<3>(3 * b) = Y.col(0).segment<3>(6 * b + 3) / h;
+    s2.segment<3>(3 * b) = Y.col(0).segment<3>(6 * b) / (h * h);
+  }
+  s1 -= Acc * bc;
+  s2 -= Acc * ac;
+  s2 += s1;
+}
+
+void dso::GaussJackson::step() noexcept {
+  const double h2 = h * h;
+  Eigen::VectorXd y(neqn);
+
+  // predict (Störmer, Adams-Bashforth)
+  {
+    const Eigen::VectorXd x = h2 * (s2 + Acc * ap);
+    const Eigen::VectorXd v = h * (s1 + Acc * bp);
+    for (int b = 0; b < nblocks; b++) {
+      y.segment<3>(6 * b) = x.segment<3>(3 * b);
+      y.segment<3>(6 * b + 3) = v.segment<3>(3 * b);
+    }
+  }
+
+  // shift back-values
+  for (int i = order; i > 0; i--) {
+    Acc.col(i) = Acc.col(i - 1);
+    Y.col(i) = Y.col(i - 1);
+  }
+
+  // evaluate
+  accel(tn + h, y, Acc.col(0));
+
+  // correct (Cowell, Adams-Moulton); note that s2 is S_{n+1}
+  {
+    const Eigen::VectorXd x = h2 * (s2 + Acc * ac);
+    const Eigen::VectorXd v = h * (s1 + Acc.col(0) + Acc * bc);
+    for (int b = 0; b < nblocks; b++) {
+      y.segment<3>(6 * b) = x.segment<3>(3 * b);
+      y.segment<3>(6 * b + 3) = v.segment<3>(3 * b);
+    }
+  }
+
+  // evaluate
+  tn += h;
+  accel(tn, y, Acc.col(0));
+  Y.col(0) = y;
+  stats.accepted(tn, h, order, 0e0);
+
+  // update sums, s_{n+2} = s_{n+1} + f_{n+1} and S_{n+2} = S_{n+1} + s_{n+2}
+  s1 += Acc.col(0);
+  s2 += s1;
+}
+
+void dso::GaussJackson::interpolate(double tout,
+                                    Eigen::VectorXd &yout) const noexcept {
+  // Lagrange interpolation on the nodes t_n - i*h, i = 0,...,order; in
+  // units of h, the nodes are at u_i = -i
+  const double u = (tout - tn) / h;
+  yout = Eigen::VectorXd::Zero(neqn);
+  for (int i = 0; i <= order; i++) {
+    double w = 1e0;
+    for (int j = 0; j <= order; j++) {
+      if (j != i)
+        w *= (u + j) / (double)(j - i);
+    }
+    yout += w * Y.col(i);
+  }
+}
+
+int dso::GaussJackson::de(double &t, double tout, const Eigen::VectorXd &y0,
+                          Eigen::VectorXd &yout) noexcept {
+  if (t == tout || iflag < 1 || iflag > 2) {
+    fprintf(stderr, "[ERROR] Invalid parameters to %s\n", __func__);
+    iflag = 6;
+    return 1;
+  }
+
+  // (re-)start on first call or change of direction
+  const double del = tout - t;
+  if (iflag == 1 || h * del < 0e0) {
+    h = std::copysign(h, del);
+    startup(t, y0);
+  }
+
+  // output epoch must not lie before the back-values
+  if (h * (tout - (tn - order * h)) < 0e0) {
+    fprintf(stderr,
+            "[ERROR] Requested output epoch prior to integrator's "
+            "back-values; should restart (traceback: %s)\n",
+            __func__);
+    iflag = 6;
+    return 1;
+  }
+
+  // step until we are at (or just past) tout
+  while (h * (tout - tn) > 0e0)
+    step();
+
+  if (tout == tn)
+    yout = Y.col(0);
+  else
+    interpolate(tout, yout);
+
+  t = tout;
+  iflag = 2;
+  return 0;
+}
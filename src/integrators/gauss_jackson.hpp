@@ -0,0 +1,119 @@
+#ifndef __DSO_GAUSS_JACKSON_ODE_HPP__
+#define __DSO_GAUSS_JACKSON_ODE_HPP__
+
+#include "integrator_stats.hpp"
+#include "odefun.hpp"
+#include "orbit_integration.hpp"
+
+namespace dso {
+
+/// @brief Gauss-Jackson (second sum) fixed-step, multistep integrator for
+///        second order equations, y'' = f(t, y, y').
+///
+/// The right-hand side is given in the same (first order) form used by
+/// dso::SGOde, so that e.g. dso::VariationalEquations can be used as is.
+/// The state vector must be made up of blocks of 6 elements, each holding
+/// a "position" and its derivative (aka [r,v], [Φr(:,i), Φv(:,i)], ...) so
+/// that the derivative of each block is [v, a]; only the second half of
+/// each derivative block (the "accelerations") is used.
+///
+/// Position is integrated with the Störmer (predictor)/Cowell (corrector)
+/// formulae and velocity with the Adams-Bashforth/Adams-Moulton ones, all
+/// in summed (ordinate) form, i.e. Gauss-Jackson and summed Adams
+/// respectively, see Berry M. M., Healy L. M., Implementation of
+/// Gauss-Jackson integration for orbit propagation, J. Astronaut. Sci 52,
+/// 331–357 (2004). Every step is a P-E-C-E cycle, i.e. costs two
+/// evaluations of the right-hand side. The coefficients are computed at
+/// construction time for any order.
+///
+/// The back-values needed are first computed with a (classical) Runge-Kutta
+/// method, using nsub sub-steps per step, and then iterated to convergence
+/// by integrating the polynomial interpolating the accelerations over the
+/// start-up interval (so that the start-up error is consistent with the
+/// order of the method).
+///
+/// Output at epochs not on the integration grid is computed via Lagrange
+/// interpolation on the last order+1 grid points.
+class GaussJackson {
+public:
+  /// @brief Constructor
+  /// @param[in] _f Right-hand side (first order form)
+  /// @param[in] _neqn Number of equations (must be a multiple of 6)
+  /// @param[in] step Fixed step size (absolute value)
+  /// @param[in] _params Parameters passed in to the right-hand side
+  /// @param[in] _order Order of the (backward difference) formulae, i.e.
+  ///            the number of back-values used is order+1
+  /// @param[in] _nsub Number of Runge-Kutta sub-steps per step at
+  ///            start-up
+  GaussJackson(ODEfun _f, int _neqn, double step,
+               dso::IntegrationParameters *_params = nullptr, int _order = 8,
+               int _nsub = 4) noexcept;
+
+  int flag() const noexcept { return iflag; }
+  int &flag() noexcept { return iflag; }
+
+  /// @brief Integrate from t to tout.
+  ///
+  /// Same interface as SGOde::de: on the first call (flag() = 1) the
+  /// integrator is started at (t, y0); on subsequent calls (flag() = 2)
+  /// integration continues from the last (internal) grid point and y0 is
+  /// not used. On success, t is set to tout, yout holds the solution at
+  /// tout, flag() is set to 2 and 0 is returned.
+  int de(double &t, double tout, const Eigen::VectorXd &y0,
+         Eigen::VectorXd &yout) noexcept;
+
+  /// @brief Number of right-hand side evaluations so far
+  long num_fevals() const noexcept { return stats.nfev; }
+
+private:
+  /// evaluate the right-hand side at (t, y) and store accelerations in acc
+  void accel(double t, const Eigen::VectorXd &y,
+             Eigen::Ref<Eigen::VectorXd> acc) noexcept;
+  /// start-up: Runge-Kutta integration for order steps and initialization
+  /// of the sums
+  void startup(double t0, const Eigen::VectorXd &y0) noexcept;
+  /// take one (P-E-C-E) step
+  void step() noexcept;
+  /// interpolate at tout using the back-values
+  void interpolate(double tout, Eigen::VectorXd &yout) const noexcept;
+
+  ODEfun f;
+  int neqn;
+  int order;
+  int nsub;
+  int iflag;
+  /// maximum number of start-up iterations
+  static constexpr const int max_startup_iter = 20;
+  /// number of blocks of 6 (position/velocity pairs) in the state
+  int nblocks;
+  /// step size (signed)
+  double h;
+  /// time at the current grid point, t_n
+  double tn;
+  /// ordinate coefficients: position predictor, position corrector,
+  /// velocity predictor and velocity corrector (size order+1)
+  Eigen::VectorXd ap, ac, bp, bc;
+  /// start-up quadrature weights (order+1, order+1)
+  Eigen::MatrixXd Vstart, Wstart;
+  /// accelerations at t_n, t_{n-1}, ..., t_{n-order} (nblocks*3, order+1)
+  Eigen::MatrixXd Acc;
+  /// state at t_n, t_{n-1}, ..., t_{n-order} (neqn, order+1)
+  Eigen::MatrixXd Y;
+  /// first sum s_{n+1} and second sum S_{n+1}
+  Eigen::VectorXd s1, s2;
+  /// work space: derivative
+  Eigen::VectorXd yp;
+
+public:
+  /// May store a pointer to some king of parameters that are passed in the
+  /// ODE function
+  dso::IntegrationParameters *params{nullptr};
+  /// Statistics and optional step trace; every (fixed size) step is
+  /// accepted, at a constant order and without an error estimate (recorded
+  /// as 0), and each start-up counts as a (re-)start
+  dso::IntegratorStats stats;
+}; // GaussJackson
+
+} // dso
+
+#endif
@@ -0,0 +1,24 @@
+#include "integrator_stats.hpp"
+#include <cstdio>
+
+void dso::IntegratorStats::print(const char *name) const noexcept {
+  printf("%s: %ld evaluations, %ld/%ld accepted/rejected steps, %ld order "
+         "changes, %ld (re-)starts\n",
+         name, nfev, naccept, nreject, norder_changes, nstarts);
+}
+
+int dso::IntegratorStats::write_csv(const char *fn) const noexcept {
+  FILE *fp = std::fopen(fn, "w");
+  if (!fp) {
+    fprintf(stderr, "[ERROR] Failed opening file %s (traceback: %s)\n", fn,
+            __func__);
+    return 1;
+  }
+
+  fprintf(fp, "t,h,order,error\n");
+  for (const auto &s : trace)
+    fprintf(fp, "%.9f,%.9e,%d,%.6e\n", s.t, s.h, s.order, s.error);
+
+  std::fclose(fp);
+  return 0;
+}
@@ -0,0 +1,70 @@
+#ifndef __DSO_INTEGRATOR_STATISTICS_HPP__
+#define __DSO_INTEGRATOR_STATISTICS_HPP__
+
+#include <vector>
+
+namespace dso {
+
+/// @brief One (accepted) integration step, as recorded in the step trace
+///        of dso::IntegratorStats
+struct StepRecord {
+  /// independent variable at the end of the step
+  double t;
+  /// step size
+  double h;
+  /// order used for the step
+  int order;
+  /// (normalized) local error estimate, i.e. error over tolerance; <= 1
+  /// for an accepted step
+  double error;
+}; // StepRecord
+
+/// @brief Statistics of an integrator (see e.g. SGOde::stats, SGOdeN::stats,
+///        DormandPrince853::stats, GaussJackson::stats and
+///        PicardChebyshev::stats).
+///
+/// Counters are always updated; the step trace is only recorded if
+/// trace_steps is set (it grows with every accepted step, use clear_trace
+/// to drop it).
+struct IntegratorStats {
+  /// number of right-hand side evaluations
+  long nfev{0};
+  /// number of accepted and rejected (i.e. repeated) steps
+  long naccept{0}, nreject{0};
+  /// number of changes of the order between consecutive accepted steps
+  long norder_changes{0};
+  /// number of (re-)starts, including the initial one
+  long nstarts{0};
+  /// if true, every accepted step is appended to trace
+  bool trace_steps{false};
+  /// step trace
+  std::vector<StepRecord> trace;
+
+  /// @brief Record an accepted step (counters and, if enabled, trace)
+  void accepted(double t, double h, int order, double error) noexcept {
+    ++naccept;
+    if (trace_steps)
+      trace.push_back(StepRecord{t, h, order, error});
+  }
+
+  /// @brief Reset all counters and drop the trace
+  void reset() noexcept {
+    nfev = naccept = nreject = norder_changes = nstarts = 0;
+    trace.clear();
+  }
+
+  /// @brief Drop the step trace
+  void clear_trace() noexcept { trace.clear(); }
+
+  /// @brief Print the counters (one line) to stdout, prefixed by name
+  void print(const char *name) const noexcept;
+
+  /// @brief Write the step trace to a CSV file, with header line
+  ///        "t,h,order,error"
+  /// @return Anything other than 0 denotes an error
+  int write_csv(const char *fn) const noexcept;
+}; // IntegratorStats
+
+} // dso
+
+#endif
@@ -0,0 +1,233 @@
+#include "picard_chebyshev.hpp"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdio>
+
+namespace {
+/// Check that the parameter instances can be used concurrently, i.e. that
+/// they do not share any state modified by the right-hand side and that
+/// Sun/Moon positions are not computed via CSPICE (see
+/// dso::PicardChebyshev)
+bool independent(
+    const std::vector<dso::IntegrationParameters *> &params) noexcept {
+  auto shared = [](const void *a, const void *b) { return a && a == b; };
+  for (std::size_t i = 0; i < params.size(); i++) {
+    const dso::IntegrationParameters *p = params[i];
+    if (p->ephemeris_tier != dso::EphemerisTier::Analytic && !p->spk_cursor)
+      return false;
+    for (std::size_t j = 0; j < i; j++) {
+      const dso::IntegrationParameters *q = params[j];
+      if (p == q || shared(p->AtmDataFeed, q->AtmDataFeed) ||
+          shared(p->qhunt, q->qhunt) || shared(p->spk_cursor, q->spk_cursor))
+        return false;
+    }
+  }
+  return true;
+}
+} // unnamed namespace
+
+dso::PicardChebyshev::PicardChebyshev(
+    ODEfun _f, int _neqn, int _order, double rerr, double aerr,
+    std::vector<dso::IntegrationParameters *> _params) noexcept
+    : f(_f), neqn(_neqn), order(_order), relerr(rerr), abserr(aerr),
+      params(_params) {
+  assert(!params.empty() &&
+         std::none_of(params.begin(), params.end(),
+                      [](const dso::IntegrationParameters *p) { return !p; }));
+  nthreads = params.size();
+  if (nthreads > 1 && !independent(params)) {
+    fprintf(stderr,
+            "[WARNING] Parameter instances share state that is not thread "
+            "safe; right-hand side evaluations will be serial (traceback: "
+            "%s)\n",
+            __func__);
+    nthreads = 1;
+  }
+  ytmp = std::vector<Eigen::VectorXd>(nthreads, Eigen::VectorXd(neqn));
+
+  const int N = order;
+  Y = Eigen::MatrixXd(neqn, N + 1);
+  G = Eigen::MatrixXd(neqn, N + 1);
+
+  // Chebyshev-Gauss-Lobatto nodes, in ascending order (τ_0 = -1, τ_N = 1)
+  tau = Eigen::VectorXd(N + 1);
+  for (int j = 0; j <= N; j++)
+    tau(j) = -std::cos(j * M_PI / N);
+
+  // Chebyshev polynomials at the nodes, T(k,j) = T_k(τ_j), k=0,...,N+1
+  Eigen::MatrixXd T(N + 2, N + 1);
+  for (int j = 0; j <= N; j++) {
+    T(0, j) = 1e0;
+    T(1, j) = tau(j);
+    for (int k = 2; k <= N + 1; k++)
+      T(k, j) = 2e0 * tau(j) * T(k - 1, j) - T(k - 2, j);
+  }
+
+  // fit; a_k = (2/N) Σ'' g_j T_k(τ_j), with the end-point terms (j=0,N) and
+  // the coefficients a_0, a_N halved
+  Fit = Eigen::MatrixXd(N + 1, N + 1);
+  for (int j = 0; j <= N; j++) {
+    for (int k = 0; k <= N; k++) {
+      double w = 2e0 / N;
+      if (j == 0 || j == N)
+        w /= 2e0;
+      if (k == 0 || k == N)
+        w /= 2e0;
+      Fit(j, k) = w * T(k, j);
+    }
+  }
+
+  // integration; ∫T_0 = T_1, ∫T_1 = T_2/4 and for k >= 2,
+  // ∫T_k = T_{k+1}/(2(k+1)) - T_{k-1}/(2(k-1)). The constant term is chosen
+  // so that the integral is zero at τ = -1
+  Eigen::MatrixXd Int = Eigen::MatrixXd::Zero(N + 1, N + 2);
+  Int(0, 1) = 1e0;
+  if (N >= 1)
+    Int(1, 2) = 1e0 / 4e0;
+  for (int k = 2; k <= N; k++) {
+    Int(k, k + 1) += 1e0 / (2e0 * (k + 1));
+    Int(k, k - 1) -= 1e0 / (2e0 * (k - 1));
+  }
+  for (int k = 1; k <= N + 1; k++)
+    Int.col(0) -= ((k % 2) ? -1e0 : 1e0) * Int.col(k);
+
+  FitInt = Fit * Int;
+  Picard = FitInt * T;
+
+  // worker threads; the calling thread acts as thread 0
+  workers.reserve(nthreads - 1);
+  for (int i = 1; i < nthreads; i++)
+    workers.emplace_back(&dso::PicardChebyshev::worker, this, i);
+}
+
+dso::PicardChebyshev::~PicardChebyshev() noexcept {
+  {
+    std::lock_guard<std::mutex> lock(mtx);
+    stop = true;
+  }
+  cv_start.notify_all();
+  for (auto &thread : workers)
+    thread.join();
+}
+
+void dso::PicardChebyshev::work(int ith) noexcept {
+  // nodes j = ith, ith + nthreads, ... are handled by thread ith
+  for (int j = ith; j <= order; j += nthreads) {
+    ytmp[ith] = Y.col(j);
+    f(eval_t0 + eval_w2 * (tau(j) + 1e0), ytmp[ith], G.col(j),
+      *(params[ith]));
+  }
+}
+
+void dso::PicardChebyshev::worker(int ith) noexcept {
+  long done = 0;
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(mtx);
+      cv_start.wait(lock, [&] { return stop || generation != done; });
+      if (stop)
+        return;
+      done = generation;
+    }
+    work(ith);
+    {
+      std::lock_guard<std::mutex> lock(mtx);
+      if (--pending == 0)
+        cv_done.notify_one();
+    }
+  }
+}
+
+void dso::PicardChebyshev::evaluate(double t0, double w2) noexcept {
+  // signal the workers, do our share and wait for the rest
+  {
+    std::lock_guard<std::mutex> lock(mtx);
+    eval_t0 = t0;
+    eval_w2 = w2;
+    pending = nthreads - 1;
+    ++generation;
+  }
+  cv_start.notify_all();
+  work(0);
+  {
+    std::unique_lock<std::mutex> lock(mtx);
+    cv_done.wait(lock, [&] { return pending == 0; });
+  }
+
+  stats.nfev += order + 1;
+}
+
+int dso::PicardChebyshev::segment(double t0, double t1,
+                                  const Eigen::VectorXd &y0,
+                                  Eigen::MatrixXd &ycoef,
+                                  Eigen::MatrixXd &ypcoef) noexcept {
+  const int N = order;
+  const double w2 = (t1 - t0) / 2e0;
+
+  // initial guess: linear extrapolation from the start of the segment
+  ytmp[0] = y0;
+  f(t0, ytmp[0], G.col(0), *(params[0]));
+  ++stats.nfev;
+  for (int j = 0; j <= N; j++)
+    Y.col(j) = y0 + (w2 * (tau(j) + 1e0)) * G.col(0);
+
+  // Picard iteration
+  Eigen::MatrixXd Ynew(neqn, N + 1);
+  int it = 0;
+  double err = 0e0;
+  for (it = 0; it < max_iter; it++) {
+    evaluate(t0, w2);
+    Ynew = (w2 * G) * Picard;
+    Ynew.colwise() += y0;
+    err = ((Ynew - Y).array().abs() /
+           (abserr + relerr * Ynew.array().abs()))
+              .maxCoeff();
+    Y.swap(Ynew);
+    ++niter;
+    if (err <= 1e0)
+      break;
+  }
+
+  if (err > 1e0) {
+    ++stats.nreject;
+    fprintf(stderr,
+            "[ERROR] Picard iteration did not converge in [%.3f, %.3f] after "
+            "%d iterations (traceback: %s)\n",
+            t0, t1, max_iter, __func__);
+    return 1;
+  }
+
+  // Chebyshev coefficients of the derivative and the solution
+  ypcoef = G * Fit;
+  ycoef = (w2 * G) * FitInt;
+  ycoef.col(0) += y0;
+
+  stats.accepted(t1, t1 - t0, order, err);
+  return 0;
+}
+
+int dso::PicardChebyshev::propagate(double t0, const Eigen::VectorXd &y0,
+                                    double tend, double max_seg,
+                                    dso::ChebyshevTrajectory &traj) noexcept {
+  ++stats.nstarts;
+
+  // equal-length segments
+  const int nseg =
+      std::max(1, (int)std::ceil(std::abs(tend - t0) / std::abs(max_seg)));
+  const double h = (tend - t0) / nseg;
+
+  Eigen::VectorXd ys = y0;
+  Eigen::MatrixXd ycoef, ypcoef;
+  for (int i = 0; i < nseg; i++) {
+    const double ts = t0 + i * h;
+    const double te = (i == nseg - 1) ? tend : ts + h;
+    if (segment(ts, te, ys, ycoef, ypcoef))
+      return 1;
+    traj.append(ts, te, ycoef, ypcoef);
+    // start of next segment, aka the solution at τ = 1
+    ys = Y.col(order);
+  }
+
+  return 0;
+}
@@ -0,0 +1,146 @@
+#ifndef __DSO_PICARD_CHEBYSHEV_ODE_HPP__
+#define __DSO_PICARD_CHEBYSHEV_ODE_HPP__
+
+#include "chebyshev_trajectory.hpp"
+#include "integrator_stats.hpp"
+#include "odefun.hpp"
+#include "orbit_integration.hpp"
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace dso {
+
+/// @brief Modified Chebyshev-Picard Iteration (MCPI) propagator.
+///
+/// The arc is split in segments; within each segment, the solution is
+/// approximated by a Chebyshev series and refined via Picard iteration:
+///   y_{i+1}(t) = y0 + ∫_{t0}^{t} f(s, y_i(s)) ds
+/// where the integrand is sampled at the Chebyshev-Gauss-Lobatto nodes of
+/// the segment and integrated (exactly) in Chebyshev space, see Bai X.,
+/// Junkins J. L., Modified Chebyshev-Picard iteration methods for orbit
+/// propagation, J. Astronaut. Sci. 58, 583–613 (2011). All linear operations
+/// of an iteration (fit, integration and evaluation at the nodes) reduce to
+/// one (precomputed) matrix product.
+///
+/// Within an iteration, the right-hand side evaluations at the nodes are
+/// independent, hence they are distributed over a (persistent) pool of
+/// worker threads, created once at construction; the number of threads used
+/// is the number of parameter instances given. The right-hand side (e.g.
+/// dso::VariationalEquations) is not reentrant for a given instance of
+/// parameters (it uses e.g. the instance's time cache and atmospheric data
+/// feed as work space), hence each thread needs its own instance, which
+/// should not share any mutable state with the others, i.e.:
+///   * distinct atmospheric data feeds, attitude (quaternion) hunters and
+///     SPK cursors,
+///   * Sun/Moon positions not computed via CSPICE (which is not thread
+///     safe), i.e. either EphemerisTier::Analytic or an spk_cursor set.
+/// If the instances fail the above checks, a warning is issued and the
+/// evaluations are serial (using the first instance only).
+///
+/// The result is a dso::ChebyshevTrajectory, which has the same query
+/// interface as dso::DenseTrajectory.
+class PicardChebyshev {
+public:
+  /// @brief Constructor
+  /// @param[in] _f Right-hand side (first order form)
+  /// @param[in] _neqn Number of equations
+  /// @param[in] _order Number of Chebyshev nodes (per segment) minus one,
+  ///            i.e. the degree of the series for the derivative
+  /// @param[in] rerr Relative error tolerance (for the convergence of the
+  ///            Picard iteration)
+  /// @param[in] aerr Absolute error tolerance (for the convergence of the
+  ///            Picard iteration)
+  /// @param[in] _params One instance of parameters (to be passed in to the
+  ///            right-hand side) per thread; at least one (non-null)
+  ///            instance is needed
+  PicardChebyshev(ODEfun _f, int _neqn, int _order, double rerr, double aerr,
+                  std::vector<dso::IntegrationParameters *> _params) noexcept;
+
+  /// @brief Destructor; stops and joins the worker threads
+  ~PicardChebyshev() noexcept;
+
+  PicardChebyshev(const PicardChebyshev &) = delete;
+  PicardChebyshev &operator=(const PicardChebyshev &) = delete;
+
+  /// @brief Number of threads used for the right-hand side evaluations
+  int num_threads() const noexcept { return nthreads; }
+
+  /// @brief Propagate from (t0, y0) to tend, in segments of (at most)
+  ///        max_seg length, and append the resulting segments to traj.
+  /// @return Anything other than 0 denotes an error (Picard iteration did
+  ///         not converge); the segments computed so far are kept in traj
+  int propagate(double t0, const Eigen::VectorXd &y0, double tend,
+                double max_seg, dso::ChebyshevTrajectory &traj) noexcept;
+
+  /// @brief Solve for one segment [t0, t1], starting at y0.
+  /// @param[out] ycoef Chebyshev coefficients of the solution
+  ///            (neqn, order+2)
+  /// @param[out] ypcoef Chebyshev coefficients of the derivative
+  ///            (neqn, order+1)
+  /// @return Anything other than 0 denotes an error (no convergence)
+  int segment(double t0, double t1, const Eigen::VectorXd &y0,
+              Eigen::MatrixXd &ycoef, Eigen::MatrixXd &ypcoef) noexcept;
+
+  /// @brief Number of right-hand side evaluations so far
+  long num_fevals() const noexcept { return stats.nfev; }
+
+  /// @brief Number of Picard iterations so far
+  long num_iterations() const noexcept { return niter; }
+
+  /// @brief Maximum number of Picard iterations per segment
+  int max_iter{50};
+
+private:
+  /// evaluate the right-hand side at all nodes, i.e. G.col(j) = f(t_j, Y(j))
+  void evaluate(double t0, double w2) noexcept;
+  /// evaluate the right-hand side at the nodes handled by thread ith
+  void work(int ith) noexcept;
+  /// main loop of worker thread ith (> 0)
+  void worker(int ith) noexcept;
+
+  ODEfun f;
+  int neqn;
+  int order;
+  double relerr, abserr;
+  long niter{0};
+  /// Chebyshev-Gauss-Lobatto nodes in [-1, 1] (order+1)
+  Eigen::VectorXd tau;
+  /// fit to Chebyshev coefficients (order+1, order+1)
+  Eigen::MatrixXd Fit;
+  /// fit, followed by integration (order+1, order+2)
+  Eigen::MatrixXd FitInt;
+  /// fit, integration and evaluation at the nodes (order+1, order+1)
+  Eigen::MatrixXd Picard;
+  /// solution and right-hand side at the nodes (neqn, order+1)
+  Eigen::MatrixXd Y, G;
+  /// work space: per thread state vector
+  std::vector<Eigen::VectorXd> ytmp;
+
+  /// worker threads (all but the calling one) and their synchronization:
+  /// a new evaluation is signalled by incrementing generation, workers
+  /// still busy are counted in pending
+  int nthreads{1};
+  std::vector<std::thread> workers;
+  std::mutex mtx;
+  std::condition_variable cv_start, cv_done;
+  long generation{0};
+  int pending{0};
+  bool stop{false};
+  /// start and half-length of the segment of the current evaluation
+  double eval_t0{0e0}, eval_w2{0e0};
+
+public:
+  /// Parameters passed in to the right-hand side, one per thread
+  std::vector<dso::IntegrationParameters *> params;
+  /// Statistics and optional step trace; a step is a segment, accepted if
+  /// the Picard iteration converges (error is the normalized difference of
+  /// the last two iterates) and rejected otherwise, and each call to
+  /// propagate counts as a (re-)start
+  dso::IntegratorStats stats;
+}; // PicardChebyshev
+
+} // dso
+
+#endif
@@ -1,11 +1,15 @@
 #ifndef __DSO_SGODE_ODE_HPP__
 #define __DSO_SGODE_ODE_HPP__
 
+#include "integrator_stats.hpp"
 #include "odefun.hpp"
 #include "orbit_integration.hpp"
 
 namespace dso {
 
+class DenseTrajectory;
+class EventDetector;
+
 class SGOde {
 public:
   SGOde(ODEfun _f, int _neqn, double rerr, double aerr,
@@ -124,6 +128,24 @@ public:
   /// May store a pointer to some king of parameters that are passed in the
   /// ODE function
   dso::IntegrationParameters *params{nullptr};
+  /// If not null, every accepted step is recorded here (dense output)
+  dso::DenseTrajectory *dense{nullptr};
+  /// If not empty (size neqn), per-equation factors applied to the error
+  /// weights, i.e. the tolerances of equation i are scaled by wscale(i);
+  /// e.g. use values > 1 to integrate the variational equations at a looser
+  /// tolerance than the state
+  Eigen::VectorXd wscale;
+  /// If not null, event functions are evaluated (and crossings located) at
+  /// every accepted step; the integration stops at terminal events, see
+  /// dso::EventDetector
+  dso::EventDetector *events{nullptr};
+  /// a terminal event was located in the last step, at tstop, but not yet
+  /// reached (output point before the event)
+  bool stop_pending{false};
+  double tstop;
+  /// Statistics (evaluations, steps, order changes, restarts) and optional
+  /// step trace
+  dso::IntegratorStats stats;
 }; // SGOde
 
 } // dso
@@ -1,4 +1,6 @@
 #include "sgode.hpp"
+#include "dense_trajectory.hpp"
+#include "events.hpp"
 #include <limits>
 #ifdef DEBUG
 #include <cstdio>
@@ -80,13 +82,30 @@ int dso::SGOde::de(double& t, double tout, const Eigen::VectorXd &y0,
     yy() = y0;
     // -- break point 30: --
     start = true;
+    ++stats.nstarts;
     // -- break point 40: --
     delsgn = std::copysign(1e0, del);
     h = std::copysign(std::max(std::abs(tout - x), fouru * std::abs(x)),
                       tout - x);
+    // event functions at the start point
+    stop_pending = false;
+    if (events)
+      events->reset(x, yy());
   }
 
   while (true) {
+    if (stop_pending && delsgn * (tout - tstop) >= 0e0) {
+      // a terminal event (within the last step) is reached before the
+      // output point; interpolate and return
+      stop_pending = false;
+      intrp(tstop, yout);
+      iflag = 2;
+      t = tstop;
+      told = t;
+      isnold = isn;
+      return 0;
+    }
+
     if (std::abs(x - t) >= absdel) {
       // if already past output point, interpolate and return
       // -- break point 50: --
@@ -104,6 +123,7 @@ int dso::SGOde::de(double& t, double tout, const Eigen::VectorXd &y0,
       // -- break point 60: --
       h = tout - x;
       f(x, yy(), yp(), *params); // derivate at yp()
+      ++stats.nfev;
       yout = yy() + h * yp();
       iflag = 2;
       t = tout;
@@ -130,6 +150,8 @@ int dso::SGOde::de(double& t, double tout, const Eigen::VectorXd &y0,
     // -- break point 100: --
     h = std::copysign(std::min(std::abs(h), std::abs(tend - x)), h);
     wt() = (releps * yy().cwiseAbs()).array() + abseps;
+    if (wscale.size() == neqn)
+      wt().array() *= wscale.array();
     this->step(eps, crash);
 
     // test for tolerances too small
@@ -144,6 +166,16 @@ int dso::SGOde::de(double& t, double tout, const Eigen::VectorXd &y0,
       return 1;
     }
 
+    // record the step for dense output
+    if (dense)
+      dense->record(*this);
+
+    // look for events within the step (on the interpolating polynomial)
+    if (events)
+      stop_pending = events->check(
+          x, yy(), [this](double ti, Eigen::VectorXd &yi) { intrp(ti, yi); },
+          tstop);
+
     // augment counter on number of steps and test for stiffness
     ++nostep;
     ++kle4;
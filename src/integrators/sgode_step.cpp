@@ -49,6 +49,7 @@ int dso::SGOde::step(double &eps, int &crash) noexcept {
   if (start) {
     // initialize.  compute appropriate step size for first step
     f(x, yy(), yp(), *params);
+    ++stats.nfev;
     Phi.col(0) = yp();
     Phi.col(1).setZero();
     const double sum = (yp().array() / wt().array()).matrix().norm();
@@ -77,6 +78,8 @@ int dso::SGOde::step(double &eps, int &crash) noexcept {
   int step_success = false;
   int kp1, kp2, km1, km2, knew;
   double erkm2, erkm1, erk, xold;
+  // error estimate of the step, over the tolerance
+  double errn = 0e0;
   do {
     //
     //  ***     begin block 1     ***
@@ -228,6 +231,7 @@ int dso::SGOde::step(double &eps, int &crash) noexcept {
     x += h;
     absh = std::abs(h);
     f(x, p(), yp(), *params);
+    ++stats.nfev;
 
     // estimate errors at orders k,k-1,k-2
     erkm2 = 0e0;
@@ -254,6 +258,7 @@ int dso::SGOde::step(double &eps, int &crash) noexcept {
     //  absh, g(k-1),g(kp1-1),sig(kp1-1),gstr[k-1]);
     const double t5 = absh * std::sqrt(erk);
     const double err = t5 * (g(k - 1) - g(kp1 - 1));
+    errn = err / eps;
     erk = t5 * sig(kp1 - 1) * gstr[k - 1];
     knew = k;
 
@@ -284,6 +289,7 @@ int dso::SGOde::step(double &eps, int &crash) noexcept {
     // precision.
     //                 ***
     if (!step_success) {
+      ++stats.nreject;
       phase1 = false;
       x = xold;
       for (int i = 0; i < k; i++) {
@@ -332,8 +338,11 @@ int dso::SGOde::step(double &eps, int &crash) noexcept {
   // differences.  determine best order and step size for next step.
   //
   // -- break point 400: --
+  if (kold && k != kold)
+    ++stats.norder_changes;
   kold = k;
   hold = h;
+  stats.accepted(x, h, k, errn);
   //printf("\t>step success! setting h=%.6f and k=%d\n", h, k);
 
   // correct and evaluate
@@ -353,6 +362,7 @@ int dso::SGOde::step(double &eps, int &crash) noexcept {
 
   // -- break point 420: --
   f(x, yy(), yp(), *params);
+  ++stats.nfev;
 
   // update differences for next step
   Phi.col(kp1 - 1) = yp() - Phi.col(0);
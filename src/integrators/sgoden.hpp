@@ -0,0 +1,634 @@
+#ifndef __DSO_SGODE_FIXED_SIZE_ODE_HPP__
+#define __DSO_SGODE_FIXED_SIZE_ODE_HPP__
+
+#include "eigen3/Eigen/Eigen"
+#include "integrator_stats.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#ifdef DEBUG
+#include <cassert>
+#include <cstdio>
+#endif
+
+namespace dso {
+
+/// @brief Fixed-size, allocation-free version of the Shampine & Gordon
+///        (variable order, variable step) Adams-Bashforth-Moulton integrator,
+///        aka dso::SGOde.
+///
+/// The number of equations N is known at compile time (e.g. for orbit
+/// integration with variational equations, N = 6 + 6*6 + 6*Np), hence all
+/// work arrays are fixed-size Eigen matrices and the whole integrator state
+/// lives in one object (no heap allocation is performed, neither at
+/// construction nor while integrating).
+///
+/// The derivative function is a template callable (e.g. a lambda capturing
+/// the integration parameters), invoked as:
+///   f(double x, const Eigen::Matrix<double,N,1> &y,
+///     Eigen::Matrix<double,N,1> &yp)
+/// so that the call can be inlined. The algorithm and flags are exactly the
+/// same as in dso::SGOde (see sgode_de.cpp, sgode_step.cpp and
+/// sgode_intrp.cpp).
+///
+/// Example:
+///   auto ve = [&params](double t, const Eigen::Matrix<double, 48, 1> &y,
+///                       Eigen::Matrix<double, 48, 1> &yp) {
+///     dso::VariationalEquations(t, y, yp, params);
+///   };
+///   dso::SGOdeN<48, decltype(ve)> integrator(ve, 1e-12, 1e-12);
+template <int N, typename F> class SGOdeN {
+public:
+  using Vector = Eigen::Matrix<double, N, 1>;
+  static constexpr const int neqn = N;
+  static_assert(N > 0, "SGOdeN needs at least one equation");
+
+private:
+  static constexpr const double umach = std::numeric_limits<double>::epsilon();
+  static constexpr const double twou = 2e0 * umach;
+  static constexpr const double fouru = 4e0 * umach;
+  static constexpr const double gstr[] = {
+      5e-1,      0.0833e0,  0.0417e0,  0.0264e0,  0.0188e0,
+      0.0143e0,  0.0114e0,  0.00936e0, 0.00789e0, 0.00679e0,
+      0.00592e0, 0.00524e0, 0.00468e0};
+
+public:
+  SGOdeN(F _f, double rerr, double aerr) noexcept
+      : f(_f), iflag(1), relerr(rerr), abserr(aerr) {}
+
+  int flag() const noexcept { return iflag; }
+  int &flag() noexcept { return iflag; }
+
+  /// @brief Integrate from t to tout; see dso::SGOde::de
+  int de(double &t, double tout, const Vector &y0, Vector &yout) noexcept;
+
+  /// @brief Take a single step; see dso::SGOde::step
+  int step(double &eps, int &crash) noexcept;
+
+  /// @brief Interpolate at xout (using the last step); the derivative at
+  ///        xout is stored in the member variable ypout
+  int intrp(double xout, Vector &yout) noexcept;
+
+  double &psi(int i) noexcept {
+#ifdef DEBUG
+    assert(i >= 0 && i < 12);
+#endif
+    return Arrays13[0 * 13 + i];
+  }
+  double &alpha(int i) noexcept {
+#ifdef DEBUG
+    assert(i >= 0 && i < 12);
+#endif
+    return Arrays13[1 * 13 + i];
+  }
+  double &beta(int i) noexcept {
+#ifdef DEBUG
+    assert(i >= 0 && i < 12);
+#endif
+    return Arrays13[2 * 13 + i];
+  }
+  double *v() noexcept { return Arrays13 + 3 * 13; }
+  double &v(int i) noexcept {
+#ifdef DEBUG
+    assert(i >= 0 && i < 12);
+#endif
+    return Arrays13[3 * 13 + i];
+  }
+  double *w() noexcept { return Arrays13 + 4 * 13; }
+  double &w(int i) noexcept {
+#ifdef DEBUG
+    assert(i >= 0 && i < 12);
+#endif
+    return Arrays13[4 * 13 + i];
+  }
+  double &sig(int i) noexcept {
+#ifdef DEBUG
+    assert(i >= 0 && i < 13);
+#endif
+    return Arrays13[5 * 13 + i];
+  }
+  double &g(int i) noexcept {
+#ifdef DEBUG
+    assert(i >= 0 && i < 13);
+#endif
+    return Arrays13[6 * 13 + i];
+  }
+
+public:
+  F f;
+  int iflag;
+  int start{1}, phase1{1}, nornd{1}, isnold{0}, kold{0}, k{1}, ns{0};
+  Eigen::Matrix<double, N, 16> Phi;
+  Vector wt, p, yy, yp, ypout;
+  double Arrays13[13 * 7]; // psi, alpha, beta, v, w, sig, g
+  double h{0e0}, hold{0e0};
+  double x{0e0};
+  double told{0e0};
+  double delsgn{0e0};
+  double relerr, abserr;
+  /// Statistics (evaluations, steps, order changes, restarts) and optional
+  /// step trace; same as in dso::SGOde
+  dso::IntegratorStats stats;
+}; // SGOdeN
+
+template <int N, typename F>
+int SGOdeN<N, F>::de(double &t, double tout, const Vector &y0,
+                     Vector &yout) noexcept {
+  // maximum number of steps allowed in one call to de
+  constexpr const int maxnum = 500;
+
+  int crash = false;
+
+  // test for improper parameters
+  double eps = std::max(relerr, abserr);
+  if (t == tout || (relerr < 0e0 || abserr < 0e0) || eps < 0e0 || !iflag ||
+      (t != told && std::abs(iflag) != 1)) {
+    iflag = 6;
+#ifdef DEBUG
+    fprintf(stderr, "ERROR Invalid parameters to %s\n", __func__);
+#endif
+    return 1;
+  }
+
+  const int isn = std::copysign(1, iflag);
+  iflag = std::abs(iflag);
+
+  if (iflag < 0 || iflag > 5)
+    return 1;
+
+  // on each call set interval of integration and counter for number of
+  // steps.  adjust input error tolerances to define weight vector for
+  // subroutine  step
+  const double del = tout - t;
+  const double absdel = std::abs(del);
+  double tend = t + 10e0 * del;
+  if (isn < 0)
+    tend = tout;
+
+  int nostep = 0;
+  int kle4 = 0;
+  int stiff = false;
+  const double releps = relerr / eps;
+  const double abseps = abserr / eps;
+
+  if (delsgn * del <= 0e0 || iflag == 1) {
+    // on start and restart also set work variables x and yy(*), store the
+    // direction of integration and initialize the step size
+    x = t;
+    yy = y0;
+    start = true;
+    ++stats.nstarts;
+    delsgn = std::copysign(1e0, del);
+    h = std::copysign(std::max(std::abs(tout - x), fouru * std::abs(x)),
+                      tout - x);
+  }
+
+  while (true) {
+    // if already past output point, interpolate and return
+    if (std::abs(x - t) >= absdel) {
+      intrp(tout, yout);
+      iflag = 2;
+      t = tout;
+      told = t;
+      isnold = isn;
+      return 0;
+    }
+
+    // if cannot go past output point and sufficiently close,
+    // extrapolate and return
+    if (!(isn > 0 || std::abs(tout - x) >= fouru * std::abs(x))) {
+      h = tout - x;
+      f(x, yy, yp);
+      ++stats.nfev;
+      yout = yy + h * yp;
+      iflag = 2;
+      t = tout;
+      told = t;
+      isnold = isn;
+      return 0;
+    }
+
+    // test too many steps
+    if (nostep >= maxnum) {
+      iflag = isn * 4;
+      if (stiff)
+        iflag = isn * 5;
+      yout = yy;
+      t = x;
+      told = t;
+      isnold = 1;
+      return 1;
+    }
+
+    // limit step size, set weight vector and take a step
+    h = std::copysign(std::min(std::abs(h), std::abs(tend - x)), h);
+    wt = (releps * yy.cwiseAbs()).array() + abseps;
+    this->step(eps, crash);
+
+    // test for tolerances too small
+    if (crash) {
+      iflag = isn * 3;
+      relerr = eps * releps;
+      abserr = eps * abseps;
+      yout = yy;
+      t = x;
+      told = t;
+      isnold = 1;
+      return 1;
+    }
+
+    // augment counter on number of steps and test for stiffness
+    ++nostep;
+    ++kle4;
+    if (kold > 4)
+      kle4 = 0;
+    if (kle4 >= 50)
+      stiff = true;
+  }
+
+  return 100;
+}
+
+template <int N, typename F>
+int SGOdeN<N, F>::step(double &eps, int &crash) noexcept {
+  // ***     begin block 0     ***
+  // if step size is too small, determine an acceptable one
+  crash = true;
+  if (std::abs(h) < fouru * std::abs(x)) {
+    h = std::copysign(fouru * std::abs(x), h);
+    return 0;
+  }
+
+  const double p5eps = 5e-1 * eps;
+
+  //  if error tolerance is too small, increase it to an acceptable value
+  const double round = twou * (yy.array() / wt.array()).matrix().norm();
+  if (p5eps < round) {
+    eps = 2e0 * round * (1e0 + fouru);
+    return 0;
+  }
+
+  crash = false;
+  g(0) = 1e0;
+  g(1) = 5e-1;
+  sig(0) = 1e0;
+
+  double absh;
+  int ifail;
+  if (start) {
+    // initialize.  compute appropriate step size for first step
+    f(x, yy, yp);
+    ++stats.nfev;
+    Phi.col(0) = yp;
+    Phi.col(1).setZero();
+    const double sum = (yp.array() / wt.array()).matrix().norm();
+    absh = std::abs(h);
+    if (eps < 16e0 * sum * h * h)
+      absh = 0.25e0 * std::sqrt(eps / sum);
+    h = std::copysign(std::max(absh, fouru * std::abs(x)), h);
+    hold = 0e0;
+    k = 1;
+    kold = 0;
+    start = false;
+    phase1 = true;
+    nornd = true;
+    if (p5eps <= 1e2 * round) {
+      nornd = false;
+      Phi.col(14).setZero();
+    }
+  }
+  ifail = 0;
+  // ***     end block 0     ***
+
+  // Repeat blocks 1, 2 (and 3) until step is successful
+  int step_success = false;
+  int kp1, kp2, km1, km2, knew;
+  double erkm2, erkm1, erk, xold, errn = 0e0;
+  do {
+    // ***     begin block 1     ***
+    // compute coefficients of formulas for this step.  avoid computing
+    // those quantities not changed when step size is not changed.
+    kp1 = k + 1;
+    kp2 = k + 2;
+    km1 = k - 1;
+    km2 = k - 2;
+
+    // ns is the number of steps taken with size h, including the current
+    // one.  when k.lt.ns, no coefficients change
+    if (h != hold)
+      ns = 0;
+    if (ns <= kold)
+      ++ns;
+    const int nsp1 = ns + 1;
+    if (k >= ns) {
+      // compute those components of alpha(*),beta(*),psi(*),sig(*) which
+      // are changed
+      beta(ns - 1) = 1e0;
+      alpha(ns - 1) = 1e0 / ns;
+      double tmp1 = h * ns;
+      sig(nsp1 - 1) = 1e0;
+      if (k >= nsp1) {
+        for (int i = nsp1 - 1; i < k; i++) {
+          const int im1 = i - 1;
+          const double tmp2 = psi(im1);
+          psi(im1) = tmp1;
+          beta(i) = beta(im1) * psi(im1) / tmp2;
+          tmp1 = tmp2 + h;
+          alpha(i) = h / tmp1;
+          sig(i + 1) = (double)(i + 1e0) * (alpha(i) * sig(i));
+        }
+      }
+      psi(k - 1) = tmp1;
+
+      // compute coefficients g(*); initialize v(*) and set w(*)
+      if (ns <= 1) {
+        for (int iq = 0; iq < k; iq++)
+          v(iq) = 1e0 / (double)((iq + 1) * (iq + 2));
+        std::memcpy(w(), v(), sizeof(double) * k);
+      } else {
+        // if order was raised, update diagonal part of v(*)
+        if (k > kold) {
+          v(k - 1) = 1e0 / (double)(k * kp1);
+          const int nsm2 = ns - 2;
+          if (nsm2 > 0) {
+            int j = 1;
+            for (int i = k - 1; i >= k - nsm2; i--) {
+              v(i - 1) -= alpha(j) * v(i);
+              ++j;
+            }
+          }
+        }
+        // update v(*) and set w(*)
+        const int limit1 = kp1 - ns;
+        const double tmp5 = alpha(ns - 1);
+        for (int iq = 0; iq < limit1; iq++)
+          v(iq) -= tmp5 * v(iq + 1);
+        std::memcpy(w(), v(), sizeof(double) * limit1);
+        g(nsp1 - 1) = w(0);
+      }
+
+      // compute the g(*) in the work vector w(*)
+      const int nsp2 = ns + 2;
+      if (kp1 >= nsp2) {
+        for (int i = nsp2; i <= kp1; i++) {
+          const int limit2 = kp2 - i;
+          const double tmp6 = alpha(i - 2);
+          for (int iq = 0; iq < limit2; iq++)
+            w(iq) -= tmp6 * w(iq + 1);
+          g(i - 1) = w(0);
+        }
+      }
+    } // if (k >= ns)
+    // ***     end block 1     ***
+
+    // ***     begin block 2     ***
+    // predict a solution p(*), evaluate derivatives using predicted
+    // solution, estimate local error at order k and errors at orders k,
+    // k-1, k-2 as if constant step size were used.
+
+    // change phi to phi star
+    if (k >= nsp1) {
+      for (int i = nsp1 - 1; i < k; i++)
+        Phi.col(i) *= beta(i);
+    }
+
+    // predict solution and differences
+    Phi.col(kp2 - 1) = Phi.col(kp1 - 1);
+    Phi.col(kp1 - 1).setZero();
+    p.setZero();
+    for (int i = k - 1; i >= 0; i--) {
+      p += g(i) * Phi.col(i);
+      Phi.col(i) += Phi.col(i + 1);
+    }
+
+    if (!nornd) {
+      const Vector tau = h * p - Phi.col(14);
+      p = yy + tau;
+      Phi.col(15) = (p - yy) - tau;
+    } else {
+      p = yy + h * p;
+    }
+    xold = x;
+    x += h;
+    absh = std::abs(h);
+    f(x, p, yp);
+    ++stats.nfev;
+
+    // estimate errors at orders k,k-1,k-2
+    erkm2 = 0e0;
+    erkm1 = 0e0;
+    {
+      const Eigen::Array<double, N, 1> t4array = yp.array() - Phi.col(0).array();
+      erk = (t4array / wt.array()).matrix().squaredNorm();
+      if (!km2 || km2 > 0) {
+        erkm1 = absh * sig(k - 1) * gstr[km1 - 1] *
+                ((Phi.col(k - 1).array() + t4array) / wt.array())
+                    .matrix()
+                    .norm();
+      }
+      if (km2 > 0) {
+        erkm2 = absh * sig(km1 - 1) * gstr[km2 - 1] *
+                ((Phi.col(km1 - 1).array() + t4array) / wt.array())
+                    .matrix()
+                    .norm();
+      }
+    }
+    const double t5 = absh * std::sqrt(erk);
+    const double err = t5 * (g(k - 1) - g(kp1 - 1));
+    erk = t5 * sig(kp1 - 1) * gstr[k - 1];
+    knew = k;
+
+    // test if order should be lowered
+    if (km2 > 0) {
+      if (std::max(erkm1, erkm2) <= erk)
+        knew = km1;
+    } else if (km2 == 0) {
+      if (erkm1 <= 5e-1 * erk)
+        knew = km1;
+    }
+
+    step_success = (err <= eps);
+    errn = err / eps;
+    // ***     end block 2     ***
+
+    // ***     begin block 3     ***
+    // the step is unsuccessful.  restore  x, phi(*,*), psi(*) .
+    // if third consecutive failure, set order to one.  if step fails more
+    // than three times, consider an optimal step size.  double error
+    // tolerance and return if estimated step size is too small for machine
+    // precision.
+    if (!step_success) {
+      ++stats.nreject;
+      phase1 = false;
+      x = xold;
+      for (int i = 0; i < k; i++)
+        Phi.col(i) = (1e0 / beta(i)) * (Phi.col(i) - Phi.col(i + 1));
+      if (k >= 2) {
+        for (int i = 1; i < k; i++)
+          psi(i - 1) = psi(i) - h;
+      }
+
+      // on third failure, set order to one.  thereafter, use optimal step
+      // size
+      ++ifail;
+      double t2 = 5e-1;
+      if (ifail == 3) {
+        knew = 1;
+      } else if (ifail < 3) {
+        if (p5eps < 0.25 * erk)
+          t2 = std::sqrt(p5eps / erk);
+        knew = 1;
+      }
+      h = t2 * h;
+      k = knew;
+
+      if (!(std::abs(h) >= fouru * std::abs(x))) {
+        crash = true;
+        h = std::copysign(fouru * std::abs(x), h);
+        eps += eps;
+        return 1;
+      }
+    }
+    // ***     end block 3     ***
+  } while (!step_success);
+
+  // ***    begin block 4     ***
+  // the step is successful.  correct the predicted solution, evaluate
+  // the derivatives using the corrected solution and update the
+  // differences.  determine best order and step size for next step.
+  if (kold && k != kold)
+    ++stats.norder_changes;
+  kold = k;
+  hold = h;
+  stats.accepted(x, h, k, errn);
+
+  // correct and evaluate
+  const double t1 = h * g(kp1 - 1);
+  if (!nornd) {
+    const Vector rho = t1 * (yp - Phi.col(0)) - Phi.col(15);
+    yy = p + rho;
+    Phi.col(14) = (yy - p) - rho;
+  } else {
+    yy = p + t1 * (yp - Phi.col(0));
+  }
+  f(x, yy, yp);
+  ++stats.nfev;
+
+  // update differences for next step
+  Phi.col(kp1 - 1) = yp - Phi.col(0);
+  Phi.col(kp2 - 1) = Phi.col(kp1 - 1) - Phi.col(kp2 - 1);
+  for (int i = 0; i < k; i++)
+    Phi.col(i) += Phi.col(kp1 - 1);
+
+  // estimate error at order k+1 unless:
+  //   in first phase when always raise order,
+  //   already decided to lower order,
+  //   step size not constant so estimate unreliable
+  double erkp1 = 0e0;
+  if (knew == km1 || k == 12)
+    phase1 = false;
+
+  int new_degree = 999;
+  if (phase1) {
+    new_degree = 1;
+  } else if (knew == km1) {
+    new_degree = -1;
+  } else if (kp1 > ns) {
+    new_degree = 0;
+  }
+
+  if (new_degree == 999) {
+    erkp1 = absh * gstr[kp1 - 1] *
+            (Phi.col(kp2 - 1).array() / wt.array()).matrix().norm();
+    if (k > 1) {
+      if (erkm1 <= std::min(erk, erkp1)) {
+        new_degree = -1;
+      } else if (erkp1 >= erk || k == 12) {
+        new_degree = 0;
+      } else {
+        new_degree = 1;
+      }
+    } else if (erkp1 >= 5e-1 * erk) {
+      new_degree = 0;
+    } else {
+      new_degree = 1;
+    }
+  }
+
+  switch (new_degree) {
+  case -1:
+    k = km1;
+    erk = erkm1;
+    break;
+  case 0:
+    break;
+  case 1:
+    k = kp1;
+    erk = erkp1;
+  }
+
+  // with new order determine appropriate step size for next step
+  double hnew;
+  if (phase1 || p5eps >= erk * (double)(1 << (k + 1))) {
+    hnew = 2e0 * h;
+  } else {
+    if (p5eps < erk) {
+      const double r = std::pow(p5eps / erk, 1e0 / (double)(k + 1));
+      hnew = absh * std::max(0.5e0, std::min(0.9e0, r));
+      hnew = std::copysign(std::max(hnew, fouru * std::abs(x)), h);
+    } else {
+      hnew = h;
+    }
+  }
+
+  h = hnew;
+  return 0;
+}
+
+template <int N, typename F>
+int SGOdeN<N, F>::intrp(double xout, Vector &yout) noexcept {
+  double gi[13], wi[13], rho[13];
+
+  const double hi = xout - x;
+  const int ki = kold + 1;
+  const int kip1 = ki + 1;
+
+  gi[0] = 1e0;
+  rho[0] = 1e0;
+
+  // initialize w(*) for computing g(*)
+  for (int i = 0; i < ki; i++)
+    wi[i] = 1e0 / (double)(i + 1);
+
+  // compute g(*)
+  double term = 0e0;
+  for (int j = 1; j < ki; j++) {
+    const int jm1 = j - 1;
+    const double psijm1 = psi(jm1);
+    const double gamma = (hi + term) / psijm1;
+    const double eta = hi / psijm1;
+    const int limit = kip1 - j;
+    for (int i = 0; i < limit - 1; i++)
+      wi[i] = gamma * wi[i] - eta * wi[i + 1];
+    gi[j] = wi[0];
+    rho[j] = gamma * rho[jm1];
+    term = psijm1;
+  }
+
+  // interpolate
+  ypout.setZero();
+  yout.setZero();
+  for (int j = 0; j < ki; j++) {
+    const int i = kip1 - j - 2;
+    yout += gi[i] * Phi.col(i);
+    ypout += rho[i] * Phi.col(i);
+  }
+  yout = yy + hi * yout;
+
+  return 0;
+}
+
+} // namespace dso
+
+#endif
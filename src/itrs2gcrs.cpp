@@ -1,5 +1,6 @@
 #include "eop.hpp"
 #include "orbit_integration.hpp"
+#include "c2t_table.hpp"
 #include "datetime/utcdates.hpp"
 #include "iers2010/iers2010.hpp"
 #include "iers2010/iau.hpp"
@@ -159,63 +160,30 @@ int dso::gcrs2itrs(double mjd_tai, const dso::EopLookUpTable &eop_table,
                    double &era,
                    Eigen::Matrix<double, 3, 3> &rpom, double &xlod) noexcept {
 
-  // TAI MJD to datetime instance
-  int imjd = (int)mjd_tai;
-  double sec = (mjd_tai - (int)mjd_tai) * 86400e0;
-  dso::nanoseconds::underlying_type iSec =
-      static_cast<dso::nanoseconds::underlying_type>(
-          sec * dso::nanoseconds::template sec_factor<double>());
-  dso::datetime<dso::nanoseconds> taidate{dso::modified_julian_day(imjd),
-                                          dso::nanoseconds(iSec)};
-
-  // TAI to TT
-  dso::datetime<dso::nanoseconds> ttdate(taidate);
-  ttdate.add_seconds(dso::nanoseconds(32184 * 1'000'000L));
-
-  // interpolate/correct EOP values using TT
-  dso::EopRecord eops;
-  if (int error; (error = eop_table.interpolate(ttdate.as_mjd(), eops))) {
-    fprintf(stderr, "ERROR. Failed getting EOP values (status: %d)\n", error);
+  // EOP interpolation, X/Y series, s and s'
+  dso::CelTerQuantities q;
+  if (int error; (error = dso::c2t_quantities(mjd_tai, eop_table, q)))
     return error;
-  }
 
   // assign interpolated LOD value
-  xlod = eops.lod;
-
-  // X,Y coordinates of celestial intermediate pole from series based
-  // on IAU 2006 precession and IAU 2000A nutation.
-  double X, Y;
-  iers2010::sofa::xy06(dso::mjd0_jd, ttdate.as_mjd(), X, Y);
+  xlod = q.lod;
 
-  // The CIO locator s, positioning the Celestial Intermediate Origin on
-  // the equator of the Celestial Intermediate Pole, given the CIP's X,Y
-  // coordinates. Compatible with IAU 2006/2000A precession-nutation.
-  const double s = iers2010::sofa::s06(dso::mjd0_jd, ttdate.as_mjd(), X, Y);
-
-  // Add CIP corrections (arcsec to radians)
-  X += dso::arcsec2rad(eops.dx);
-  Y += dso::arcsec2rad(eops.dy);
-
-  // Form the celestial to intermediate-frame-of-date matrix given the CIP
-  // X,Y and the CIO locator s.
   // [TRS] = RPOM * R_3(ERA) * rc2i * [CRS]  = RC2T * [CRS]
-  rc2i = iers2010::sofa::c2ixys_e(X, Y, s);
-
-  // call ERA00 to get the ERA rotation angle (need UT1 datetime)
-  dso::modified_julian_day utc_mjd;
-  const double utc = dso::tai2utc(taidate, utc_mjd); // fractional part
-  double ut1 = utc + (eops.dut / 86400e0); // add UT1-UTC, interpolated
-  ut1 += static_cast<double>(utc_mjd.as_underlying_type()); // UTC as mjd
-  era = iers2010::sofa::era00(dso::mjd0_jd, ut1);
-
-  // Estimate s' [radians]
-  const double sp = iers2010::sofa::sp00(dso::mjd0_jd, ttdate.as_mjd());
+  dso::c2t_matrices(mjd_tai, q, rc2i, era, rpom);
 
-  // Form the polar motion matrix (W); note that we need angular units in 
-  // radians
-  rpom = iers2010::sofa::pom00_e(dso::arcsec2rad(eops.xp),
-                                 dso::arcsec2rad(eops.yp), sp);
+  return 0;
+}
 
+// IAU 2006/2000A, CIO based, using a Chebyshev fit of X,Y and s
+int dso::gcrs2itrs(double mjd_tai, const dso::EopLookUpTable &eop_table,
+                   const dso::CipChebyshev &cip,
+                   Eigen::Matrix<double, 3, 3> &rc2i, double &era,
+                   Eigen::Matrix<double, 3, 3> &rpom, double &xlod) noexcept {
+  dso::CelTerQuantities q;
+  if (int error; (error = dso::c2t_quantities(mjd_tai, eop_table, q, &cip)))
+    return error;
+  xlod = q.lod;
+  dso::c2t_matrices(mjd_tai, q, rc2i, era, rpom);
   return 0;
 }
 #endif
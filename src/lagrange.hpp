@@ -0,0 +1,39 @@
+#ifndef __DSO_LAGRANGE_WEIGHTS_HPP__
+#define __DSO_LAGRANGE_WEIGHTS_HPP__
+
+namespace dso {
+
+/// @brief Lagrange interpolation weights (i.e. the Lagrange basis
+///        polynomials) at x, for the np nodes xk[0], ..., xk[np-1]:
+///        w_j = Π_{k≠j} (x - x_k) / (x_j - x_k)
+///        so that Σ w_j f(x_j) is the interpolated value of f at x.
+/// @param[in] x Interpolation point
+/// @param[in] xk Array of np (distinct) nodes
+/// @param[in] np Number of nodes (aka order+1)
+/// @param[out] w Array of (at least) np weights
+inline void lagrange_weights(double x, const double *xk, int np,
+                             double *w) noexcept {
+  for (int j = 0; j < np; j++) {
+    double wj = 1e0;
+    for (int k = 0; k < np; k++)
+      if (k != j)
+        wj *= (x - xk[k]) / (xk[j] - xk[k]);
+    w[j] = wj;
+  }
+}
+
+/// @brief Same as above, for the (uniform) nodes 0, 1, ..., np-1; x is thus
+///        given in units of the node spacing, relative to the first node.
+inline void lagrange_weights(double x, int np, double *w) noexcept {
+  for (int j = 0; j < np; j++) {
+    double wj = 1e0;
+    for (int k = 0; k < np; k++)
+      if (k != j)
+        wj *= (x - k) / (double)(j - k);
+    w[j] = wj;
+  }
+}
+
+} // namespace dso
+
+#endif
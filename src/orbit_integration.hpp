@@ -7,15 +7,98 @@
 #include "satellites.hpp"
 #include "satellites/jason3_quaternions.hpp"
 #include "atmosphere.hpp"
+#include "time_scales.hpp"
 #include "eigen3/Eigen/Eigen"
 #include <cassert>
 
 namespace dso {
 
+struct EnsembleWorkspace;
+struct EnckeReference;
+class CelTerTable;
+class CipChebyshev;
+class SpkCursor;
+class SunMoonTable;
+
+/// @brief Source of the Sun and Moon positions used in the force model (see
+///        dso::sun_moon_positions), from the fastest to the most accurate
+enum class EphemerisTier : char {
+  /// analytic series (dso::sun_vector_montenbruck, dso::moon_vector_approx);
+  /// errors of ~0.1 deg for the Sun, a few arcmin and ~500 km for the Moon
+  Analytic,
+  /// per-arc Chebyshev table of the planetary ephemeris (see
+  /// dso::SunMoonTable); the planetary ephemeris is used where the table
+  /// is not available
+  CachedSpk,
+  /// planetary ephemeris, at every evaluation
+  ExactSpk
+}; // EphemerisTier
+
+/// @brief Position-independent (aka time-only) quantities of the force model
+///        used in dso::VariationalEquations, cached by evaluation time (see
+///        dso::update_time_cache).
+///
+/// The (multistep) integrators evaluate the right-hand side repeatedly at
+/// the same time (e.g. predictor and corrector of dso::SGOde), so that these
+/// quantities can be reused. If window is larger than zero, they are also
+/// reused for evaluation times within window seconds of the cached epoch;
+/// the Earth Rotation Angle is then extrapolated (see era_at), while the
+/// remaining quantities (precession-nutation and polar motion, Sun/Moon
+/// positions, attitude, space-weather input) are used as they are.
+struct ForceModelTimeCache {
+  /// epoch of the cached quantities, TAI MJD; negative if empty
+  double mjd_tai{-1e0};
+  /// reuse window [sec]
+  double window{0e0};
+  /// celestial-to-terrestrial transformation (see dso::gcrs2itrs)
+  Eigen::Matrix<double, 3, 3> rc2i, rpom;
+  double era, xlod;
+  /// Sun and Moon positions, J2000 [m]
+  Eigen::Matrix<double, 3, 1> rsun, rmon;
+  /// attitude quaternion and the status of its retrieval
+  Eigen::Quaternion<double> q;
+  int qerror;
+  /// input parameters of the atmospheric model (date/time and space
+  /// weather; the spatial part is set per evaluation)
+  dso::nrlmsise00::detail::InParamsCore atm;
+  /// number of evaluations served from the cache, and recomputations
+  long nhits{0}, nmisses{0};
+
+  /// @brief Earth Rotation Angle at mjd (within the window) [rad]
+  double era_at(double mjd) const noexcept {
+    // rate of ERA, [rad/sec]
+    constexpr const double era_rate =
+        2e0 * 3.141592653589793238462643e0 * 1.00273781191135448e0 /
+        86400e0;
+    return era + era_rate * (mjd - mjd_tai) * 86400e0;
+  }
+
+  /// @brief Drop cached quantities
+  void clear() noexcept { mjd_tai = -1e0; }
+}; // ForceModelTimeCache
+
 /// @brief A structure to hold orbit integration parameters; it is a
 ///        collection of data and parameters to be used in the computation
 ///        of (the system of) variational equations.
 struct IntegrationParameters {
+  /// @brief How the state transition (and sensitivity) matrix is computed
+  ///        within dso::VariationalEquations. In all cases the state is
+  ///        integrated using the full force model.
+  enum class StmMode : char {
+    /// variational equations use the partials of the full force model
+    Full,
+    /// variational equations use a reduced force model, i.e. central body
+    /// + J2 and drag partials (the density gradient being approximated by
+    /// a single, radial difference); the matrices can then be integrated at
+    /// a looser tolerance (see SGOde::wscale)
+    Reduced,
+    /// variational equations use the partials of the two-body + J2 field
+    /// only (no drag, third-body or sensitivity terms); cheaper than
+    /// Reduced (no extra density evaluations), and the matrices can as well
+    /// be integrated at a looser tolerance
+    J2
+  };
+
   ///< time in TAI
   double mjd_tai;
   ///< EOP parameters Look-up table
@@ -34,11 +117,44 @@ struct IntegrationParameters {
   int numMacroModelComponents{0};
   dso::JasonQuaternionHunter *qhunt{nullptr};
   const double *SatMass{nullptr};
-  /// Drag-related stuff
+  /// Drag-related stuff; drag is only modelled (in dso::VariationalEquations)
+  /// if both AtmDataFeed and nrlmsise00 are set
   dso::nrlmsise00::InParams<
-      dso::nrlmsise00::detail::FluxDataFeedType::ST_CSV_SW> *AtmDataFeed;
-  dso::Nrlmsise00 *nrlmsise00;
+      dso::nrlmsise00::detail::FluxDataFeedType::ST_CSV_SW> *AtmDataFeed{
+      nullptr};
+  dso::Nrlmsise00 *nrlmsise00{nullptr};
   const double *drag_coef{nullptr};
+  /// State transition matrix computation mode
+  StmMode stm_mode{StmMode::Full};
+  /// Work space for ensemble propagation (see dso::EnsembleEquations)
+  dso::EnsembleWorkspace *ensemble{nullptr};
+  /// Reference orbit for Encke-type propagation (see dso::EnckeEquations)
+  dso::EnckeReference *encke{nullptr};
+  /// Cache of time-only force model quantities
+  dso::ForceModelTimeCache time_cache;
+  /// Time-scale conversions (TAI/TT/UTC/UT1/GPS); to be shared by all
+  /// callers using these parameters
+  dso::TimeScaleConverter time_scales{&eopLUT};
+  /// Tabulated celestial-to-terrestrial transformation for the arc; if set,
+  /// it is used instead of dso::gcrs2itrs for epochs it covers
+  const dso::CelTerTable *c2t_table{nullptr};
+  /// Chebyshev fit of the CIP X, Y and s for the arc; if set, it is used
+  /// instead of the series for epochs it covers (and the table above does
+  /// not)
+  const dso::CipChebyshev *cip_fit{nullptr};
+  /// High-rate (pre-corrected) EOP table for the arc; if set, EOP values
+  /// for the epochs it covers (and the c2t_table does not) are interpolated
+  /// off of it, instead of evaluating the sub-daily (tidal and libration)
+  /// corrections via eopLUT
+  const dso::EopHighRateTable *eop_high_rate{nullptr};
+  /// Source of Sun/Moon positions; the default falls back to the planetary
+  /// ephemeris when no table is set
+  dso::EphemerisTier ephemeris_tier{dso::EphemerisTier::CachedSpk};
+  /// Tabulated Sun/Moon positions for the arc, used for the CachedSpk tier
+  const dso::SunMoonTable *sun_moon_table{nullptr};
+  /// Native SPK reader (one per thread); if set, it is used instead of
+  /// CSPICE for the planetary ephemeris
+  dso::SpkCursor *spk_cursor{nullptr};
 
   IntegrationParameters(int degree_, int order_,
                         const dso::EopLookUpTable &eoptable_,
@@ -95,6 +211,14 @@ int gcrs2itrs(double mjd_tai, const dso::EopLookUpTable &eop_table,
             Eigen::Matrix<double, 3, 3> &rpom) noexcept;
 #endif
 
+/// @brief Same as above, but computing the CIP X, Y and the CIO locator s
+///        off of a Chebyshev fit (see dso::CipChebyshev), for the epochs it
+///        covers (the series are used otherwise)
+int gcrs2itrs(double mjd_tai, const dso::EopLookUpTable &eop_table,
+              const dso::CipChebyshev &cip, Eigen::Matrix<double, 3, 3> &rc2i,
+              double &era, Eigen::Matrix<double, 3, 3> &rpom,
+              double &xlod) noexcept;
+
 
 Eigen::Matrix<double, 3, 1>
 rcel2ter(const Eigen::Matrix<double, 3, 1> r,
@@ -126,6 +250,47 @@ yter2cel(const Eigen::Matrix<double, 6, 1> y,
 #endif
         const Eigen::Matrix<double, 3, 3> &rpom) noexcept;
 #endif
+/// @brief Position vectors of Sun and Moon (w.r.t. Earth), in J2000 [m]
+/// @warning The function asserts that the respectice SPICE kernels are
+///        already loaded (see dso::SunMoon).
+/// @param[in] mjd_tai TAI date as MJD
+/// @param[out] sun_pos Sun position in J2000 [m]
+/// @param[out] mon_pos Moon position in J2000 [m]
+/// @return Anything other than 0 denotes an error (e.g. epoch not covered by
+///         the loaded kernels; only reported if the CSPICE error action is
+///         not ABORT, see erract_c)
+int sun_moon_positions(double mjd_tai, Eigen::Matrix<double, 3, 1> &sun_pos,
+                       Eigen::Matrix<double, 3, 1> &mon_pos) noexcept;
+
+/// @brief Same as above, but using a native SPK reader (see dso::SpkCursor)
+///        instead of CSPICE; no kernels need to be loaded, and calls using
+///        different cursors may run concurrently.
+/// @return Anything other than 0 denotes an error (epoch not covered)
+int sun_moon_positions(double mjd_tai, dso::SpkCursor &spk,
+                       Eigen::Matrix<double, 3, 1> &sun_pos,
+                       Eigen::Matrix<double, 3, 1> &mon_pos) noexcept;
+
+/// @brief Position vectors of Sun and Moon (w.r.t. Earth), in J2000 [m],
+///        using the analytic series (see dso::EphemerisTier::Analytic)
+void sun_moon_positions_analytic(double mjd_tai,
+                                 Eigen::Matrix<double, 3, 1> &sun_pos,
+                                 Eigen::Matrix<double, 3, 1> &mon_pos) noexcept;
+
+/// @brief Position vectors of Sun and Moon (w.r.t. Earth), in J2000 [m],
+///        using the given ephemeris tier
+/// @param[in] mjd_tai TAI date as MJD
+/// @param[in] tier Source of positions
+/// @param[in] table Sun/Moon table, for the CachedSpk tier (may be nullptr)
+/// @param[in] spk Native SPK reader for the planetary ephemeris; if nullptr,
+///            CSPICE is used (kernels should be loaded)
+/// @param[out] sun_pos Sun position in J2000 [m]
+/// @param[out] mon_pos Moon position in J2000 [m]
+/// @return Anything other than 0 denotes an error
+int sun_moon_positions(double mjd_tai, dso::EphemerisTier tier,
+                       const dso::SunMoonTable *table, dso::SpkCursor *spk,
+                       Eigen::Matrix<double, 3, 1> &sun_pos,
+                       Eigen::Matrix<double, 3, 1> &mon_pos) noexcept;
+
 /// @brief Comnpute third-body, Sun- and Moon- induced acceleration on an
 ///        orbiting satellite.
 /// @warning Note that the function asserts that the respectice SPICE kernels
@@ -148,10 +313,49 @@ void SunMoon(double mjd_tai, const Eigen::Matrix<double, 3, 1> &rsat,
              Eigen::Matrix<double, 3, 1> &sun_pos,
              Eigen::Matrix<double, 3, 3> &mon_partials) noexcept;
 
+/// @brief Same as above, but taking Sun and Moon positions off of a
+///        (per-arc) table (see dso::SunMoonTable); the planetary ephemeris
+///        is only used for epochs the table does not cover.
+void SunMoon(double mjd_tai, const dso::SunMoonTable &table,
+             const Eigen::Matrix<double, 3, 1> &rsat, double GMSun,
+             double GMMon, Eigen::Matrix<double, 3, 1> &sun_acc,
+             Eigen::Matrix<double, 3, 1> &mon_acc,
+             Eigen::Matrix<double, 3, 1> &sun_pos,
+             Eigen::Matrix<double, 3, 3> &mon_partials) noexcept;
+
+/// @brief Same as above, but using already computed Sun and Moon positions
+///        (J2000, [m]); the sun_pos output argument is not needed then.
+void SunMoon(const Eigen::Matrix<double, 3, 1> &sun_pos,
+             const Eigen::Matrix<double, 3, 1> &mon_pos,
+             const Eigen::Matrix<double, 3, 1> &rsat, double GMSun,
+             double GMMon, Eigen::Matrix<double, 3, 1> &sun_acc,
+             Eigen::Matrix<double, 3, 1> &mon_acc,
+             Eigen::Matrix<double, 3, 3> &mon_partials) noexcept;
+
+/// @brief Get the time-only quantities of the force model for the given
+///        epoch, from params.time_cache if valid (see
+///        dso::ForceModelTimeCache), else recompute and cache them.
+/// @param[in] mjd_tai TAI date as MJD
+/// @param[in] params Integration parameters; uses the EOP look-up table (or
+///            the celestial-to-terrestrial table, or the high-rate EOP
+///            table, if set), the quaternion hunter and the atmospheric data
+///            feed (if set; qerror is non-zero without a quaternion hunter)
+/// @return The (updated) cache, aka params.time_cache
+const ForceModelTimeCache &
+update_time_cache(double mjd_tai, dso::IntegrationParameters &params) noexcept;
+
 void VariationalEquations(double tsec, const Eigen::VectorXd &yPhi,
                           Eigen::Ref<Eigen::VectorXd> yPhiP,
                           dso::IntegrationParameters &params) noexcept;
 
+/// @brief Same as above, but operating on raw (contiguous) arrays of size
+///        6 + 6 * (6 + Np). Meant to be called from fixed-size storage (e.g.
+///        from within a dso::SGOdeN callable), without creating temporary
+///        dynamic Eigen vectors:
+///          VariationalEquations(t, y.data(), yp.data(), params);
+void VariationalEquations(double tsec, const double *yPhi, double *yPhiP,
+                          dso::IntegrationParameters &params) noexcept;
+
 } // namespace dso
 
 #endif
@@ -66,6 +66,12 @@ namespace cspice {
     double dummy;
     // get the position of the planet
     spkezp_c(target_id, et, "J2000", "NONE", observer_id, pos, &dummy);
+    // a failure (e.g. no data for the epoch) is only signaled here if the
+    // CSPICE error action is not ABORT (see erract_c)
+    if (failed_c()) {
+      reset_c();
+      return 1;
+    }
     return 0;
   }
 }// spice
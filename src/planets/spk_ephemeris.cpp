@@ -0,0 +1,344 @@
+#include "spk_ephemeris.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+/// DAF record length [bytes] and [doubles]
+constexpr const long daf_record_bytes = 1024;
+constexpr const long daf_record_words = daf_record_bytes / 8;
+/// maximum number of Chebyshev coefficients per component
+constexpr const int max_coef = 64;
+/// maximum length of a target/observer chain (e.g. Moon -> EMB -> SSB)
+constexpr const int max_depth = 8;
+
+/// ET - TT parameters, as in the NAIF leap-second kernels (DELTET/K,
+/// DELTET/EB and DELTET/M)
+constexpr const double deltet_k = 1.657e-3;
+constexpr const double deltet_eb = 1.671e-2;
+constexpr const double deltet_m0 = 6.239996e0;
+constexpr const double deltet_m1 = 1.99096871e-7;
+
+bool host_is_little_endian() noexcept {
+  const std::uint16_t x = 1;
+  unsigned char c;
+  std::memcpy(&c, &x, 1);
+  return c == 1;
+}
+
+/// A Chebyshev record of a segment
+struct RecordRef {
+  const dso::SpkReader::Segment *seg;
+  const double *coef;
+};
+
+/// the record of a segment covering et
+const double *record_of(const dso::SpkReader::Segment &seg,
+                        double et) noexcept {
+  int idx = (int)std::floor((et - seg.init) / seg.intlen);
+  if (idx == seg.nrec)
+    idx = seg.nrec - 1;
+  if (idx < 0 || idx >= seg.nrec)
+    return nullptr;
+  return seg.data + (long)idx * seg.rsize;
+}
+
+/// Evaluate a (type 2 or 3) Chebyshev record at et, adding sign * position
+/// (and velocity) to pos (and vel)
+void evaluate(const RecordRef &r, double et, double sign, double *pos,
+              double *vel) noexcept {
+  const double mid = r.coef[0];
+  const double radius = r.coef[1];
+  const int ncomp = (r.seg->type == 2) ? 3 : 6;
+  const int n = (r.seg->rsize - 2) / ncomp;
+  const double *c = r.coef + 2;
+
+  // Chebyshev polynomials (and derivatives) at the normalized epoch
+  double T[max_coef], dT[max_coef];
+  const double s = (et - mid) / radius;
+  T[0] = 1e0;
+  dT[0] = 0e0;
+  if (n > 1) {
+    T[1] = s;
+    dT[1] = 1e0;
+  }
+  for (int k = 2; k < n; k++) {
+    T[k] = 2e0 * s * T[k - 1] - T[k - 2];
+    dT[k] = 2e0 * T[k - 1] + 2e0 * s * dT[k - 1] - dT[k - 2];
+  }
+
+  for (int i = 0; i < 3; i++) {
+    const double *ci = c + i * n;
+    double p = 0e0;
+    for (int k = n - 1; k >= 0; k--)
+      p += ci[k] * T[k];
+    pos[i] += sign * p;
+    if (vel) {
+      double v = 0e0;
+      if (ncomp == 6) {
+        // type 3, velocity coefficients follow
+        const double *cv = c + (3 + i) * n;
+        for (int k = n - 1; k >= 0; k--)
+          v += cv[k] * T[k];
+      } else {
+        for (int k = n - 1; k >= 1; k--)
+          v += ci[k] * dT[k];
+        v /= radius;
+      }
+      vel[i] += sign * v;
+    }
+  }
+}
+
+/// Position (and velocity) of target relative to observer, chaining
+/// segments (body -> center) up to the first common body; get(body, et)
+/// resolves the record of a body (seg is nullptr if none)
+template <typename Resolver>
+int geometric(double et, int target, int observer, double *pos, double *vel,
+              Resolver &&get) noexcept {
+  pos[0] = pos[1] = pos[2] = 0e0;
+  if (vel)
+    vel[0] = vel[1] = vel[2] = 0e0;
+  if (target == observer)
+    return 0;
+
+  // chains of (body, record) up to the root of each
+  RecordRef tchain[max_depth], ochain[max_depth];
+  int tbody[max_depth], obody[max_depth];
+  int nt = 0, no = 0;
+  int troot = target, oroot = observer;
+  for (RecordRef r; nt < max_depth && (r = get(troot, et)).seg;) {
+    tbody[nt] = troot;
+    tchain[nt++] = r;
+    troot = r.seg->center;
+  }
+  for (RecordRef r; no < max_depth && (r = get(oroot, et)).seg;) {
+    obody[no] = oroot;
+    ochain[no++] = r;
+    oroot = r.seg->center;
+  }
+  if (troot != oroot) {
+    fprintf(stderr,
+            "[ERROR] Cannot relate bodies %d and %d at ET=%.3f, via the "
+            "loaded SPK segments (traceback: %s)\n",
+            target, observer, et, __func__);
+    return 1;
+  }
+
+  // drop the common part of the chains
+  while (nt && no && tbody[nt - 1] == obody[no - 1]) {
+    --nt;
+    --no;
+  }
+
+  for (int i = 0; i < nt; i++)
+    evaluate(tchain[i], et, 1e0, pos, vel);
+  for (int i = 0; i < no; i++)
+    evaluate(ochain[i], et, -1e0, pos, vel);
+
+  return 0;
+}
+} // unnamed namespace
+
+double dso::tt2et(double mjd_tt) noexcept {
+  // TT seconds past J2000
+  const double tt = (mjd_tt - 51544.5e0) * 86400e0;
+  const double m = deltet_m0 + deltet_m1 * tt;
+  return tt + deltet_k * std::sin(m + deltet_eb * std::sin(m));
+}
+
+int dso::SpkReader::open(const char *spkfn) noexcept {
+  close();
+
+  const int fd = ::open(spkfn, O_RDONLY);
+  if (fd < 0) {
+    fprintf(stderr, "[ERROR] Failed opening SPK file %s (traceback: %s)\n",
+            spkfn, __func__);
+    return 1;
+  }
+  struct stat st;
+  if (fstat(fd, &st) || st.st_size < daf_record_bytes) {
+    fprintf(stderr, "[ERROR] Invalid SPK file %s (traceback: %s)\n", spkfn,
+            __func__);
+    ::close(fd);
+    return 1;
+  }
+  void *ptr = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+  ::close(fd);
+  if (ptr == MAP_FAILED) {
+    fprintf(stderr, "[ERROR] Failed mapping SPK file %s (traceback: %s)\n",
+            spkfn, __func__);
+    return 1;
+  }
+  map = ptr;
+  map_size = st.st_size;
+  const char *bytes = static_cast<const char *>(map);
+  const double *words = static_cast<const double *>(map);
+
+  // file record
+  std::int32_t nd, ni, fward;
+  std::memcpy(&nd, bytes + 8, 4);
+  std::memcpy(&ni, bytes + 12, 4);
+  std::memcpy(&fward, bytes + 76, 4);
+  const bool native_order =
+      !std::strncmp(bytes + 88, host_is_little_endian() ? "LTL-IEEE"
+                                                        : "BIG-IEEE",
+                    8);
+  if (std::strncmp(bytes, "DAF/SPK", 7) || !native_order || nd != 2 ||
+      ni != 6) {
+    fprintf(stderr,
+            "[ERROR] File %s is not a (native byte order) DAF/SPK file "
+            "(traceback: %s)\n",
+            spkfn, __func__);
+    close();
+    return 1;
+  }
+  const long nwords = map_size / 8;
+  const int ss = nd + (ni + 1) / 2;
+
+  // summary records (doubly linked list)
+  for (long rec = fward, nrecs = 0; rec > 0; nrecs++) {
+    if (rec * daf_record_words > nwords || nrecs > nwords / daf_record_words) {
+      fprintf(stderr,
+              "[ERROR] Corrupt summary records in SPK file %s (traceback: "
+              "%s)\n",
+              spkfn, __func__);
+      close();
+      return 1;
+    }
+    const double *r = words + (rec - 1) * daf_record_words;
+    const int nsum = (int)r[2];
+    if (nsum < 0 || 3 + nsum * ss > daf_record_words) {
+      fprintf(stderr,
+              "[ERROR] Corrupt summary record in SPK file %s (traceback: %s)\n",
+              spkfn, __func__);
+      close();
+      return 1;
+    }
+    for (int i = 0; i < nsum; i++) {
+      const double *sum = r + 3 + i * ss;
+      std::int32_t ints[6];
+      std::memcpy(ints, sum + nd, sizeof(ints));
+
+      Segment seg;
+      seg.et_start = sum[0];
+      seg.et_end = sum[1];
+      seg.target = ints[0];
+      seg.center = ints[1];
+      seg.frame = ints[2];
+      seg.type = ints[3];
+      const long begin = ints[4], end = ints[5];
+      if (begin < 1 || end > nwords || end - begin < 4) {
+        fprintf(stderr,
+                "[ERROR] Invalid segment address range in SPK file %s "
+                "(traceback: %s)\n",
+                spkfn, __func__);
+        close();
+        return 1;
+      }
+      if ((seg.type != 2 && seg.type != 3) || seg.frame != 1) {
+        fprintf(stderr,
+                "[ERROR] Segment (target %d, center %d) of SPK file %s is of "
+                "type %d, frame %d; only types 2, 3 in J2000 (1) are handled "
+                "(traceback: %s)\n",
+                seg.target, seg.center, spkfn, seg.type, seg.frame, __func__);
+        close();
+        return 1;
+      }
+
+      // segment directory (last four words)
+      const double *meta = words + end - 4;
+      seg.init = meta[0];
+      seg.intlen = meta[1];
+      seg.rsize = (int)meta[2];
+      seg.nrec = (int)meta[3];
+      seg.data = words + begin - 1;
+      const int ncomp = (seg.type == 2) ? 3 : 6;
+      if (seg.nrec < 1 || seg.intlen <= 0e0 || (seg.rsize - 2) % ncomp ||
+          (seg.rsize - 2) / ncomp > max_coef ||
+          (begin - 1) + (long)seg.nrec * seg.rsize + 4 != end) {
+        fprintf(stderr,
+                "[ERROR] Invalid segment (target %d, center %d) in SPK file "
+                "%s (traceback: %s)\n",
+                seg.target, seg.center, spkfn, __func__);
+        close();
+        return 1;
+      }
+      segments.push_back(seg);
+    }
+    rec = (long)r[0];
+  }
+
+  return 0;
+}
+
+void dso::SpkReader::close() noexcept {
+  if (map)
+    munmap(map, map_size);
+  map = nullptr;
+  map_size = 0;
+  segments.clear();
+}
+
+const dso::SpkReader::Segment *dso::SpkReader::find(int body,
+                                                    double et) const noexcept {
+  // last segment in file order takes precedence
+  for (auto it = segments.rbegin(); it != segments.rend(); ++it)
+    if (it->target == body && et >= it->et_start && et <= it->et_end)
+      return &(*it);
+  return nullptr;
+}
+
+int dso::SpkReader::position(double et, int target, int observer, double *pos,
+                             double *vel) const noexcept {
+  return geometric(et, target, observer, pos, vel, [this](int body, double t) {
+    RecordRef r{find(body, t), nullptr};
+    if (r.seg && !(r.coef = record_of(*r.seg, t)))
+      r.seg = nullptr;
+    return r;
+  });
+}
+
+int dso::SpkCursor::position(double et, int target, int observer, double *pos,
+                             double *vel) noexcept {
+  return geometric(et, target, observer, pos, vel, [this](int body, double t) {
+    // cached record of the body
+    Record *slot = nullptr;
+    for (int i = 0; i < ncached; i++) {
+      if (cache[i].body == body) {
+        slot = cache + i;
+        break;
+      }
+    }
+    if (slot && t >= slot->t0 && t <= slot->t1) {
+      ++nhits;
+      return RecordRef{slot->seg, slot->coef};
+    }
+
+    // look-up and (re-)cache
+    ++nmisses;
+    RecordRef r{spk->find(body, t), nullptr};
+    if (!r.seg || !(r.coef = record_of(*r.seg, t)))
+      return RecordRef{nullptr, nullptr};
+    // note: NAIF ids can be negative (e.g. spacecraft), hence the unsigned
+    // cast when picking a slot to evict
+    if (!slot)
+      slot = (ncached < max_bodies)
+                 ? cache + ncached++
+                 : cache + (static_cast<unsigned>(body) % max_bodies);
+    const long idx = (r.coef - r.seg->data) / r.seg->rsize;
+    slot->body = body;
+    slot->seg = r.seg;
+    slot->coef = r.coef;
+    const double t0 = r.seg->init + idx * r.seg->intlen;
+    slot->t0 = std::max(t0, r.seg->et_start);
+    slot->t1 = std::min(t0 + r.seg->intlen, r.seg->et_end);
+    return r;
+  });
+}
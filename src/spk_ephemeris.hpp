@@ -0,0 +1,119 @@
+#ifndef __DSO_NATIVE_SPK_EPHEMERIS_HPP__
+#define __DSO_NATIVE_SPK_EPHEMERIS_HPP__
+
+#include <vector>
+
+namespace dso {
+
+/// @brief Ephemeris Time (TDB seconds past J2000) off of TT (MJD), using the
+///        same approximation as CSPICE (i.e. unitim_c, with the constants
+///        of the NAIF leap-second kernels), so that no LSK is needed.
+double tt2et(double mjd_tt) noexcept;
+
+/// @brief A native reader for (binary) JPL/NAIF SPK files, e.g. the DE4xx
+///        planetary ephemerides, holding type 2 (Chebyshev, position) and
+///        type 3 (Chebyshev, position and velocity) segments in the J2000
+///        frame.
+///
+/// The file is memory-mapped (read-only) and Chebyshev records are
+/// evaluated directly off of the mapping; there is no global state, hence
+/// an opened reader can be shared by any number of threads (all query
+/// methods are const). For repeated queries, use a dso::SpkCursor (one per
+/// thread), which caches the current record per body.
+///
+/// Only files in the native byte order are handled. As in CSPICE, if more
+/// than one segment covers a body at some epoch, the last one (in file
+/// order) is used.
+class SpkReader {
+public:
+  /// @brief An SPK segment
+  struct Segment {
+    /// coverage, ET (TDB seconds past J2000)
+    double et_start, et_end;
+    /// NAIF ids of target and center bodies, frame id and SPK type
+    int target, center, frame, type;
+    /// epoch of first record, record length [sec], record size [doubles]
+    /// and number of records
+    double init, intlen;
+    int rsize, nrec;
+    /// first record (within the mapping)
+    const double *data;
+  }; // Segment
+
+  SpkReader() noexcept = default;
+  ~SpkReader() noexcept { close(); }
+  SpkReader(const SpkReader &) = delete;
+  SpkReader &operator=(const SpkReader &) = delete;
+
+  /// @brief Map an SPK file and read its segment descriptors
+  /// @return Anything other than 0 denotes an error (e.g. not a DAF/SPK
+  ///         file, foreign byte order, unsupported segment type or frame)
+  int open(const char *spkfn) noexcept;
+
+  /// @brief Unmap the file (if any)
+  void close() noexcept;
+
+  /// @brief Number of segments
+  int num_segments() const noexcept { return segments.size(); }
+
+  /// @brief The i-th segment
+  const Segment &segment(int i) const noexcept { return segments[i]; }
+
+  /// @brief The segment for the given body at et, or nullptr
+  const Segment *find(int body, double et) const noexcept;
+
+  /// @brief Position (and velocity) of a target body relative to an
+  ///        observing body, in J2000, at the given ET (no aberration
+  ///        corrections), i.e. the same as CSPICE's spkezr_c/spkezp_c
+  /// @param[in] et ET (TDB seconds past J2000), see dso::tt2et
+  /// @param[in] target NAIF id of the target body
+  /// @param[in] observer NAIF id of the observing body
+  /// @param[out] pos Position [km]
+  /// @param[out] vel If not nullptr, velocity [km/sec]
+  /// @return Anything other than 0 denotes an error (bodies not connected
+  ///         or not covered at et)
+  int position(double et, int target, int observer, double *pos,
+               double *vel = nullptr) const noexcept;
+
+private:
+  std::vector<Segment> segments;
+  void *map{nullptr};
+  long map_size{0};
+}; // SpkReader
+
+/// @brief Per-thread access to a dso::SpkReader, caching the segment and
+///        the Chebyshev record in use for each body, so that repeated
+///        queries (at close epochs) skip the segment search.
+class SpkCursor {
+public:
+  explicit SpkCursor(const SpkReader &_spk) noexcept : spk(&_spk) {}
+
+  /// @brief Same as dso::SpkReader::position
+  int position(double et, int target, int observer, double *pos,
+               double *vel = nullptr) noexcept;
+
+  /// @brief Number of record look-ups served from the cache, and misses
+  long hits() const noexcept { return nhits; }
+  long misses() const noexcept { return nmisses; }
+
+private:
+  /// cached record, per body
+  struct Record {
+    int body;
+    const SpkReader::Segment *seg;
+    /// record coverage (ET) and coefficients
+    double t0, t1;
+    const double *coef;
+  }; // Record
+
+  static constexpr const int max_bodies = 16;
+
+  const SpkReader *spk;
+  Record cache[max_bodies];
+  int ncached{0};
+  long nhits{0}, nmisses{0};
+}; // SpkCursor
+
+} // namespace dso
+
+#endif
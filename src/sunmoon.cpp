@@ -1,14 +1,12 @@
 #include "orbit_integration.hpp"
 #include <cmath>
+#include <cstdio>
 #include "planetpos.hpp"
+#include "spk_ephemeris.hpp"
+#include "sunmoon_table.hpp"
 
-void dso::SunMoon(double mjd_tai, const Eigen::Matrix<double, 3, 1> &rsat,
-            double GMSun, double GMMoon, 
-             Eigen::Matrix<double, 3, 1> &sun_acc,
-             Eigen::Matrix<double, 3, 1> &moon_acc,
-             Eigen::Matrix<double, 3, 1> &sun_pos,
-             Eigen::Matrix<double, 3, 3> &mon_partials) noexcept {
-
+int dso::sun_moon_positions(double mjd_tai, Eigen::Matrix<double, 3, 1> &sun_pos,
+                            Eigen::Matrix<double, 3, 1> &mon_pos) noexcept {
   // split TAI to integral and fractional part
   double mjd_days;
   const double taif = std::modf(mjd_tai, &mjd_days);
@@ -21,22 +19,129 @@ void dso::SunMoon(double mjd_tai, const Eigen::Matrix<double, 3, 1> &rsat,
   double rsun[3], rmon[3];
 
   // position vector of sun/moon, in J2000, [km]
-  dso::cspice::j2planet_pos_from(dso::cspice::jd2et(jd), 10, 399, rsun);
-  dso::cspice::j2planet_pos_from(dso::cspice::jd2et(jd), 301, 399, rmon);
+  const double et = dso::cspice::jd2et(jd);
+  if (dso::cspice::j2planet_pos_from(et, 10, 399, rsun) ||
+      dso::cspice::j2planet_pos_from(et, 301, 399, rmon)) {
+    fprintf(stderr,
+            "[ERROR] Failed computing Sun/Moon positions at MJD %.6f (TAI) "
+            "(traceback: %s)\n",
+            mjd_tai, __func__);
+    return 1;
+  }
+
+  sun_pos = Eigen::Matrix<double, 3, 1>(rsun) * 1e3; // [m]
+  mon_pos = Eigen::Matrix<double, 3, 1>(rmon) * 1e3; // [m]
+
+  return 0;
+}
+
+int dso::sun_moon_positions(double mjd_tai, dso::SpkCursor &spk,
+                            Eigen::Matrix<double, 3, 1> &sun_pos,
+                            Eigen::Matrix<double, 3, 1> &mon_pos) noexcept {
+  // TAI to ET, keeping the fractional part of TT separate
+  double mjd_days;
+  const double ttf = std::modf(mjd_tai, &mjd_days) + (32184e-3 / 86400e0);
+  const double et = dso::tt2et(mjd_days + ttf);
+  double rsun[3], rmon[3];
+
+  // position vector of sun/moon, in J2000, [km]
+  if (spk.position(et, 10, 399, rsun) || spk.position(et, 301, 399, rmon))
+    return 1;
+
+  sun_pos = Eigen::Matrix<double, 3, 1>(rsun) * 1e3; // [m]
+  mon_pos = Eigen::Matrix<double, 3, 1>(rmon) * 1e3; // [m]
 
-  Eigen::Matrix<double, 3, 1> rSun(rsun); // [km]
-  Eigen::Matrix<double, 3, 1> rMon(rmon); // [km]
+  return 0;
+}
 
+void dso::SunMoon(double mjd_tai, const Eigen::Matrix<double, 3, 1> &rsat,
+            double GMSun, double GMMoon, 
+             Eigen::Matrix<double, 3, 1> &sun_acc,
+             Eigen::Matrix<double, 3, 1> &moon_acc,
+             Eigen::Matrix<double, 3, 1> &sun_pos,
+             Eigen::Matrix<double, 3, 3> &mon_partials) noexcept {
+
+  // position vector of sun/moon, in J2000, [m]
+  Eigen::Matrix<double, 3, 1> mon_pos;
+  dso::sun_moon_positions(mjd_tai, sun_pos, mon_pos);
+
+  dso::SunMoon(sun_pos, mon_pos, rsat, GMSun, GMMoon, sun_acc, moon_acc,
+               mon_partials);
+
+  return;
+}
+
+void dso::sun_moon_positions_analytic(
+    double mjd_tai, Eigen::Matrix<double, 3, 1> &sun_pos,
+    Eigen::Matrix<double, 3, 1> &mon_pos) noexcept {
+  // TT as Julian centuries since J2000
+  const double t =
+      (mjd_tai + (32184e-3 / 86400e0) - (dso::j2000_jd - dso::mjd0_jd)) /
+      36525e0;
+  double rsun[3], rmon[3];
+
+  // position vector of sun/moon, [km]
+  dso::sun_vector_montenbruck(t, rsun);
+  dso::moon_vector_approx(t, rmon);
+
+  sun_pos = Eigen::Matrix<double, 3, 1>(rsun) * 1e3; // [m]
+  mon_pos = Eigen::Matrix<double, 3, 1>(rmon) * 1e3; // [m]
+}
+
+int dso::sun_moon_positions(double mjd_tai, dso::EphemerisTier tier,
+                            const dso::SunMoonTable *table,
+                            dso::SpkCursor *spk,
+                            Eigen::Matrix<double, 3, 1> &sun_pos,
+                            Eigen::Matrix<double, 3, 1> &mon_pos) noexcept {
+  switch (tier) {
+  case dso::EphemerisTier::Analytic:
+    dso::sun_moon_positions_analytic(mjd_tai, sun_pos, mon_pos);
+    return 0;
+  case dso::EphemerisTier::CachedSpk:
+    if (table && table->contains(mjd_tai))
+      return table->positions(mjd_tai, sun_pos, mon_pos);
+    [[fallthrough]];
+  case dso::EphemerisTier::ExactSpk:
+    if (spk)
+      return dso::sun_moon_positions(mjd_tai, *spk, sun_pos, mon_pos);
+    return dso::sun_moon_positions(mjd_tai, sun_pos, mon_pos);
+  }
+  return 1;
+}
+
+void dso::SunMoon(double mjd_tai, const dso::SunMoonTable &table,
+                  const Eigen::Matrix<double, 3, 1> &rsat, double GMSun,
+                  double GMMoon, Eigen::Matrix<double, 3, 1> &sun_acc,
+                  Eigen::Matrix<double, 3, 1> &moon_acc,
+                  Eigen::Matrix<double, 3, 1> &sun_pos,
+                  Eigen::Matrix<double, 3, 3> &mon_partials) noexcept {
+
+  // position vector of sun/moon, in J2000, [m]
+  Eigen::Matrix<double, 3, 1> mon_pos;
+  if (table.contains(mjd_tai))
+    table.positions(mjd_tai, sun_pos, mon_pos);
+  else
+    dso::sun_moon_positions(mjd_tai, sun_pos, mon_pos);
+
+  dso::SunMoon(sun_pos, mon_pos, rsat, GMSun, GMMoon, sun_acc, moon_acc,
+               mon_partials);
+
+  return;
+}
+
+void dso::SunMoon(const Eigen::Matrix<double, 3, 1> &sun_pos,
+                  const Eigen::Matrix<double, 3, 1> &mon_pos,
+                  const Eigen::Matrix<double, 3, 1> &rsat, double GMSun,
+                  double GMMoon, Eigen::Matrix<double, 3, 1> &sun_acc,
+                  Eigen::Matrix<double, 3, 1> &moon_acc,
+                  Eigen::Matrix<double, 3, 3> &mon_partials) noexcept {
   // Sun-induced acceleration [km/sec^2]
-  sun_acc = dso::point_mass_accel(GMSun, rsat * 1e-3, rSun);
+  sun_acc = dso::point_mass_accel(GMSun, rsat * 1e-3, sun_pos * 1e-3);
   sun_acc = sun_acc * 1e-3; // [m/sec^2]
 
   // Moon-induced acceleration [m/sec^2]
   moon_acc =
-      dso::point_mass_accel(GMMoon * 1e9, rsat, rMon * 1e3, mon_partials);
-
-  // Sun position in [m]
-  sun_pos = rSun * 1e3;
+      dso::point_mass_accel(GMMoon * 1e9, rsat, mon_pos, mon_partials);
 
   return;
 }
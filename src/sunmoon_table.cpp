@@ -0,0 +1,165 @@
+#include "sunmoon_table.hpp"
+#include "chebyshev.hpp"
+#include "orbit_integration.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+namespace {
+/// initial segment length [days], for Sun and Moon
+constexpr const double initial_length[] = {16e0, 4e0};
+/// maximum number of segment length halvings
+constexpr const int max_halvings = 10;
+
+/// Sum of the Chebyshev series of the three components of a segment, at u
+/// in [-1, 1] (coefficients of component c at coef[c*n, c*n+n))
+void clenshaw3(const double *coef, int n, double u,
+               Eigen::Matrix<double, 3, 1> &pos) noexcept {
+  using Stride = Eigen::InnerStride<>;
+  pos = dso::clenshaw(
+      n, u,
+      [&](int k) {
+        return Eigen::Map<const Eigen::Matrix<double, 3, 1>, 0, Stride>(
+            coef + k, Stride(n));
+      },
+      Eigen::Matrix<double, 3, 1>::Zero().eval());
+}
+} // unnamed namespace
+
+template <typename Source>
+int dso::SunMoonTable::fit(int body, Body &b, double length,
+                           Source &&source) noexcept {
+  const int n = degree + 1;
+  Eigen::Matrix<double, 3, 1> pos[2];
+  std::vector<double> f(3 * n);
+
+  for (int attempt = 0; attempt <= max_halvings; attempt++) {
+    const int nseg =
+        std::max(1, (int)std::ceil((mjd_last - mjd_first) / length));
+    b.coef.assign(nseg * 3 * n, 0e0);
+    b.length = length;
+    b.max_error = 0e0;
+
+    for (int i = 0; i < nseg; i++) {
+      const double t0 = mjd_first + i * length;
+      // positions at the Chebyshev nodes of the segment
+      for (int k = 0; k < n; k++) {
+        const double u = std::cos(M_PI * (k + 0.5e0) / n);
+        if (source(t0 + 0.5e0 * length * (u + 1e0), pos[0], pos[1]))
+          return 1;
+        for (int c = 0; c < 3; c++)
+          f[c * n + k] = pos[body](c);
+      }
+      // coefficients (discrete cosine transform); the first one is halved
+      // (see dso::clenshaw)
+      double *coef = b.coef.data() + i * 3 * n;
+      for (int c = 0; c < 3; c++) {
+        for (int j = 0; j < n; j++) {
+          double s = 0e0;
+          for (int k = 0; k < n; k++)
+            s += f[c * n + k] * std::cos(M_PI * j * (k + 0.5e0) / n);
+          coef[c * n + j] = (j ? 2e0 : 1e0) * s / n;
+        }
+      }
+      // check at the segment boundaries and midway between the nodes; u is
+      // recomputed off of the (rounded) epoch, as in evaluate
+      for (int k = -1; k < n; k++) {
+        const double t =
+            t0 + 0.5e0 * length * (std::cos(M_PI * (k + 1) / n) + 1e0);
+        const double u = 2e0 * (t - t0) / length - 1e0;
+        Eigen::Matrix<double, 3, 1> fitted;
+        if (source(t, pos[0], pos[1]))
+          return 1;
+        clenshaw3(coef, n, u, fitted);
+        b.max_error = std::max(b.max_error, (fitted - pos[body]).norm());
+      }
+    }
+
+    if (b.max_error <= tolerance)
+      return 0;
+    length /= 2e0;
+  }
+
+  fprintf(stderr,
+          "[ERROR] Failed fitting %s positions within %.3e m (error: %.3e m) "
+          "(traceback: %s)\n",
+          body ? "Moon" : "Sun", tolerance, b.max_error, __func__);
+  return 1;
+}
+
+template <typename Source>
+int dso::SunMoonTable::build_from(double mjd_start, double mjd_end,
+                                  Source &&source) noexcept {
+  sun.coef.clear();
+  mon.coef.clear();
+  if (mjd_end < mjd_start || degree < 1 || tolerance <= 0e0) {
+    fprintf(stderr,
+            "[ERROR] Invalid arc or table parameters (traceback: %s)\n",
+            __func__);
+    return 1;
+  }
+  mjd_first = mjd_start;
+  mjd_last = mjd_end;
+
+  // segments no longer than the arc (but at least an hour)
+  const double arc = std::max(mjd_end - mjd_start, 1e0 / 24e0);
+  if (fit(0, sun, std::min(initial_length[0], arc), source) ||
+      fit(1, mon, std::min(initial_length[1], arc), source)) {
+    sun.coef.clear();
+    mon.coef.clear();
+    return 1;
+  }
+
+  return 0;
+}
+
+int dso::SunMoonTable::build(double mjd_start, double mjd_end) noexcept {
+  return build_from(mjd_start, mjd_end,
+                    [](double t, Eigen::Matrix<double, 3, 1> &rsun,
+                       Eigen::Matrix<double, 3, 1> &rmon) {
+                      return dso::sun_moon_positions(t, rsun, rmon);
+                    });
+}
+
+int dso::SunMoonTable::build(double mjd_start, double mjd_end,
+                             dso::SpkCursor &spk) noexcept {
+  return build_from(mjd_start, mjd_end,
+                    [&spk](double t, Eigen::Matrix<double, 3, 1> &rsun,
+                           Eigen::Matrix<double, 3, 1> &rmon) {
+                      return dso::sun_moon_positions(t, spk, rsun, rmon);
+                    });
+}
+
+int dso::SunMoonTable::build(
+    double mjd_start, double mjd_end,
+    const std::function<int(double, Eigen::Matrix<double, 3, 1> &,
+                            Eigen::Matrix<double, 3, 1> &)> &source) noexcept {
+  return build_from(mjd_start, mjd_end, source);
+}
+
+void dso::SunMoonTable::evaluate(
+    const Body &b, double mjd_tai,
+    Eigen::Matrix<double, 3, 1> &pos) const noexcept {
+  const int n = degree + 1;
+  const int nseg = b.coef.size() / (3 * n);
+  const int i = std::min(nseg - 1, (int)((mjd_tai - mjd_first) / b.length));
+  const double u =
+      2e0 * (mjd_tai - (mjd_first + i * b.length)) / b.length - 1e0;
+
+  clenshaw3(b.coef.data() + i * 3 * n, n, u, pos);
+}
+
+int dso::SunMoonTable::positions(
+    double mjd_tai, Eigen::Matrix<double, 3, 1> &sun_pos,
+    Eigen::Matrix<double, 3, 1> &mon_pos) const noexcept {
+  if (!contains(mjd_tai)) {
+    fprintf(stderr,
+            "[ERROR] Epoch MJD %.6f out of Sun/Moon table range (traceback: "
+            "%s)\n",
+            mjd_tai, __func__);
+    return 1;
+  }
+  evaluate(sun, mjd_tai, sun_pos);
+  evaluate(mon, mjd_tai, mon_pos);
+  return 0;
+}
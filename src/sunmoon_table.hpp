@@ -0,0 +1,108 @@
+#ifndef __DSO_SUN_MOON_TABLE_HPP__
+#define __DSO_SUN_MOON_TABLE_HPP__
+
+#include "eigen3/Eigen/Eigen"
+#include <functional>
+#include <vector>
+
+namespace dso {
+
+class SpkCursor;
+
+/// @brief Geocentric Sun and Moon positions (J2000/GCRF) over an arc,
+///        tabulated as Chebyshev segments, to be evaluated (in constant
+///        time) instead of querying the planetary ephemeris at every force
+///        model evaluation (see dso::SunMoon and dso::update_time_cache).
+///
+/// Each body is fitted with polynomials of the given degree, interpolating
+/// the ephemeris at the Chebyshev nodes of equal-length segments. The
+/// segment length (per body) is halved until the fit error, checked at the
+/// midpoints between the nodes of every segment, is below the requested
+/// bound; with the defaults (degree 12, 10 cm), segments span up to 16 days
+/// for the Sun and 4 days for the Moon. Note that the bound cannot be set
+/// below 1-2 cm, i.e. the distance the Sun covers within the
+/// resolution of a (TAI) MJD; this is also the level at which the exact
+/// path (dso::sun_moon_positions) is defined.
+///
+/// Example:
+///   dso::SunMoonTable sm;
+///   if (sm.build(mjd_start, mjd_end)) { ... error ... }
+///   params.sun_moon_table = &sm; // see dso::update_time_cache
+class SunMoonTable {
+public:
+  /// @brief Constructor
+  /// @param[in] _tolerance Accuracy bound of the fit [m]
+  /// @param[in] _degree Degree of the Chebyshev polynomials
+  explicit SunMoonTable(double _tolerance = 1e-1, int _degree = 12) noexcept
+      : tolerance(_tolerance), degree(_degree) {}
+
+  /// @brief (Re-)build the table for the arc [mjd_start, mjd_end] (TAI),
+  ///        using CSPICE (see dso::sun_moon_positions; kernels should be
+  ///        loaded)
+  /// @return Anything other than 0 denotes an error (e.g. the accuracy bound
+  ///         could not be met)
+  int build(double mjd_start, double mjd_end) noexcept;
+
+  /// @brief Same as above, using a native SPK reader (see dso::SpkCursor)
+  int build(double mjd_start, double mjd_end, dso::SpkCursor &spk) noexcept;
+
+  /// @brief Same as above, off of any source of positions, called as
+  ///        source(mjd_tai, sun_pos, mon_pos) and returning anything other
+  ///        than 0 on error (which is propagated); e.g. to tabulate the
+  ///        analytic series (dso::sun_moon_positions_analytic)
+  int build(double mjd_start, double mjd_end,
+            const std::function<int(double, Eigen::Matrix<double, 3, 1> &,
+                                    Eigen::Matrix<double, 3, 1> &)> &source)
+      noexcept;
+
+  /// @brief Check if the given TAI epoch is covered by the table
+  bool contains(double mjd_tai) const noexcept {
+    return !sun.coef.empty() && mjd_tai >= mjd_first && mjd_tai <= mjd_last;
+  }
+
+  /// @brief Sun and Moon positions (w.r.t. Earth), in J2000 [m]
+  /// @return Anything other than 0 denotes an error (epoch not covered)
+  int positions(double mjd_tai, Eigen::Matrix<double, 3, 1> &sun_pos,
+                Eigen::Matrix<double, 3, 1> &mon_pos) const noexcept;
+
+  /// @brief Maximum fit error found while building [m], for Sun and Moon
+  double sun_error() const noexcept { return sun.max_error; }
+  double moon_error() const noexcept { return mon.max_error; }
+
+  /// @brief Segment length [days], for Sun and Moon
+  double sun_segment_length() const noexcept { return sun.length; }
+  double moon_segment_length() const noexcept { return mon.length; }
+
+private:
+  /// Chebyshev segments of one body; (degree+1) coefficients per component
+  /// and segment, i.e. coef[(3*i+k)*(degree+1)+j] for segment i, component
+  /// k and coefficient j
+  struct Body {
+    double length{0e0};
+    double max_error{0e0};
+    std::vector<double> coef;
+  }; // Body
+
+  /// build the table off of a source(mjd_tai, sun_pos, mon_pos) function
+  template <typename Source>
+  int build_from(double mjd_start, double mjd_end, Source &&source) noexcept;
+
+  /// fit one body (0 for Sun, 1 for Moon), halving the segment length
+  /// until the fit error is within tolerance
+  template <typename Source>
+  int fit(int body, Body &b, double length, Source &&source) noexcept;
+
+  /// position of a body at mjd_tai [m]
+  void evaluate(const Body &b, double mjd_tai,
+                Eigen::Matrix<double, 3, 1> &pos) const noexcept;
+
+  double tolerance;
+  int degree;
+  /// covered arc, TAI MJD
+  double mjd_first{0e0}, mjd_last{-1e0};
+  Body sun, mon;
+}; // SunMoonTable
+
+} // namespace dso
+
+#endif
@@ -0,0 +1,70 @@
+#include "orbit_integration.hpp"
+#include "c2t_table.hpp"
+#include "sunmoon_table.hpp"
+#include "iers2010/iersc.hpp"
+#include "geodesy/units.hpp"
+#include <cmath>
+#include <cstdio>
+
+namespace {
+/// TT - TAI [sec]
+constexpr const double tt_minus_tai = 32.184e0;
+} // unnamed namespace
+
+const dso::ForceModelTimeCache &
+dso::update_time_cache(double cmjd, dso::IntegrationParameters &params) noexcept {
+  dso::ForceModelTimeCache &cache = params.time_cache;
+
+  // reuse cached quantities
+  if (cache.mjd_tai >= 0e0 &&
+      std::abs(cmjd - cache.mjd_tai) * dso::sec_per_day <= cache.window) {
+    // the atmospheric data feed may have been updated in between (e.g. by
+    // another instance sharing it); restore the date/time part
+    if (params.AtmDataFeed)
+      params.AtmDataFeed->params_ = cache.atm;
+    ++cache.nhits;
+    return cache;
+  }
+
+  // celestial to terrestrial (tabulated, if available)
+  [[maybe_unused]] int error;
+  if (params.c2t_table && params.c2t_table->contains(cmjd))
+    error = params.c2t_table->gcrs2itrs(cmjd, cache.rc2i, cache.era,
+                                        cache.rpom, cache.xlod);
+  else if (params.eop_high_rate &&
+           params.eop_high_rate->contains(cmjd + tt_minus_tai / 86400e0)) {
+    dso::CelTerQuantities q;
+    error = dso::c2t_quantities(cmjd, *params.eop_high_rate, q,
+                                params.cip_fit);
+    dso::c2t_matrices(cmjd, q, cache.rc2i, cache.era, cache.rpom);
+    cache.xlod = q.lod;
+  } else if (params.cip_fit)
+    error = dso::gcrs2itrs(cmjd, params.eopLUT, *params.cip_fit, cache.rc2i,
+                           cache.era, cache.rpom, cache.xlod);
+  else
+    error = dso::gcrs2itrs(cmjd, params.eopLUT, cache.rc2i, cache.era,
+                           cache.rpom, cache.xlod);
+  assert(!error);
+
+  // Sun and Moon, in J2000 [m] (see dso::EphemerisTier)
+  error = dso::sun_moon_positions(cmjd, params.ephemeris_tier,
+                                  params.sun_moon_table, params.spk_cursor,
+                                  cache.rsun, cache.rmon);
+  assert(!error);
+
+  // attitude (if any; marked as failed otherwise)
+  cache.qerror = params.qhunt ? params.qhunt->get_at(cmjd, cache.q) : 1;
+
+  // atmospheric model input (date and space weather), using the UTC date
+  if (params.AtmDataFeed) {
+    long utc_mjd;
+    const double utc_sec = params.time_scales.tai2utc(cmjd, utc_mjd);
+    error = params.AtmDataFeed->update_params(utc_mjd, utc_sec);
+    assert(!error);
+    cache.atm = params.AtmDataFeed->params_;
+  }
+
+  cache.mjd_tai = cmjd;
+  ++cache.nmisses;
+  return cache;
+}
@@ -0,0 +1,216 @@
+#include "time_scales.hpp"
+#include "datetime/utcdates.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+namespace {
+/// maximum span searched for a leap-second boundary [days] (~45 years)
+constexpr const long max_span = 1L << 14;
+
+int tai_utc(long utc_mjd) noexcept {
+  return dso::dat(dso::modified_julian_day((int)utc_mjd));
+}
+} // unnamed namespace
+
+const dso::TimeScaleConverter::LeapInterval &
+dso::TimeScaleConverter::interval(long utc_mjd) noexcept {
+  if (utc_mjd >= leap.first && utc_mjd <= leap.last) {
+    ++nhits;
+    return leap;
+  }
+  ++nmisses;
+
+  const int a = tai_utc(utc_mjd);
+  leap.dat = a;
+  leap.extra = 0;
+
+  // last day with the same TAI-UTC; exponential search, then bisection
+  long lo = utc_mjd, hi = -1;
+  for (long step = 1; step <= max_span; step *= 2) {
+    if (tai_utc(utc_mjd + step) != a) {
+      hi = utc_mjd + step;
+      break;
+    }
+    lo = utc_mjd + step;
+  }
+  if (hi > 0) {
+    while (hi - lo > 1) {
+      const long mid = lo + (hi - lo) / 2;
+      (tai_utc(mid) == a) ? (lo = mid) : (hi = mid);
+    }
+    leap.extra = tai_utc(hi) - a;
+  }
+  leap.last = lo;
+
+  // first day with the same TAI-UTC
+  hi = utc_mjd;
+  lo = -1;
+  for (long step = 1; step <= max_span; step *= 2) {
+    if (tai_utc(utc_mjd - step) != a) {
+      lo = utc_mjd - step;
+      break;
+    }
+    hi = utc_mjd - step;
+  }
+  if (lo > 0) {
+    while (hi - lo > 1) {
+      const long mid = lo + (hi - lo) / 2;
+      (tai_utc(mid) == a) ? (hi = mid) : (lo = mid);
+    }
+  }
+  leap.first = hi;
+
+  return leap;
+}
+
+int dso::TimeScaleConverter::dat(long utc_mjd, int &extra_sec) noexcept {
+  const LeapInterval &li = interval(utc_mjd);
+  extra_sec = (utc_mjd == li.last) ? li.extra : 0;
+  return li.dat;
+}
+
+double dso::TimeScaleConverter::tai2utc(double mjd_tai,
+                                        long &utc_mjd) noexcept {
+  // the UTC day is the TAI day, or the previous one
+  long day = (long)std::floor(mjd_tai);
+  double sec = 0e0;
+  for (int i = 0; i < 3; i++) {
+    int extra;
+    const int a = dat(day, extra);
+    sec = (mjd_tai - day) * 86400e0 - a;
+    if (sec < 0e0)
+      --day;
+    else if (sec >= 86400e0 + extra)
+      ++day;
+    else
+      break;
+  }
+  utc_mjd = day;
+  return sec;
+}
+
+double dso::TimeScaleConverter::utc2tai(long utc_mjd, double utc_sec) noexcept {
+  return utc_mjd + (utc_sec + interval(utc_mjd).dat) / 86400e0;
+}
+
+int dso::TimeScaleConverter::update_segment(double mjd_tt) noexcept {
+  seg.index = -1;
+  if (!eop || eop->size() < 4) {
+    fprintf(stderr,
+            "[ERROR] No (or too small) EOP table for UT1 conversions "
+            "(traceback: %s)\n",
+            __func__);
+    return 1;
+  }
+
+  // segment [mjd(i), mjd(i+1)) holding the epoch
+  const int n = eop->size();
+  const double *t = eop->mjd();
+  if (mjd_tt < t[0] || mjd_tt > t[n - 1]) {
+    fprintf(stderr,
+            "[ERROR] Epoch MJD=%.6f [TT] out of EOP table range (traceback: "
+            "%s)\n",
+            mjd_tt, __func__);
+    return 1;
+  }
+  const int i = std::min(
+      (int)(std::upper_bound(t, t + n, mjd_tt) - t) - 1, n - 2);
+
+  // UT1-TAI at the four nodes around the segment; the UTC day of a node is
+  // the integral part of its (TT) date
+  seg.first = std::max(0, std::min(i - 1, n - 4));
+  for (int k = 0; k < 4; k++) {
+    const int j = seg.first + k;
+    seg.tnode[k] = t[j];
+    seg.value[k] = *(eop->dut(j)) - interval((long)std::floor(t[j])).dat;
+  }
+  seg.t0 = t[i];
+  seg.t1 = t[i + 1];
+  seg.index = i;
+
+  return 0;
+}
+
+int dso::TimeScaleConverter::ut1_tai(double mjd_tai, double &dt) noexcept {
+  const double mjd_tt = mjd_tai + tt_tai / 86400e0;
+  if (seg.index < 0 || mjd_tt < seg.t0 || mjd_tt >= seg.t1) {
+    ++nmisses;
+    if (update_segment(mjd_tt))
+      return 1;
+  } else {
+    ++nhits;
+  }
+
+  // cubic Lagrange interpolation
+  dt = 0e0;
+  for (int k = 0; k < 4; k++) {
+    double w = 1e0;
+    for (int m = 0; m < 4; m++)
+      if (m != k)
+        w *= (mjd_tt - seg.tnode[m]) / (seg.tnode[k] - seg.tnode[m]);
+    dt += w * seg.value[k];
+  }
+
+  return 0;
+}
+
+int dso::TimeScaleConverter::convert(double mjd, dso::TimeScale from,
+                                     dso::TimeScale to, double &out) noexcept {
+  // to TAI
+  double tai = mjd;
+  switch (from) {
+  case TimeScale::TAI:
+    break;
+  case TimeScale::TT:
+    tai = mjd - tt_tai / 86400e0;
+    break;
+  case TimeScale::GPS:
+    tai = mjd + tai_gps / 86400e0;
+    break;
+  case TimeScale::UTC: {
+    const long day = (long)std::floor(mjd);
+    tai = utc2tai(day, (mjd - day) * 86400e0);
+    break;
+  }
+  case TimeScale::UT1: {
+    // UT1-TAI is evaluated at TAI; it changes by (at most) a few ms per
+    // day, hence two iterations suffice
+    double dt;
+    for (int i = 0; i < 2; i++) {
+      if (ut1_tai(tai, dt))
+        return 1;
+      tai = mjd - dt / 86400e0;
+    }
+    break;
+  }
+  }
+
+  // from TAI
+  switch (to) {
+  case TimeScale::TAI:
+    out = tai;
+    break;
+  case TimeScale::TT:
+    out = tai + tt_tai / 86400e0;
+    break;
+  case TimeScale::GPS:
+    out = tai - tai_gps / 86400e0;
+    break;
+  case TimeScale::UTC: {
+    long day;
+    const double sec = tai2utc(tai, day);
+    out = day + sec / 86400e0;
+    break;
+  }
+  case TimeScale::UT1: {
+    double dt;
+    if (ut1_tai(tai, dt))
+      return 1;
+    out = tai + dt / 86400e0;
+    break;
+  }
+  }
+
+  return 0;
+}
@@ -0,0 +1,107 @@
+#ifndef __DSO_TIME_SCALE_CONVERTER_HPP__
+#define __DSO_TIME_SCALE_CONVERTER_HPP__
+
+#include "eop.hpp"
+
+namespace dso {
+
+/// @brief Time scales handled by dso::TimeScaleConverter
+enum class TimeScale : char { TAI, TT, UTC, UT1, GPS };
+
+/// @brief Conversion between TAI, TT, UTC, UT1 and GPS time, caching the
+///        current leap-second interval and the current ΔUT1 segment, so that
+///        repeated conversions (at close epochs) are answered in constant
+///        time, without searching the leap-second or the EOP table.
+///
+/// The leap-second interval is the span of (UTC) days with the same
+/// TAI-UTC (as given by dso::dat); its last day may hold a leap second.
+/// UT1-TAI (continuous across leap seconds) is interpolated via a cubic
+/// Lagrange polynomial on the four daily EOP nodes around the epoch (no
+/// sub-daily, i.e. ocean tide or libration, terms; use
+/// dso::EopLookUpTable::interpolate for these).
+///
+/// An instance is cheap; it is not to be used concurrently (use one per
+/// thread), but can be shared by the force, observation and filter code of
+/// a thread (see dso::IntegrationParameters::time_scales). Leap seconds are
+/// only handled from 1972 onwards (integral TAI-UTC).
+class TimeScaleConverter {
+public:
+  /// TT - TAI [sec]
+  static constexpr const double tt_tai = 32.184e0;
+  /// TAI - GPS [sec]
+  static constexpr const double tai_gps = 19e0;
+
+  /// @brief Constructor
+  /// @param[in] _eop EOP table, needed for conversions to/from UT1
+  explicit TimeScaleConverter(const dso::EopLookUpTable *_eop = nullptr) noexcept
+      : eop(_eop) {}
+
+  /// @brief Set (or replace) the EOP table; drops the cached ΔUT1 segment
+  void set_eop(const dso::EopLookUpTable *_eop) noexcept {
+    eop = _eop;
+    seg.index = -1;
+  }
+
+  /// @brief TAI-UTC [sec] for the given UTC day
+  /// @param[out] extra_sec Extra seconds in this day (1 if it holds a leap
+  ///            second, 0 otherwise)
+  int dat(long utc_mjd, int &extra_sec) noexcept;
+
+  /// @brief TAI (MJD) to UTC (day and seconds of day)
+  /// @param[in] mjd_tai TAI date as MJD
+  /// @param[out] utc_mjd UTC day (MJD)
+  /// @return Seconds of UTC day, in the range [0, 86400+extra seconds)
+  double tai2utc(double mjd_tai, long &utc_mjd) noexcept;
+
+  /// @brief UTC (day and seconds of day) to TAI (MJD)
+  double utc2tai(long utc_mjd, double utc_sec) noexcept;
+
+  /// @brief UT1-TAI [sec] at the given epoch
+  /// @return Anything other than 0 denotes an error (no EOP table, or epoch
+  ///         out of its range)
+  int ut1_tai(double mjd_tai, double &dt) noexcept;
+
+  /// @brief Convert an MJD from one time scale to another. UTC is given as
+  ///        a fractional MJD, i.e. day + (seconds of day)/86400 (hence
+  ///        ambiguous within a leap second).
+  /// @return Anything other than 0 denotes an error (see ut1_tai)
+  int convert(double mjd, TimeScale from, TimeScale to, double &out) noexcept;
+
+  /// @brief Number of conversions served from the cache, and cache misses
+  ///        (leap-second interval and ΔUT1 segment lookups)
+  long hits() const noexcept { return nhits; }
+  long misses() const noexcept { return nmisses; }
+
+private:
+  /// Current leap-second interval; UTC days [first, last]
+  struct LeapInterval {
+    long first{1}, last{0};
+    int dat{0};
+    /// extra seconds in the last day of the interval
+    int extra{0};
+  };
+
+  /// Current ΔUT1 segment; [mjd(index), mjd(index+1)) of the EOP table,
+  /// with the UT1-TAI values at the (four) interpolation nodes
+  struct Ut1Segment {
+    int index{-1};
+    int first;
+    double t0, t1;
+    double tnode[4], value[4];
+  };
+
+  /// the leap-second interval holding the given UTC day
+  const LeapInterval &interval(long utc_mjd) noexcept;
+
+  /// (re-)compute the ΔUT1 segment for the given TT epoch
+  int update_segment(double mjd_tt) noexcept;
+
+  const dso::EopLookUpTable *eop{nullptr};
+  LeapInterval leap;
+  Ut1Segment seg;
+  long nhits{0}, nmisses{0};
+}; // TimeScaleConverter
+
+} // namespace dso
+
+#endif
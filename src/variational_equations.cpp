@@ -14,18 +14,37 @@ void dso::VariationalEquations(
     Eigen::Ref<Eigen::VectorXd> yPhiP,
     // auxiliary parametrs
     dso::IntegrationParameters &params) noexcept {
+  dso::VariationalEquations(tsec, yPhi.data(), yPhiP.data(), params);
+}
+
+void dso::VariationalEquations(
+    double tsec, // TAI
+    // state and state transition matrix (inertial RF), size 6+6*(6+Np)
+    const double *yPhiData,
+    // state derivative and state transition matrix derivative (inertial RF)
+    double *yPhiPData,
+    // auxiliary parametrs
+    dso::IntegrationParameters &params) noexcept {
+
+  // no copies here; just map the (contiguous) input/output arrays
+  const Eigen::Map<const Eigen::Matrix<double, 6 + 6 * (6 + Np), 1>> yPhi(
+      yPhiData);
+  Eigen::Map<Eigen::Matrix<double, 6 + 6 * (6 + Np), 1>> yPhiP(yPhiPData);
 
   // current mjd, TAI
   const double cmjd = params.mjd_tai + tsec / dso::sec_per_day;
 
+  // time-only quantities of the force model (cached)
+  const dso::ForceModelTimeCache &tc = dso::update_time_cache(cmjd, params);
+
   // terretrial to celestial for epoch
 #ifdef ABCD
   Eigen::Matrix<double, 3, 3> dt2c;
   Eigen::Matrix<double, 3, 3> t2c(dso::itrs2gcrs(cmjd, params.eopLUT, dt2c));
 #else
-  Eigen::Matrix<double, 3, 3> rc2i, rpom;
-  double era,xlod;
-  assert(!gcrs2itrs(cmjd, params.eopLUT, rc2i, era, rpom, xlod));
+  const Eigen::Matrix<double, 3, 3> &rc2i = tc.rc2i;
+  const Eigen::Matrix<double, 3, 3> &rpom = tc.rpom;
+  const double era = tc.era_at(cmjd);
   // const auto t2c = (rpom * rc2ti).transpose() ;
 #endif
   //{
@@ -42,23 +61,38 @@ void dso::VariationalEquations(
   Eigen::Matrix<double, 3, 1> r = yPhi.block<3, 1>(0, 0);
   Eigen::Matrix<double, 3, 1> v = yPhi.block<3, 1>(3, 0);
 
+  // how are we going to compute the state transition matrix?
+  using StmMode = dso::IntegrationParameters::StmMode;
+  const StmMode stm_mode = params.stm_mode;
+
   // compute gravity-induced acceleration (we need the position vector in ITRF)
-  Eigen::Matrix<double, 3, 3> gpartials;
+  Eigen::Matrix<double, 3, 3> gpartials = Eigen::Matrix<double, 3, 3>::Zero();
 #ifdef ABCD
   Eigen::Matrix<double, 3, 1> r_geo = t2c.transpose() * r;
 #else
   Eigen::Matrix<double, 3, 1> r_geo = rcel2ter(r, rc2i, era, rpom);
 #endif
-  Eigen::Matrix<double, 3, 1> gacc = dso::grav_potential_accel(
-      r_geo, params.degree, params.order, *(params.Lagrange_V),
-      *(params.Lagrange_W), params.harmonics, gpartials);
+  Eigen::Matrix<double, 3, 1> gacc;
+  if (stm_mode == StmMode::Full) {
+    gacc = dso::grav_potential_accel(r_geo, params.degree, params.order,
+                                     *(params.Lagrange_V),
+                                     *(params.Lagrange_W), params.harmonics,
+                                     gpartials);
+  } else {
+    // full model for the acceleration, no (expensive) partials
+    gacc = dso::grav_potential_accel(r_geo, params.degree, params.order,
+                                     *(params.Lagrange_V),
+                                     *(params.Lagrange_W), params.harmonics);
+    // reduced model (central body + J2) partials
+    dso::grav_potential_accel_zonal(r_geo, 2, params.harmonics, gpartials);
+  }
 
   // fucking crap! gravity acceleration in earth-fixed frame; need to
   // have inertial acceleration!
   //printf(">> ITRF acc: %+.9f %+.9f %+.9f\n", gacc(0), gacc(1), gacc(2));
 #ifdef ABCD
   gacc = t2c * gacc;
-  gpartials = t2c.transpose() * gpartials * t2c;
+  gpartials = t2c * gpartials * t2c.transpose();
   //for (int i=0; i<3; i++) {
   //  for (int j=0; j<3; j++) {
   //    printf(" %+.6f ", t2c.transpose()(i,j));
@@ -72,7 +106,9 @@ void dso::VariationalEquations(
 #else
   gacc = rter2cel(gacc, rc2i, era, rpom);
   const auto rc2ti = Eigen::AngleAxisd(era, -Eigen::Vector3d::UnitZ()) * rc2i;
-  gpartials = (rpom * rc2ti) * gpartials * (rpom * rc2ti).transpose();
+  // a_cel(r) = R^T a_ter(R r), with R = rpom * rc2ti (celestial to
+  // terrestrial), hence da_cel/dr = R^T (da_ter/dr_geo) R
+  gpartials = (rpom * rc2ti).transpose() * gpartials * (rpom * rc2ti);
   //for (int i=0; i<3; i++) {
   //  for (int j=0; j<3; j++) {
   //    printf(" %+.6f ",(rpom * rc2ti)(i,j));
@@ -87,22 +123,26 @@ void dso::VariationalEquations(
   //printf(">> GCRF acc: %+.9f %+.9f %+.9f\n", gacc(0), gacc(1), gacc(2));
 
   // third body perturbations, Sun and Moon [m/sec^2] in celestial RF
-  Eigen::Matrix<double, 3, 1> rsun; // position of sun, [m] in celestial RF
   Eigen::Matrix<double, 3, 1> sun_acc;
   Eigen::Matrix<double, 3, 1> mon_acc;
   Eigen::Matrix<double, 3, 3> tb_partials;
-  dso::SunMoon(cmjd, r, params.GMSun, params.GMMon, sun_acc, mon_acc, rsun,
-               tb_partials);
+  dso::SunMoon(tc.rsun, tc.rmon, r, params.GMSun, params.GMMon, sun_acc,
+               mon_acc, tb_partials);
+  // third-body partials are not part of the reduced model
+  if (stm_mode != StmMode::Full)
+    tb_partials = Eigen::Matrix<double, 3, 3>::Zero();
 
   // Drag
   // Warning only valid for Jason-3
   // get the quaternion
   Eigen::Matrix<double, 3, 1> drag = Eigen::Matrix<double, 3, 1>::Zero();
-  Eigen::Matrix<double, 3, 3> ddragdr;
-  Eigen::Matrix<double, 3, 3> ddragdv;
-  Eigen::Matrix<double, 3, 1> ddragdC;
-  Eigen::Quaternion<double> q;
-  if (params.qhunt->get_at(cmjd, q)) {
+  Eigen::Matrix<double, 3, 3> ddragdr = Eigen::Matrix<double, 3, 3>::Zero();
+  Eigen::Matrix<double, 3, 3> ddragdv = Eigen::Matrix<double, 3, 3>::Zero();
+  Eigen::Matrix<double, 3, 1> ddragdC = Eigen::Matrix<double, 3, 1>::Zero();
+  const Eigen::Quaternion<double> &q = tc.q;
+  if (!params.AtmDataFeed || !params.nrlmsise00) {
+    // no atmosphere model (or data) attached; no drag
+  } else if (tc.qerror) {
     fprintf(stderr, "ERROR Failed to find quaternion for datetime\n");
     assert(false);
   } else {
@@ -123,26 +163,24 @@ void dso::VariationalEquations(
         ProjArea += params.macromodel[i].m_surf * ctheta;
       }
     }
-    // get atmospheric density, using the UTC date
-    double imjd; 
-    int eid;
-    double utc_fday = std::modf(cmjd, &imjd);
-    const int leap_sec = dso::dat(cmjd, eid);
-    utc_fday -= leap_sec / (86400e0 + (double)eid);
-    if (utc_fday > 1e0) {
-      utc_fday -= 1e0;
-      ++imjd;
-    } else if (utc_fday < 1e0) {
-      utc_fday += 1e0;
-      --imjd;
-    }
-    assert(!params.AtmDataFeed->update_params(imjd, utc_fday*86400e0));
+    // get atmospheric density (date and space weather already set, see
+    // dso::update_time_cache)
     params.AtmDataFeed->set_spatial_from_cartesian(yPhi.block<3, 1>(0, 0));
     dso::nrlmsise00::OutParams aout;
     assert(!params.nrlmsise00->gtd7d(&(params.AtmDataFeed->params_), &aout));
     const double atmdens = aout.d[5];
     Eigen::Matrix<double,3,1> drhodr;
-    { // approximate arithmetic derivative w.r.t satellite ECEF position
+    if (stm_mode == StmMode::J2) {
+      // no partials needed
+      drhodr = Eigen::Matrix<double, 3, 1>::Zero();
+    } else if (stm_mode == StmMode::Reduced) {
+      // density gradient is (mostly) radial; one-sided difference along the
+      // radial direction (one density evaluation instead of six)
+      const Eigen::Matrix<double, 3, 1> ur = r.normalized();
+      params.AtmDataFeed->set_spatial_from_cartesian(yPhi.block<3, 1>(0, 0) + ur);
+      assert(!params.nrlmsise00->gtd7d(&(params.AtmDataFeed->params_), &aout));
+      drhodr = (aout.d[5] - atmdens) * ur;
+    } else { // approximate arithmetic derivative w.r.t satellite ECEF position
       Eigen::Matrix<double,3,1> unitv = Eigen::Matrix<double,3,1>::Zero();
       double p1,m1;
       // w.r.t X component
@@ -180,9 +218,13 @@ void dso::VariationalEquations(
     //drag = dso::drag_accel(r, v, ProjArea, /*params.get_drag_coefficient()*/2e0,
     //                       *(params.SatMass), atmdens/*, drhodr, ddragdr, ddragdv,
     //                       ddragdC*/);
-    drag = dso::drag_accel(r, v, ProjArea, *(params.drag_coef),
-                           *(params.SatMass), atmdens, drhodr, ddragdr, ddragdv,
-                           ddragdC);
+    if (stm_mode == StmMode::J2)
+      drag = dso::drag_accel(r, v, ProjArea, *(params.drag_coef),
+                             *(params.SatMass), atmdens);
+    else
+      drag = dso::drag_accel(r, v, ProjArea, *(params.drag_coef),
+                             *(params.SatMass), atmdens, drhodr, ddragdr,
+                             ddragdv, ddragdC);
   }
 
   // SRP
@@ -238,8 +280,8 @@ void dso::VariationalEquations(
   yPhip.block<3, 1>(3, 0) = gacc + sun_acc + mon_acc + drag;
 
   // matrix to vector (column-wise)
-  yPhiP = Eigen::VectorXd(
-      Eigen::Map<Eigen::VectorXd>(yPhip.data(), yPhip.cols() * yPhip.rows()));
+  yPhiP = Eigen::Map<const Eigen::Matrix<double, 6 + 6 * (6 + Np), 1>>(
+      yPhip.data());
 
   return;
 }
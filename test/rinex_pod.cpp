@@ -126,11 +126,14 @@ struct SatBeacon {
 
 // hold satellite state & time
 struct SatelliteState {
+  // size of the state + variational equations vector: 6 + 6x(6+Np)
+  static constexpr const int NumEqn = 6 + 6 * 6 + 6 * Np;
+
   // Current datetime in TAI
   double mjd_tai;
   // state vector at t=tai in ECEF, at DORIS receiver RP (Iono-Free)
   Eigen::Matrix<double, 6, 1> state;
-  // state transition matrix at t=tai
+  // state transition matrix from the previous to the current epoch (t=tai)
   Eigen::Matrix<double, 6, 6> Phi;
   Eigen::Matrix<double, 6, Np> S;
   // Satellite's center of gravity w.r.t the satellite-fixed frame
@@ -140,6 +143,36 @@ struct SatelliteState {
   // Body-quaternion hunter
   dso::JasonQuaternionHunter *qhunt{nullptr};
 
+  // Integration session: the integrator is (re-)started at session_mjd
+  // (TAI) with Φ(t0,t0) = I and S(t0) = 0 and then continued across
+  // successive epochs, keeping the multistep (Adams) history. The session
+  // holds the last integration result (GCRF, CoG), i.e. state, Φ(t,t0) and
+  // S(t,t0) at mjd_tai, in plain format, one column at a time.
+  Eigen::Matrix<double, NumEqn, 1> ysession;
+  // session start (TAI); t0 for variational equations
+  double session_mjd{0e0};
+  // seconds after session_mjd of the last integration result
+  double session_tsec{0e0};
+  // set when the session holds a valid integration result
+  bool warm{false};
+  // state corrections (applied e.g. by the filter) up to these limits are
+  // injected into the running integration; larger corrections trigger a
+  // restart [m] and [m/sec]
+  double max_inject_pos{1e-1};
+  double max_inject_vel{1e-4};
+  // differences below these are considered round-off of the ECEF <-> GCRF
+  // transformation (not actual corrections) and are not injected [m] and
+  // [m/sec]
+  double min_inject_pos{1e-6};
+  double min_inject_vel{1e-9};
+  // maximum session length [sec]; Φ(t,t0) is inverted at every epoch, so
+  // do not let it grow for ever
+  double max_session_sec{6 * 3600e0};
+  // statistics
+  int num_restarts{0};
+  int num_injections{0};
+  int num_vel_injections{0};
+
   // transform state vector state from ECEF to GCRF for mjd_tai
   Eigen::Matrix<double, 6, 1>
   celestial(const dso::EopLookUpTable &elut) const noexcept {
@@ -159,20 +192,60 @@ struct SatelliteState {
                     : (Eigen::Matrix<double, 3, 1>::Zero());
   }
 
+  // Extract Φ(t,t0) from a state + variational equations vector
+  static Eigen::Matrix<double, 6, 6>
+  stm(const Eigen::Ref<const Eigen::VectorXd> &yPhi) noexcept {
+    return Eigen::Map<const Eigen::Matrix<double, 6, 6>>(yPhi.data() + 6);
+  }
+
+  // Extract S(t,t0) from a state + variational equations vector
+  static Eigen::Matrix<double, 6, Np>
+  sensitivity(const Eigen::Ref<const Eigen::VectorXd> &yPhi) noexcept {
+    return Eigen::Map<const Eigen::Matrix<double, 6, Np>>(yPhi.data() + 6 +
+                                                          6 * 6);
+  }
+
+  // Start a new session at mjd_tai, from the (GCRF, CoG) state ycel
+  void restart(const Eigen::Matrix<double, 6, 1> &ycel,
+               dso::SGOde &integrator) noexcept {
+    ysession = Eigen::Matrix<double, NumEqn, 1>::Zero();
+    ysession.block<6, 1>(0, 0) = ycel;
+    // Initial condition for state transition matrix Φ(t0,t0) = I; column i
+    // of Φ starts at index 6*(i+1) (first column contains the state)
+    for (int i = 0; i < 6; i++)
+      ysession(6 * (i + 1) + i) = 1e0;
+    // Initial condition for the sensitivity matrix S(t0) = 0 (already set)
+    session_mjd = mjd_tai;
+    session_tsec = 0e0;
+    integrator.params->mjd_tai = session_mjd;
+    integrator.flag() = 1;
+    ++num_restarts;
+  }
+
+  // Inject a (small) state correction dy, referring to the last output
+  // epoch (mjd_tai), into the running integration. The integrator's own
+  // solution refers to x (usually past the output epoch), so the
+  // correction is mapped there using Φ(x,t) = Φ(x,t0) * Φ(t,t0)^(-1).
+  // The derivative history is left as is; this is a first order
+  // correction, valid for small dy only.
+  void inject(const Eigen::Matrix<double, 6, 1> &dy,
+              dso::SGOde &integrator) noexcept {
+    const Eigen::Matrix<double, 6, 6> Phix = stm(integrator.yy());
+    const Eigen::Matrix<double, 6, 6> Phit = stm(ysession);
+    integrator.yy().head<6>() += Phix * Phit.partialPivLu().solve(dy);
+    ysession.block<6, 1>(0, 0) += dy;
+    ++num_injections;
+    num_vel_injections += dy.head<3>().isZero(0e0);
+  }
+
   int integrate(double mjd_target, dso::SGOde &integrator) noexcept {
     // count calls; this is only needed because the first call should
     // consider the satellite coordinates as CoM coordinates, and not
     // apply eccentricity (ARP to  CoM)
     static int call_nr = 0;
 
-    // Vector containing state + variational equations size: 6 + 6x(6+Np)
-    // Stored in plain format, one column at a time
-    // Ref. Frame: inertial
-    Eigen::Matrix<double, 6 + 6 * 6 + 6 * Np, 1> yPhi =
-        Eigen::Matrix<double, 6 + 6 * 6 + 6 * Np, 1>::Zero();
-
     // transform state from ECEF to GCRF (satellite ARP)
-    yPhi.block<6, 1>(0, 0) = celestial(integrator.params->eopLUT);
+    Eigen::Matrix<double, 6, 1> ycel = celestial(integrator.params->eopLUT);
 
 #ifndef NO_ATTITUDE
     // if needed, go from antenna RP to CoG (this is not needed in the first
@@ -185,57 +258,76 @@ struct SatelliteState {
         assert(false);
       }
       // GCRF: from satellite ARP to CoG
-      yPhi.block<3, 1>(0, 0) += eccentricity(q);
+      ycel.block<3, 1>(0, 0) += eccentricity(q);
     }
 #endif
 
-    // Initial condition for state transition matrix Φ(t0,t0) = I
-    // set the state transition matrix to identity (initial condition)
-    // Note that the matrix is stored in plain format, one column at a time
-    // First column contains the state, skip it.
-    {
-      int k = 6;
-      for (int col = 1; col < 6; col++)
-        for (int row = 0; row < 6; row++)
-          yPhi(k++) = (col - 1 == row) ? 1e0 : 0e0;
+    // continue the current session if possible; that is if the last call
+    // was successful and the state has not changed (much) since. Else,
+    // start a new session (and pay for the low-order startup)
+    bool cold = !warm || integrator.flag() != 2 ||
+                (mjd_target - session_mjd) * 86400e0 > max_session_sec;
+    if (!cold) {
+      Eigen::Matrix<double, 6, 1> dy = ycel - ysession.block<6, 1>(0, 0);
+      const double dr = dy.head<3>().norm();
+      const double dv = dy.tail<3>().norm();
+      if (dr > max_inject_pos || dv > max_inject_vel) {
+        cold = true;
+      } else {
+        // drop round-off; note that this may leave a velocity-only (or
+        // position-only) correction
+        if (dr <= min_inject_pos)
+          dy.head<3>().setZero();
+        if (dv <= min_inject_vel)
+          dy.tail<3>().setZero();
+        if (!dy.isZero(0e0))
+          inject(dy, integrator);
+      }
     }
-
-    // Initial condition for state transition matrix S(t0) = I
-    // last 6 * Np elements should be zero (already done in initialization of
-    // the matrix)
-
-    // t0 for variational equations (TAI)
-    integrator.params->mjd_tai = mjd_tai;
+    if (cold)
+      restart(ycel, integrator);
+    warm = false;
 
     // target t for variational equations; seconds after t0
-    double tout = (mjd_target - mjd_tai) * 86400e0;
-
-    // set initial intergation flag
-    integrator.flag() = 1;
+    const double tout = (mjd_target - session_mjd) * 86400e0;
 
     // keep solution here (celestial RF at tout)
     // As yPhi, this is in plain format, one column at a time
-    Eigen::VectorXd sol(6 + 6 * 6 + 6 * Np);
+    Eigen::VectorXd sol(NumEqn);
 
-    // integrate (in inertial RF), from 0+mjd_tai to tout+mjd_tai [sec]
-    double tsec = 0e0;
-    integrator.de(tsec, tout, yPhi, sol);
+    // integrate (in inertial RF), from session_tsec to tout [sec] after t0
+    integrator.de(session_tsec, tout, ysession, sol);
 
     // output epoch as datetime
-    double tout_mjd = integrator.params->mjd_tai + tsec / 86400e0;
+    const double tout_mjd = session_mjd + session_tsec / 86400e0;
 
     // let's see were we are at
     if (std::abs(tout_mjd - mjd_target) > 1e-12) {
       fprintf(stderr,
               "ERROR wanted integration to %.9f and got up to %.9f, that is "
               "%.9f sec apart!\n",
-              mjd_target, tout_mjd, (mjd_target - mjd_tai) * 86400e0);
+              mjd_target, tout_mjd, (mjd_target - tout_mjd) * 86400e0);
       return 1;
     }
 
     // everything seems ok, update state and time
     mjd_tai = tout_mjd;
 
+    // Φ and S from the previous to the current epoch, aka
+    // Φ(t,tp) = Φ(t,t0) * Φ(tp,t0)^(-1) and
+    // S(t,tp) = S(t,t0) - Φ(t,tp) * S(tp,t0)
+    // (if the session was just restarted, Φ(tp,t0) = I and S(tp,t0) = 0)
+    {
+      const Eigen::Matrix<double, 6, 6> Phit = stm(sol);
+      Phi = stm(ysession).transpose().partialPivLu().solve(Phit.transpose())
+                .transpose();
+      S = sensitivity(sol) - Phi * sensitivity(ysession);
+    }
+
+    // store integration result (CoG, GCRF) in the session
+    ysession = sol;
+    warm = true;
+
 #ifndef NO_ATTITUDE
     // if needed, go from CoM to antenna ARP (sol must be in GCRS)
     {
@@ -255,18 +347,6 @@ struct SatelliteState {
         !gcrs2itrs(mjd_tai, integrator.params->eopLUT, rc2i, era, rpom, lod));
     state = dso::ycel2ter(sol.block<6, 1>(0, 0), rc2i, era, lod, rpom);
 
-    // assign Phi matrix (6x6)
-    for (int i = 0; i < 6; i++) {
-      Phi.col(i) = yPhi.block<6, 1>(6 * (i + 1), 0);
-    }
-
-    // assign S matrix (6xNp)
-    if (Np) {
-      for (int i=0; i<Np; i++) {
-        S.col(i) = yPhi.block<6, 1>(6 * (i + 1) + 6*6, 0);
-      }
-    }
-
     ++call_nr;
     return 0;
   }
@@ -529,6 +609,24 @@ int main(int argc, char *argv[]) {
   atm_data_feed.params_.meters_on();
   IntegrationParams.AtmDataFeed = &atm_data_feed;
 
+  // optional: how to compute the state transition matrix; 'full' (default),
+  // 'reduced' (central body + J2 and drag partials) or 'j2' (central body +
+  // J2 partials only)
+  if (config["force-model"] && config["force-model"]["stm-mode"]) {
+    const std::string stm_mode =
+        config["force-model"]["stm-mode"].as<std::string>();
+    if (stm_mode == "reduced") {
+      IntegrationParams.stm_mode =
+          dso::IntegrationParameters::StmMode::Reduced;
+    } else if (stm_mode == "j2") {
+      IntegrationParams.stm_mode = dso::IntegrationParameters::StmMode::J2;
+    } else if (stm_mode != "full") {
+      fprintf(stderr, "ERROR Invalid/unsupported stm-mode \"%s\"\n",
+              stm_mode.c_str());
+      return 1;
+    }
+  }
+
   // Orbit Integrator
   // -------------------------------------------------------------------------
   // Setup an integrator, to extrapolate orbit with:
@@ -537,6 +635,20 @@ int main(int argc, char *argv[]) {
   // 3. Num of Equations: 6 for state and 6*6 for variational equations
   dso::SGOde Integrator(dso::VariationalEquations, 6 + 6 * 6 + 6 * Np, 1e-12,
                         1e-12, &IntegrationParams);
+  // in reduced/j2 STM mode, the variational equations only need modest
+  // accuracy; loosen their tolerance by a factor of 1e3
+  if (IntegrationParams.stm_mode !=
+      dso::IntegrationParameters::StmMode::Full) {
+    Integrator.wscale = Eigen::VectorXd::Constant(6 + 6 * 6 + 6 * Np, 1e3);
+    Integrator.wscale.head(6).setOnes();
+  }
+  // optional: record a step trace of the integrator, written (as CSV) to
+  // the given file at the end of the run
+  std::string integrator_trace;
+  if (config["integrator-trace"]) {
+    integrator_trace = config["integrator-trace"].as<std::string>();
+    Integrator.stats.trace_steps = true;
+  }
 
   // get the (RINEX) indexes for the observables we want
   int l1i, l2i, fi, w1i, w2i;
@@ -1059,6 +1171,15 @@ int main(int argc, char *argv[]) {
 
   } // for every new data block in the RINEX file
 
+  printf("## Orbit integration: %d (re-)starts, %d state injections (%d "
+         "velocity-only)\n",
+         svState.num_restarts, svState.num_injections,
+         svState.num_vel_injections);
+  Integrator.stats.print("## SGOde");
+  if (!integrator_trace.empty() &&
+      Integrator.stats.write_csv(integrator_trace.c_str()))
+    return 1;
+
   return 0;
 }
 
@@ -0,0 +1,68 @@
+#include "c2t_table.hpp"
+#include "orbit_integration.hpp"
+#include <chrono>
+#include <cstdio>
+#include <datetime/dtfund.hpp>
+
+// Build a (tabulated) celestial-to-terrestrial transformation for a 3-day
+// arc and compare it against the exact path (dso::gcrs2itrs), for a few
+// node spacings; also time both.
+
+int main(int argc, char *argv[]) {
+  if (argc != 2) {
+    fprintf(stderr, "Usage: %s [EOP C04 file]\n", argv[0]);
+    return 1;
+  }
+
+  // EOP for the arc (plus margin for the interpolation)
+  dso::datetime<dso::nanoseconds> tstart(dso::year(2021), dso::month(12),
+                                         dso::day_of_month(20),
+                                         dso::nanoseconds(0));
+  dso::datetime<dso::nanoseconds> tend(dso::year(2022), dso::month(1),
+                                       dso::day_of_month(10),
+                                       dso::nanoseconds(0));
+  dso::EopLookUpTable eops;
+  if (dso::parse_iers_C04(argv[1], tstart.mjd(), tend.mjd(), eops)) {
+    fprintf(stderr, "Failed parsing IERS/C04 file %s\n", argv[1]);
+    return 1;
+  }
+  eops.regularize();
+
+  // the arc, TAI
+  const double mjd_start = tstart.as_mjd() + 8e0;
+  const double mjd_end = mjd_start + 3e0;
+
+  Eigen::Matrix<double, 3, 3> rc2i, rpom;
+  double era, xlod;
+  for (double step : {900e0, 3600e0, 3e0 * 3600e0}) {
+    dso::CelTerTable table(step);
+    if (table.build(mjd_start, mjd_end, eops)) {
+      fprintf(stderr, "Failed building table\n");
+      return 1;
+    }
+    double max_angle;
+    if (table.verify(eops, max_angle, 2000)) {
+      fprintf(stderr, "Failed verifying table\n");
+      return 1;
+    }
+
+    // time interpolated vs exact path, every 10 seconds
+    const int n = 3 * 8640;
+    auto t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < n; i++)
+      table.gcrs2itrs(mjd_start + i * 10e0 / 86400e0, rc2i, era, rpom, xlod);
+    auto t1 = std::chrono::steady_clock::now();
+    for (int i = 0; i < n; i++)
+      dso::gcrs2itrs(mjd_start + i * 10e0 / 86400e0, eops, rc2i, era, rpom,
+                     xlod);
+    auto t2 = std::chrono::steady_clock::now();
+
+    printf("step %6.0f [sec]: %4d nodes, max error %.3e [rad] (%.3f [mm] at "
+           "6378 km); %.3f vs %.3f [usec] per call (table vs exact)\n",
+           step, table.size(), max_angle, max_angle * 6378e6,
+           std::chrono::duration<double, std::micro>(t1 - t0).count() / n,
+           std::chrono::duration<double, std::micro>(t2 - t1).count() / n);
+  }
+
+  return 0;
+}
@@ -0,0 +1,64 @@
+#include "eigen3/Eigen/Eigen"
+#include "integrators.hpp"
+#include <cstdio>
+
+// Same demonstration program as test_ode_example.cpp (the defining
+// equations of the jacobian elliptic functions, ksq=k*k=0.51); the solution
+// is recorded as dense output while integrating and then evaluated at the
+// output points, without re-integrating. Results should match the ones
+// returned by SGOde::de.
+//   y1'=y2*y3,      y1(0)=0
+//   y2'=-y1*y3,     y2(0)=1
+//   y3'=-ksq*y1*y2, y3(0)=1
+
+void f([[maybe_unused]] double x,      // Independent variable
+       const Eigen::VectorXd &y,       // State (function values)
+       Eigen::Ref<Eigen::VectorXd> yp, // Partials/Derivative
+       [[maybe_unused]] dso::IntegrationParameters &params) noexcept {
+  yp(0) = y(1) * y(2);
+  yp(1) = -y(0) * y(2);
+  yp(2) = -0.51e0 * y(0) * y(1);
+  return;
+}
+
+int main() {
+  constexpr const int neqn = 3;
+  dso::SGOde Sg(f, neqn, 1e-9, 1e-16);
+
+  // record all steps
+  dso::DenseTrajectory dense(neqn);
+  Sg.dense = &dense;
+
+  double t = 0e0;
+  Eigen::VectorXd y(neqn), yy = Eigen::VectorXd::Zero(neqn);
+  y << 0e0, 1e0, 1e0;
+
+  // integrate and keep the solution at the output points
+  Eigen::MatrixXd sol(neqn, 13);
+  for (int i = 1; i <= 13; i++) {
+    double tout = 5e0 * i;
+    Sg.de(t, tout, y, yy);
+    if (Sg.flag() == 4 || Sg.flag() == 5) {
+      printf("integration failed, flag: %d\n", Sg.flag());
+      return 1;
+    }
+    sol.col(i - 1) = yy;
+    y = yy;
+  }
+
+  printf("- recorded %d steps, from t=%.3f to t=%.3f\n", dense.size(),
+         dense.tbegin(), dense.tend());
+
+  // evaluate dense output at the output points
+  for (int i = 1; i <= 13; i++) {
+    const double tout = 5e0 * i;
+    if (dense.interpolate(tout, yy)) {
+      printf("dense output failed for t=%.3f\n", tout);
+      return 1;
+    }
+    printf(" %16.8e %16.8e %16.8e %16.8e (diff: %.3e)\n", tout, yy(0), yy(1),
+           yy(2), (yy - sol.col(i - 1)).norm());
+  }
+
+  return 0;
+}
@@ -0,0 +1,119 @@
+#include "encke.hpp"
+#include "harmonic_coeffs.hpp"
+#include <cmath>
+#include <cstdio>
+
+// Regression test for the Encke-type propagation: integrate a (Jason-like,
+// ~1340 km altitude) orbit in the two-body + J2 field for a day, once with
+// dso::SGOde on the full equations of motion and once with
+// dso::EnckePropagator (hourly rectifications), and compare the two at
+// every output point (every 10 minutes). The number of rectifications is
+// checked as well, as is the rejection of invalid rectification thresholds.
+// Returns the number of failed checks.
+
+constexpr const double GM = 3986004.415e8;
+constexpr const double Re = 6378136.3e0;
+constexpr const double J2 = 1.08262668e-3;
+
+// two-body + J2 acceleration; J2 (un-normalized, aka -C20) off of the
+// parameters' harmonics
+void twobody_j2([[maybe_unused]] double t, const Eigen::VectorXd &y,
+                Eigen::Ref<Eigen::VectorXd> yp,
+                dso::IntegrationParameters &params) noexcept {
+  const Eigen::Matrix<double, 3, 1> r = y.head<3>();
+  const double r2 = r.squaredNorm();
+  const double rn = std::sqrt(r2);
+  const double z2r2 = r(2) * r(2) / r2;
+  const double kJ2 = -1.5e0 * params.harmonics.C(2, 0) * GM * Re * Re /
+                     (r2 * r2 * rn);
+  yp.head<3>() = y.segment<3>(3);
+  yp.segment<3>(3) = (-GM / (r2 * rn)) * r;
+  yp(3) -= kJ2 * r(0) * (1e0 - 5e0 * z2r2);
+  yp(4) -= kJ2 * r(1) * (1e0 - 5e0 * z2r2);
+  yp(5) -= kJ2 * r(2) * (3e0 - 5e0 * z2r2);
+}
+
+int main(int argc, char *argv[]) {
+  if (argc != 2) {
+    fprintf(stderr, "Usage: %s [PCK kernel]\n", argv[0]);
+    return 1;
+  }
+
+  // two-body + J2 field (un-normalized)
+  dso::HarmonicCoeffs hc(2, GM, Re);
+  for (int n = 0; n <= 2; n++) {
+    for (int m = 0; m <= n; m++) {
+      hc.C(n, m) = 0e0;
+      if (m)
+        hc.S(n, m) = 0e0;
+    }
+  }
+  hc.normalized() = false;
+  hc.C(0, 0) = 1e0;
+  hc.C(2, 0) = -J2;
+  dso::EopLookUpTable eops;
+  dso::IntegrationParameters params(2, 2, eops, hc, argv[1]);
+
+  // initial state; inclination 66 deg
+  const double a = Re + 1336e3;
+  const double v = std::sqrt(GM / a);
+  Eigen::VectorXd y0(6);
+  y0 << a, 0e0, 0e0, 5e0, v * std::cos(1.15e0), v * std::sin(1.15e0);
+
+  // one day, output every 10 minutes, hourly rectifications
+  constexpr const double tend = 86400e0;
+  constexpr const double dt = 600e0;
+  constexpr const double rect_interval = 3600e0;
+  dso::SGOde direct(twobody_j2, 6, 1e-12, 1e-12, &params);
+  dso::EnckePropagator encke(twobody_j2, 6, GM, params, 0e0, y0, 0e0, 1e-6,
+                             rect_interval);
+
+  int error = 0;
+  // invalid rectification thresholds are rejected (and not applied)
+  if (!encke.set_rectification(0e0, 1e-2) ||
+      !encke.set_rectification(rect_interval, -1e0) ||
+      encke.rectification_interval() != rect_interval) {
+    fprintf(stderr, "Failed! Invalid rectification thresholds accepted\n");
+    ++error;
+  }
+
+  double td = 0e0, te = 0e0, max_dr = 0e0, max_dv = 0e0;
+  Eigen::VectorXd yd = y0, yout(6);
+  for (double tout = dt; tout <= tend; tout += dt) {
+    // direct integration (keep on going if max number of steps is reached,
+    // but not for ever)
+    for (int calls = 0; direct.de(td, tout, yd, yout) &&
+                        (direct.flag() == 4 || direct.flag() == 5) &&
+                        calls < 20;
+         calls++)
+      ;
+    if (direct.flag() != 2) {
+      fprintf(stderr, "Direct integration failed at t=%.1f\n", tout);
+      return ++error;
+    }
+    yd = yout;
+
+    // Encke
+    if (encke.propagate(te, tout)) {
+      fprintf(stderr, "Encke propagation failed at t=%.1f\n", tout);
+      return ++error;
+    }
+
+    max_dr = std::max(max_dr, (encke.state().head<3>() - yd.head<3>()).norm());
+    max_dv = std::max(max_dv, (encke.state().tail<3>() - yd.tail<3>()).norm());
+  }
+
+  // one rectification at start, plus one every rect_interval up to (but not
+  // at) the end of the arc; no rectification due to a large deviation is
+  // expected for J2 only, within an hour
+  const long nrect_expected = (long)(tend / rect_interval);
+  printf("Encke vs direct: max position difference %.3e [m], max velocity "
+         "difference %.3e [m/sec], %ld rectifications (expected %ld)\n",
+         max_dr, max_dv, encke.num_rectifications(), nrect_expected);
+
+  error += !(max_dr < 1e-2);
+  error += !(max_dv < 1e-5);
+  error += (encke.num_rectifications() != nrect_expected);
+
+  return error;
+}
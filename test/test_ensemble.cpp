@@ -0,0 +1,155 @@
+#include "ensemble.hpp"
+#include "harmonic_coeffs.hpp"
+#include "integrators.hpp"
+#include "orbit_integration.hpp"
+#include <cmath>
+#include <cstdio>
+#include <datetime/dtfund.hpp>
+#include <vector>
+
+// Propagate an ensemble of K states with dso::EnsemblePropagator (shared
+// step size) and compare each member, at the end of a 1 hour arc, against:
+// * a single-member dso::EnsemblePropagator (same force model code, own
+//   step size), and
+// * an independent propagation of the member's state with
+//   dso::VariationalEquations and dso::SGOde.
+// The force model is a degree 4 geopotential plus Sun and Moon (analytic
+// ephemerides); no atmosphere is attached, hence there is no drag.
+// Returns the number of failed checks.
+
+constexpr const double GM = 3986004.415e8;
+constexpr const double Re = 6378136.3e0;
+// force model parameters (drag coefficient) in dso::VariationalEquations
+constexpr const int Np = 1;
+constexpr const int neqn = 6 + 6 * (6 + Np);
+// number of members
+constexpr const int K = 8;
+// length of the arc [sec]
+constexpr const double arc = 3600e0;
+// tolerances of the integrators
+constexpr const double tol = 1e-12;
+
+int main(int argc, char *argv[]) {
+  if (argc != 3) {
+    fprintf(stderr, "Usage: %s [EOP C04 file] [PCK kernel]\n", argv[0]);
+    return 1;
+  }
+
+  // EOP for the arc (plus margin for the interpolation)
+  dso::datetime<dso::nanoseconds> tstart(dso::year(2021), dso::month(12),
+                                         dso::day_of_month(20),
+                                         dso::nanoseconds(0));
+  dso::datetime<dso::nanoseconds> tend(dso::year(2022), dso::month(1),
+                                       dso::day_of_month(10),
+                                       dso::nanoseconds(0));
+  dso::EopLookUpTable eops;
+  if (dso::parse_iers_C04(argv[1], tstart.mjd(), tend.mjd(), eops)) {
+    fprintf(stderr, "Failed parsing IERS/C04 file %s\n", argv[1]);
+    return 1;
+  }
+  eops.regularize();
+
+  // degree 4 geopotential (un-normalized, EGM-like values)
+  constexpr const int degree = 4;
+  dso::HarmonicCoeffs hc(degree, GM, Re);
+  for (int n = 0; n <= degree; n++) {
+    for (int m = 0; m <= n; m++) {
+      hc.C(n, m) = 0e0;
+      if (m)
+        hc.S(n, m) = 0e0;
+    }
+  }
+  hc.normalized() = false;
+  hc.C(0, 0) = 1e0;
+  hc.C(2, 0) = -1.08262668e-3;
+  hc.C(2, 2) = 1.57446e-6;
+  hc.S(2, 2) = -9.03868e-7;
+  hc.C(3, 0) = 2.53266e-6;
+  hc.C(3, 1) = 2.19264e-6;
+  hc.S(3, 1) = 2.68012e-7;
+  hc.C(4, 0) = 1.61962e-6;
+
+  dso::IntegrationParameters params(degree, degree, eops, hc, argv[2]);
+  params.mjd_tai = tstart.as_mjd() + 8e0;
+  params.ephemeris_tier = dso::EphemerisTier::Analytic;
+
+  // members; Jason-like orbits (inclination 66 deg), spread by some hundred
+  // meters and a few meters/sec
+  const double a = Re + 1336e3;
+  const double v = std::sqrt(GM / a);
+  std::vector<Eigen::Matrix<double, 6, 1>> states(K);
+  for (int k = 0; k < K; k++)
+    states[k] << a + 100e0 * k, 1e3 * k, 5e3, 10e0,
+        v * std::cos(1.15e0) - k, v * std::sin(1.15e0);
+
+  // the ensemble
+  std::vector<Eigen::Matrix<double, 6, 1>> yens(K);
+  long nfev_ens;
+  {
+    dso::EnsemblePropagator ens(params, states, tol, tol);
+    double t = 0e0;
+    if (ens.propagate(t, arc)) {
+      fprintf(stderr, "Failed propagating the ensemble\n");
+      return 1;
+    }
+    for (int k = 0; k < K; k++)
+      yens[k] = ens.member(k);
+    nfev_ens = ens.num_fevals();
+  }
+
+  int error = 0;
+  double max_single = 0e0, max_indep = 0e0;
+  long nfev_single = 0;
+  for (int k = 0; k < K; k++) {
+    // single-member ensemble
+    Eigen::Matrix<double, 6, 1> y1;
+    {
+      dso::EnsemblePropagator one(params, {states[k]}, tol, tol);
+      double t = 0e0;
+      if (one.propagate(t, arc)) {
+        fprintf(stderr, "Failed propagating member %d\n", k);
+        return ++error;
+      }
+      y1 = one.member(0);
+      nfev_single += one.num_fevals();
+    }
+
+    // independent propagation (state and STM)
+    Eigen::VectorXd yphi = Eigen::VectorXd::Zero(neqn);
+    yphi.head<6>() = states[k];
+    for (int i = 0; i < 6; i++)
+      yphi(6 + 7 * i) = 1e0;
+    dso::SGOde ode(dso::VariationalEquations, neqn, tol, tol, &params);
+    double t = 0e0;
+    Eigen::VectorXd yout(neqn);
+    if (ode.de(t, arc, yphi, yout) || ode.flag() != 2) {
+      fprintf(stderr, "Failed propagating member %d (flag=%d)\n", k,
+              ode.flag());
+      return ++error;
+    }
+
+    const double ds = (yens[k] - y1).head<3>().norm();
+    const double di = (yens[k] - yout.head<6>()).head<3>().norm();
+    printf("Member %d: vs single-member ensemble %.3e [m], vs independent "
+           "%.3e [m]\n",
+           k, ds, di);
+    max_single = std::max(max_single, ds);
+    max_indep = std::max(max_indep, di);
+  }
+  printf("Force model evaluations: %ld (ensemble of %d) vs %ld (%d single "
+         "members)\n",
+         nfev_ens, K, nfev_single, K);
+
+  // the members differ only via the (shared) step size
+  if (!(max_single < 1e-3)) {
+    fprintf(stderr, "Failed! Ensemble differs from single-member runs\n");
+    ++error;
+  }
+  // different implementation of the same force model
+  if (!(max_indep < 1e-2)) {
+    fprintf(stderr, "Failed! Ensemble differs from independent runs\n");
+    ++error;
+  }
+
+  return error;
+}
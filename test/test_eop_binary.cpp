@@ -0,0 +1,64 @@
+#include "eop_binary.hpp"
+#include <chrono>
+#include <cstdio>
+
+// (Re-)create a binary EOP file off of a C04 file if needed (missing or
+// stale), then extract a month of EOP data from both and compare (results
+// and timing).
+
+int main(int argc, char *argv[]) {
+  if (argc != 3) {
+    fprintf(stderr, "Usage: %s [EOP C04 file] [binary EOP file]\n", argv[0]);
+    return 1;
+  }
+
+  dso::EopBinaryStore store;
+  if (store.open(argv[2]) || store.is_stale(argv[1])) {
+    printf("Converting %s to %s\n", argv[1], argv[2]);
+    if (dso::c04_to_binary(argv[1], argv[2]) || store.open(argv[2])) {
+      fprintf(stderr, "Failed creating binary EOP file %s\n", argv[2]);
+      return 1;
+    }
+  }
+  printf("Binary EOP store: %d records, MJD [%ld, %ld], %.0f sec old\n",
+         store.size(), store.first_mjd(), store.last_mjd(), store.age());
+
+  // last month in store
+  const dso::modified_julian_day end(store.last_mjd() + 1);
+  const dso::modified_julian_day start(store.last_mjd() - 30);
+
+  dso::EopLookUpTable from_c04, from_bin;
+  auto t0 = std::chrono::steady_clock::now();
+  if (dso::parse_iers_C04(argv[1], start, end, from_c04))
+    return 1;
+  auto t1 = std::chrono::steady_clock::now();
+  if (store.extract(start, end, from_bin))
+    return 1;
+  auto t2 = std::chrono::steady_clock::now();
+
+  int error = (from_c04.size() != from_bin.size());
+  for (int i = 0; !error && i < from_c04.size(); i++) {
+    error += (*from_c04.mjd(i) != *from_bin.mjd(i)) +
+             (*from_c04.xp(i) != *from_bin.xp(i)) +
+             (*from_c04.yp(i) != *from_bin.yp(i)) +
+             (*from_c04.dut(i) != *from_bin.dut(i)) +
+             (*from_c04.lod(i) != *from_bin.lod(i)) +
+             (*from_c04.dx(i) != *from_bin.dx(i)) +
+             (*from_c04.dy(i) != *from_bin.dy(i));
+  }
+
+  // an empty or reversed interval must be rejected
+  dso::EopLookUpTable empty;
+  if (!store.extract(start, start, empty) ||
+      !store.extract(end, start, empty)) {
+    fprintf(stderr, "Empty/reversed interval not rejected!\n");
+    ++error;
+  }
+
+  printf("%s: C04 parsing %.3f ms, binary extraction %.3f ms\n",
+         error ? "Tables differ!" : "Tables are identical",
+         std::chrono::duration<double, std::milli>(t1 - t0).count(),
+         std::chrono::duration<double, std::milli>(t2 - t1).count());
+
+  return error;
+}
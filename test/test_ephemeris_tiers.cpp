@@ -0,0 +1,150 @@
+#include "c2t_table.hpp"
+#include "orbit_integration.hpp"
+#include "planetpos.hpp"
+#include "sp3/sp3.hpp"
+#include "spk_ephemeris.hpp"
+#include "sunmoon_table.hpp"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+// Benchmark and accuracy harness for the ephemeris tiers (see
+// dso::EphemerisTier): for every epoch of an SP3 arc, compute Sun and Moon
+// positions and the induced (third-body) acceleration on the satellite,
+// using each tier; report run times and the differences w.r.t. the exact
+// tier (CSPICE), so that the fastest acceptable tier can be selected.
+
+using dso::sp3::SatelliteId;
+using Clock = std::chrono::steady_clock;
+
+struct TierResult {
+  double ms{0e0};
+  double max_acc{0e0}, rms_acc{0e0};
+  double max_sun{0e0}, max_mon{0e0};
+};
+
+int main(int argc, char *argv[]) {
+  if (argc != 6) {
+    fprintf(stderr,
+            "Usage: %s [SP3 file] [EOP C04 file] [SPK kernel] [LSK kernel] "
+            "[PCK kernel]\n",
+            argv[0]);
+    return 1;
+  }
+
+  // kernels and gravitational parameters
+  dso::cspice::load_if_unloaded_spk(argv[3]);
+  dso::cspice::load_if_unloaded_lsk(argv[4]);
+  double GMSun, GMMon;
+  if (dso::get_sun_moon_GM(argv[5], GMSun, GMMon)) {
+    fprintf(stderr, "Failed getting GM values from %s\n", argv[5]);
+    return 1;
+  }
+  dso::SpkReader spk;
+  if (spk.open(argv[3]))
+    return 1;
+  dso::SpkCursor spk_cursor(spk);
+
+  // satellite positions (earth-fixed) off of the SP3 file
+  dso::Sp3c sp3(argv[1]);
+  if (sp3.num_sats() != 1) {
+    fprintf(stderr, "This program only works with one satellite per SP3\n");
+    return 1;
+  }
+  SatelliteId sv;
+  sv.set_id(sp3.sattellite_vector()[0].id);
+  dso::Sp3DataBlock block;
+  std::vector<double> mjd;
+  std::vector<double> xyz;
+  int error;
+  while (!(error = sp3.get_next_data_block(sv, block))) {
+    if (block.flag.is_set(dso::Sp3Event::bad_abscent_position))
+      continue;
+    mjd.push_back(block.t.as_mjd());
+    for (int i = 0; i < 3; i++)
+      xyz.push_back(block.state[i] * 1e3);
+  }
+  if (error > 0 || mjd.empty()) {
+    fprintf(stderr, "Failed reading SP3 file %s\n", argv[1]);
+    return 1;
+  }
+  const int n = mjd.size();
+
+  // to celestial
+  dso::EopLookUpTable eops;
+  if (dso::parse_iers_C04(argv[2], dso::modified_julian_day((int)mjd[0] - 2),
+                          dso::modified_julian_day((int)mjd[n - 1] + 3),
+                          eops))
+    return 1;
+  Eigen::MatrixXd ter =
+      Eigen::Map<Eigen::Matrix<double, Eigen::Dynamic, 3, Eigen::RowMajor>>(
+          xyz.data(), n, 3);
+  Eigen::MatrixXd cel;
+  if (dso::ter2cel(mjd.data(), ter, cel, eops))
+    return 1;
+
+  // Sun/Moon table for the arc (build time is reported separately)
+  auto tb0 = Clock::now();
+  dso::SunMoonTable table;
+  if (table.build(mjd[0], mjd[n - 1], spk_cursor))
+    return 1;
+  const double build_ms =
+      std::chrono::duration<double, std::milli>(Clock::now() - tb0).count();
+
+  // evaluate all tiers; the first one (exact, CSPICE) is the reference
+  struct Tier {
+    const char *name;
+    dso::EphemerisTier tier;
+    dso::SpkCursor *cursor;
+  } tiers[] = {
+      {"exact (CSPICE)", dso::EphemerisTier::ExactSpk, nullptr},
+      {"exact (native SPK)", dso::EphemerisTier::ExactSpk, &spk_cursor},
+      {"cached SPK", dso::EphemerisTier::CachedSpk, nullptr},
+      {"analytic", dso::EphemerisTier::Analytic, nullptr},
+  };
+  constexpr const int ntiers = sizeof(tiers) / sizeof(tiers[0]);
+  std::vector<Eigen::Matrix<double, 3, 1>> ref_acc(n), ref_sun(n), ref_mon(n);
+  TierResult res[ntiers];
+
+  for (int k = 0; k < ntiers; k++) {
+    Eigen::Matrix<double, 3, 1> rsun, rmon, sun_acc, mon_acc;
+    Eigen::Matrix<double, 3, 3> partials;
+    auto t0 = Clock::now();
+    for (int i = 0; i < n; i++) {
+      const Eigen::Matrix<double, 3, 1> r = cel.row(i).transpose();
+      if (dso::sun_moon_positions(mjd[i], tiers[k].tier, &table,
+                                  tiers[k].cursor, rsun, rmon))
+        return 1;
+      dso::SunMoon(rsun, rmon, r, GMSun, GMMon, sun_acc, mon_acc, partials);
+      if (!k) {
+        ref_acc[i] = sun_acc + mon_acc;
+        ref_sun[i] = rsun;
+        ref_mon[i] = rmon;
+      } else {
+        const double da = (sun_acc + mon_acc - ref_acc[i]).norm();
+        res[k].max_acc = std::max(res[k].max_acc, da);
+        res[k].rms_acc += da * da;
+        res[k].max_sun = std::max(res[k].max_sun, (rsun - ref_sun[i]).norm());
+        res[k].max_mon = std::max(res[k].max_mon, (rmon - ref_mon[i]).norm());
+      }
+    }
+    res[k].ms =
+        std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+    res[k].rms_acc = std::sqrt(res[k].rms_acc / n);
+  }
+
+  printf("Arc: %d epochs, MJD [%.6f, %.6f]; Sun/Moon table built in %.3f ms "
+         "(segments: Sun %.3f, Moon %.3f days)\n",
+         n, mjd[0], mjd[n - 1], build_ms, table.sun_segment_length(),
+         table.moon_segment_length());
+  printf("%-20s %12s %12s %14s %14s %12s %12s\n", "tier", "total [ms]",
+         "per call[us]", "max da[m/s2]", "rms da[m/s2]", "max dSun[m]",
+         "max dMoon[m]");
+  for (int k = 0; k < ntiers; k++)
+    printf("%-20s %12.3f %12.3f %14.3e %14.3e %12.3e %12.3e\n", tiers[k].name,
+           res[k].ms, 1e3 * res[k].ms / n, res[k].max_acc, res[k].rms_acc,
+           res[k].max_sun, res[k].max_mon);
+
+  return 0;
+}
@@ -0,0 +1,83 @@
+#include "eigen3/Eigen/Eigen"
+#include "integrators.hpp"
+#include <cmath>
+#include <cstdio>
+
+// Integrate a circular (two-body) orbit with the Gauss-Jackson integrator
+// and with dso::SGOde, and compare both against the analytic solution.
+// Also report the number of right-hand side evaluations needed, and check
+// the integrators' statistics against the calls actually made.
+
+constexpr const double GM = 3.986004415e14;
+constexpr const double R = 7000e3;
+
+long sg_calls = 0;
+
+void twobody([[maybe_unused]] double t, const Eigen::VectorXd &y,
+             Eigen::Ref<Eigen::VectorXd> yp,
+             [[maybe_unused]] dso::IntegrationParameters &params) noexcept {
+  const double r = y.head<3>().norm();
+  yp.head<3>() = y.segment<3>(3);
+  yp.segment<3>(3) = -GM / (r * r * r) * y.head<3>();
+  ++sg_calls;
+}
+
+Eigen::VectorXd circular(double t) noexcept {
+  const double n = std::sqrt(GM / (R * R * R));
+  Eigen::VectorXd y(6);
+  y << R * std::cos(n * t), R * std::sin(n * t), 0e0,
+      -R * n * std::sin(n * t), R * n * std::cos(n * t), 0e0;
+  return y;
+}
+
+int main() {
+  dso::GaussJackson gj(twobody, 6, 60e0);
+  dso::SGOde sg(twobody, 6, 1e-12, 1e-12);
+
+  // integrate for a day, with output every 10 seconds
+  double tg = 0e0, ts = 0e0;
+  Eigen::VectorXd yg = circular(0e0), ys = circular(0e0);
+  Eigen::VectorXd yout(6);
+  double gmax = 0e0, smax = 0e0;
+  long sg_fevals = 0;
+  for (int i = 1; i <= 8640; i++) {
+    const double tout = 10e0 * i;
+    if (gj.de(tg, tout, yg, yout)) {
+      fprintf(stderr, "Gauss-Jackson integration failed!\n");
+      return 1;
+    }
+    yg = yout;
+    gmax = std::max(gmax, (yg.head<3>() - circular(tout).head<3>()).norm());
+
+    sg_calls = 0;
+    sg.de(ts, tout, ys, yout);
+    sg_fevals += sg_calls;
+    if (sg.flag() != 2) {
+      fprintf(stderr, "SGOde integration failed!\n");
+      return 1;
+    }
+    ys = yout;
+    smax = std::max(smax, (ys.head<3>() - circular(tout).head<3>()).norm());
+  }
+
+  printf("Gauss-Jackson: max position error %.3e [m], %ld evaluations\n", gmax,
+         gj.num_fevals());
+  printf("SGOde        : max position error %.3e [m], %ld evaluations\n", smax,
+         sg_fevals);
+  gj.stats.print("Gauss-Jackson");
+  sg.stats.print("SGOde");
+
+  // one start-up (8 steps), then one accepted step per 60 sec
+  int error = 0;
+  if (gj.stats.nstarts != 1 || gj.stats.nreject ||
+      gj.stats.naccept != (long)((86400e0 - 8 * 60e0) / 60e0)) {
+    fprintf(stderr, "Failed! Unexpected Gauss-Jackson statistics\n");
+    ++error;
+  }
+  if (sg.stats.nfev != sg_fevals) {
+    fprintf(stderr, "Failed! SGOde evaluations miscounted\n");
+    ++error;
+  }
+
+  return error;
+}
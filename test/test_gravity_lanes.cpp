@@ -0,0 +1,87 @@
+#include "egravity.hpp"
+#include "eigen3/Eigen/Eigen"
+#include "icgemio.hpp"
+#include <cassert>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+using namespace dso;
+
+// Compare the batched (SIMD lanes) geopotential acceleration, against the
+// scalar one, for a number of random positions
+int main(int argc, char *argv[]) {
+  if (argc < 2 || argc > 4) {
+    fprintf(stderr,
+            "Usage: %s <GRAVITY MODEL FILE> [DEGREE - optional] [NUM "
+            "POSITIONS - optional]\n",
+            argv[0]);
+    return 1;
+  }
+
+  Icgem gfc(argv[1]);
+  if (gfc.parse_header()) {
+    fprintf(stderr, "ERROR! Failed to parse icgem header!\n");
+    return 1;
+  }
+
+  int degree = gfc.degree();
+  if (argc >= 3)
+    degree = std::atoi(argv[2]);
+  const int order = degree;
+  assert(degree <= gfc.degree());
+
+  int K = 50;
+  if (argc == 4)
+    K = std::atoi(argv[3]);
+
+  HarmonicCoeffs hc(degree);
+  if (gfc.parse_data(degree, order, &hc)) {
+    fprintf(stderr, "ERROR! Failed to parse harmonic coefficients\n");
+    return 1;
+  }
+  hc.denormalize();
+
+  // random positions, at LEO/MEO altitudes
+  std::mt19937 gen(11);
+  std::uniform_real_distribution<double> dir(-1e0, 1e0);
+  std::uniform_real_distribution<double> alt(300e3, 20000e3);
+  std::vector<double> x(K), y(K), z(K), ax(K), ay(K), az(K);
+  for (int k = 0; k < K; k++) {
+    Eigen::Matrix<double, 3, 1> u(dir(gen), dir(gen), dir(gen));
+    u = u.normalized() * (gfc.earth_radius() + alt(gen));
+    x[k] = u(0);
+    y[k] = u(1);
+    z[k] = u(2);
+  }
+
+  // batched
+  GravityLanes lanes(degree, order);
+  auto start = std::chrono::steady_clock::now();
+  lanes.accel(K, x.data(), y.data(), z.data(), hc, ax.data(), ay.data(),
+              az.data());
+  auto stop = std::chrono::steady_clock::now();
+  printf("Batched evaluation of %d positions: %.3f ms\n", K,
+         std::chrono::duration<double, std::milli>(stop - start).count());
+
+  // scalar
+  Mat2D<MatrixStorageType::Trapezoid> V(degree + 3, order + 3),
+      W(degree + 3, order + 3);
+  double max_diff = 0e0;
+  start = std::chrono::steady_clock::now();
+  for (int k = 0; k < K; k++) {
+    const Eigen::Matrix<double, 3, 1> acc = grav_potential_accel(
+        Eigen::Matrix<double, 3, 1>(x[k], y[k], z[k]), degree, order, V, W, hc);
+    const Eigen::Matrix<double, 3, 1> lacc(ax[k], ay[k], az[k]);
+    max_diff = std::max(max_diff, (acc - lacc).norm() / acc.norm());
+  }
+  stop = std::chrono::steady_clock::now();
+  printf("Scalar evaluation of %d positions : %.3f ms\n", K,
+         std::chrono::duration<double, std::milli>(stop - start).count());
+
+  printf("Max relative difference: %.3e\n", max_diff);
+  assert(max_diff < 1e-12);
+
+  return 0;
+}
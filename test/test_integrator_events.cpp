@@ -0,0 +1,271 @@
+#include "astrodynamics.hpp"
+#include "eigen3/Eigen/Eigen"
+#include "geodesy/geodesy.hpp"
+#include "harmonic_coeffs.hpp"
+#include "integrators.hpp"
+#include "orbit_integration.hpp"
+#include <cmath>
+#include <cstdio>
+#include <datetime/dtfund.hpp>
+
+// Integrate an inclined, circular (two-body) orbit for a day, with dso::SGOde
+// and dso::DormandPrince853, while detecting:
+// * node crossings (z = 0), a non-terminal event, and
+// * shadow entry/exit, for a cylindrical shadow model with the Sun fixed
+//   along the +x axis; this is a terminal event, i.e. the integrators stop
+//   and are restarted at every crossing (as would be needed to switch a
+//   force model term, discontinuous at the shadow boundary, on/off).
+// Event times are compared against the analytic ones.
+//
+// If an EOP (C04) file and a PCK kernel are given, the event factories
+// dso::shadow_event and dso::beacon_elevation_event are checked too, i.e.
+// the located crossings are checked against the shadow geometry (Sun
+// position) and against the beacon elevation computed independently (via
+// dso::gcrs2itrs).
+
+constexpr const double GM = 3.986004415e14;
+constexpr const double R = 7000e3;
+constexpr const double Re = 6378136.6;
+constexpr const double inc = 1.15e0;
+
+void twobody([[maybe_unused]] double t, const Eigen::VectorXd &y,
+             Eigen::Ref<Eigen::VectorXd> yp,
+             [[maybe_unused]] dso::IntegrationParameters &params) noexcept {
+  const double r = y.head<3>().norm();
+  yp.head<3>() = y.segment<3>(3);
+  yp.segment<3>(3) = -GM / (r * r * r) * y.head<3>();
+}
+
+Eigen::VectorXd circular(double t) noexcept {
+  const double n = std::sqrt(GM / (R * R * R));
+  Eigen::VectorXd y(6);
+  y << R * std::cos(n * t), R * std::cos(inc) * std::sin(n * t),
+      R * std::sin(inc) * std::sin(n * t), -R * n * std::sin(n * t),
+      R * n * std::cos(inc) * std::cos(n * t),
+      R * n * std::sin(inc) * std::cos(n * t);
+  return y;
+}
+
+/// error of located events w.r.t. the analytic event times
+double check_events(const dso::EventDetector &events, int &node_count,
+                    int &shadow_count) noexcept {
+  const double n = std::sqrt(GM / (R * R * R));
+  // argument of latitude at shadow entry/exit
+  const double ushadow = std::asin(Re / R);
+  double max_error = 0e0;
+  node_count = shadow_count = 0;
+  for (const auto &e : events.occurrences()) {
+    const double u = n * e.t;
+    double error;
+    if (e.id == 0) {
+      // node crossing, at u = kπ
+      error = std::remainder(u, M_PI) / n;
+      ++node_count;
+    } else {
+      // shadow entry at u = π - ushadow, exit at u = π + ushadow (mod 2π)
+      const double u0 = (e.direction < 0) ? M_PI - ushadow : M_PI + ushadow;
+      error = std::remainder(u - u0, 2e0 * M_PI) / n;
+      ++shadow_count;
+    }
+    max_error = std::max(max_error, std::abs(error));
+  }
+  return max_error;
+}
+
+template <typename Integrator>
+int run(Integrator &integrator, const char *name) noexcept {
+  dso::EventDetector events(1e-6);
+
+  // node crossings
+  dso::Event node;
+  node.g = [](double, const Eigen::VectorXd &y) { return y(2); };
+  node.id = 0;
+  events.add(node);
+
+  // shadow (cylindrical), with the Sun along +x; negative in shadow
+  dso::Event shadow;
+  shadow.g = [](double, const Eigen::VectorXd &y) {
+    const Eigen::Matrix<double, 3, 1> r = y.head<3>();
+    if (r(0) > 0e0)
+      return r.norm() - Re;
+    return std::sqrt(r(1) * r(1) + r(2) * r(2)) - Re;
+  };
+  shadow.terminal = true;
+  shadow.id = 1;
+  events.add(shadow);
+
+  integrator.events = &events;
+
+  // integrate for a day, with output every 60 seconds
+  double t = 0e0;
+  Eigen::VectorXd y = circular(0e0), yout(6);
+  int restarts = 0;
+  double max_error = 0e0;
+  for (int i = 1; i <= 1440; i++) {
+    const double tout = 60e0 * i;
+    while (t != tout) {
+      integrator.de(t, tout, y, yout);
+      if (integrator.flag() != 2) {
+        fprintf(stderr, "%s integration failed!\n", name);
+        return 1;
+      }
+      y = yout;
+      if (t != tout) {
+        // stopped at a terminal event; here we would switch SRP on/off;
+        // restart the integrator
+        integrator.flag() = 1;
+        ++restarts;
+      }
+    }
+    max_error = std::max(max_error, (y.head<3>() - circular(t).head<3>()).norm());
+  }
+
+  int nodes, shadows;
+  const double terror = check_events(events, nodes, shadows);
+  printf("%s: %d node crossings, %d shadow entries/exits (%d restarts), max "
+         "event time error %.3e [sec], max position error %.3e [m]\n",
+         name, nodes, shadows, restarts, terror, max_error);
+
+  return 0;
+}
+
+/// check the crossings located via the event factories (shadow: id 10,
+/// beacon: id 20); returns the number of failed checks
+int check_factory_events(const dso::EventDetector &events,
+                         dso::IntegrationParameters &params,
+                         const Eigen::Matrix<double, 3, 1> &beacon,
+                         double cut_off, const char *name) noexcept {
+  // ellipsoidal normal at the beacon
+  const Eigen::Matrix<double, 3, 1> lfh =
+      dso::car2ell<dso::ellipsoid::grs80>(beacon);
+  Eigen::Matrix<double, 3, 1> up;
+  up << std::cos(lfh(1)) * std::cos(lfh(0)),
+      std::cos(lfh(1)) * std::sin(lfh(0)), std::sin(lfh(1));
+
+  int error = 0, nshadow = 0, nbeacon = 0, last_shadow = 1, last_beacon = 0;
+  double max_shadow = 0e0, max_beacon = 0e0;
+  for (const auto &e : events.occurrences()) {
+    const double cmjd = params.mjd_tai + e.t / dso::sec_per_day;
+    const Eigen::Matrix<double, 3, 1> r = e.y.head<3>();
+    if (e.id == 10) {
+      // middle of the penumbra: the Sun's center is on the Earth's limb,
+      // i.e. the angle between the Earth's and the Sun's center (as seen
+      // from the satellite) equals the Earth's apparent radius
+      const Eigen::Matrix<double, 3, 1> d =
+          dso::update_time_cache(cmjd, params).rsun - r;
+      const double te = std::asin(iers2010::Re / r.norm());
+      const double tes = std::acos(-r.dot(d) / (r.norm() * d.norm()));
+      max_shadow = std::max(max_shadow, std::abs(tes - te));
+      // entries (Falling) and exits (Rising) alternate, starting with an
+      // entry (start is on the sunlit side)
+      error += (e.direction == last_shadow);
+      last_shadow = e.direction;
+      ++nshadow;
+    } else if (e.id == 20) {
+      Eigen::Matrix<double, 3, 3> rc2i, rpom;
+      double era, xlod;
+      if (dso::gcrs2itrs(cmjd, params.eopLUT, rc2i, era, rpom, xlod)) {
+        fprintf(stderr, "Failed computing transformation at MJD=%.6f\n",
+                cmjd);
+        return ++error;
+      }
+      const Eigen::Matrix<double, 3, 1> rho =
+          (dso::rcel2ter(r, rc2i, era, rpom) - beacon).normalized();
+      max_beacon =
+          std::max(max_beacon, std::abs(rho.dot(up) - std::sin(cut_off)));
+      // rises (Rising) and sets (Falling) alternate
+      error += (e.direction == last_beacon);
+      last_beacon = e.direction;
+      ++nbeacon;
+    }
+  }
+
+  printf("%s: %d shadow entries/exits, max angle error %.3e [rad]; %d beacon "
+         "rises/sets, max sin(elevation) error %.3e\n",
+         name, nshadow, max_shadow, nbeacon, max_beacon);
+  // about 15 revolutions per day, all with an eclipse (the Sun is in the
+  // orbital plane); a few passes over the beacon
+  error += (nshadow < 28);
+  error += !(max_shadow < 1e-4);
+  error += (nbeacon < 2);
+  error += !(max_beacon < 1e-5);
+  return error;
+}
+
+template <typename Integrator>
+int run_factories(Integrator &integrator, dso::IntegrationParameters &params,
+                  const char *name) noexcept {
+  // beacon at ~45 deg latitude, 10 deg longitude; 10 deg cut-off
+  const Eigen::Matrix<double, 3, 1> beacon(4464e3, 787e3, 4487e3);
+  const double cut_off = 10e0 * M_PI / 180e0;
+
+  dso::EventDetector events(1e-6);
+  events.add(dso::shadow_event(params, 10));
+  events.add(dso::beacon_elevation_event(params, beacon, cut_off, 20));
+  integrator.events = &events;
+
+  // circular orbit in the plane holding the Sun (at start), and the z axis;
+  // starts at the point closest to the Sun
+  const Eigen::Matrix<double, 3, 1> sun =
+      dso::update_time_cache(params.mjd_tai, params).rsun.normalized();
+  const Eigen::Matrix<double, 3, 1> ez =
+      (Eigen::Matrix<double, 3, 1>::UnitZ() - sun.z() * sun).normalized();
+  const double n = std::sqrt(GM / (R * R * R));
+  Eigen::VectorXd y(6), yout(6);
+  y << R * sun, R * n * ez;
+
+  // integrate for a day, with output every 60 seconds
+  double t = 0e0;
+  for (int i = 1; i <= 1440; i++) {
+    integrator.de(t, 60e0 * i, y, yout);
+    if (integrator.flag() != 2) {
+      fprintf(stderr, "%s integration failed!\n", name);
+      return 1;
+    }
+    y = yout;
+  }
+
+  return check_factory_events(events, params, beacon, cut_off, name);
+}
+
+int main(int argc, char *argv[]) {
+  if (argc != 1 && argc != 3) {
+    fprintf(stderr, "Usage: %s [EOP C04 file - optional] [PCK kernel - "
+                    "optional]\n",
+            argv[0]);
+    return 1;
+  }
+
+  dso::SGOde sg(twobody, 6, 1e-12, 1e-12);
+  dso::DormandPrince853 rk(twobody, 6, 1e-12, 1e-12);
+  if (run(sg, "SGOde "))
+    return 1;
+  if (run(rk, "DOP853"))
+    return 1;
+  if (argc == 1)
+    return 0;
+
+  // event factories; these need the force model's time cache (EOP and Sun)
+  dso::datetime<dso::nanoseconds> tstart(dso::year(2021), dso::month(12),
+                                         dso::day_of_month(20),
+                                         dso::nanoseconds(0));
+  dso::datetime<dso::nanoseconds> tend(dso::year(2022), dso::month(1),
+                                       dso::day_of_month(10),
+                                       dso::nanoseconds(0));
+  dso::EopLookUpTable eops;
+  if (dso::parse_iers_C04(argv[1], tstart.mjd(), tend.mjd(), eops)) {
+    fprintf(stderr, "Failed parsing IERS/C04 file %s\n", argv[1]);
+    return 1;
+  }
+  eops.regularize();
+  dso::HarmonicCoeffs hc(2, GM, Re);
+  dso::IntegrationParameters params(2, 2, eops, hc, argv[2]);
+  params.mjd_tai = tstart.as_mjd() + 8e0;
+  params.ephemeris_tier = dso::EphemerisTier::Analytic;
+
+  dso::SGOde sgf(twobody, 6, 1e-12, 1e-12);
+  dso::DormandPrince853 rkf(twobody, 6, 1e-12, 1e-12);
+  int error = run_factories(sgf, params, "SGOde ");
+  error += run_factories(rkf, params, "DOP853");
+  return error;
+}
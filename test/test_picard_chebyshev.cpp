@@ -0,0 +1,121 @@
+#include "eigen3/Eigen/Eigen"
+#include "harmonic_coeffs.hpp"
+#include "integrators.hpp"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <memory>
+#include <vector>
+
+// Propagate a (two-body) orbit for a day, with the Modified Chebyshev-Picard
+// Iteration propagator, using 1 and 4 threads, and compare against the
+// analytic solution (at off-node epochs, via the Chebyshev representation of
+// the arc). The result of dso::SGOde is also given for comparison.
+// Note that for such a cheap right-hand side, the (thread synchronization)
+// overhead dominates; threads pay off for expensive force models (e.g. high
+// degree gravity fields).
+
+constexpr const double GM = 3.986004415e14;
+constexpr const double R = 7000e3;
+
+void twobody([[maybe_unused]] double t, const Eigen::VectorXd &y,
+             Eigen::Ref<Eigen::VectorXd> yp,
+             [[maybe_unused]] dso::IntegrationParameters &params) noexcept {
+  const double r = y.head<3>().norm();
+  yp.head<3>() = y.segment<3>(3);
+  yp.segment<3>(3) = -GM / (r * r * r) * y.head<3>();
+}
+
+Eigen::VectorXd circular(double t) noexcept {
+  const double n = std::sqrt(GM / (R * R * R));
+  Eigen::VectorXd y(6);
+  y << R * std::cos(n * t), R * std::sin(n * t), 0e0,
+      -R * n * std::sin(n * t), R * n * std::cos(n * t), 0e0;
+  return y;
+}
+
+int main(int argc, char *argv[]) {
+  if (argc != 2) {
+    fprintf(stderr, "Usage: %s [PCK kernel]\n", argv[0]);
+    return 1;
+  }
+
+  // the right-hand side does not actually use any parameters; still, every
+  // thread needs its own instance (with no shared mutable state)
+  dso::HarmonicCoeffs hc(2, GM, R);
+  dso::EopLookUpTable eops;
+  std::vector<std::unique_ptr<dso::IntegrationParameters>> instances;
+  for (int i = 0; i < 4; i++) {
+    instances.push_back(std::make_unique<dso::IntegrationParameters>(
+        2, 2, eops, hc, argv[1]));
+    instances.back()->ephemeris_tier = dso::EphemerisTier::Analytic;
+  }
+
+  const double tend = 86400e0;
+  // segments of (about) a quarter of a revolution
+  const double seg = 2e0 * M_PI * std::sqrt(R * R * R / GM) / 4e0;
+
+  for (int nthreads : {1, 4}) {
+    std::vector<dso::IntegrationParameters *> params;
+    for (int i = 0; i < nthreads; i++)
+      params.push_back(instances[i].get());
+    dso::PicardChebyshev mcpi(twobody, 6, 40, 1e-14, 1e-6, params);
+    if (mcpi.num_threads() != nthreads) {
+      fprintf(stderr, "Picard-Chebyshev not using %d threads!\n", nthreads);
+      return 1;
+    }
+    dso::ChebyshevTrajectory traj(6);
+
+    const auto start = std::chrono::steady_clock::now();
+    if (mcpi.propagate(0e0, circular(0e0), tend, seg, traj)) {
+      fprintf(stderr, "Picard-Chebyshev propagation failed!\n");
+      return 1;
+    }
+    const auto stop = std::chrono::steady_clock::now();
+
+    // check solution and derivative at (off-node) epochs
+    Eigen::VectorXd y(6), yp(6), ypref(6);
+    double pmax = 0e0, vmax = 0e0;
+    for (double t = 0e0; t <= tend; t += 7.3e0) {
+      if (traj.interpolate(t, y, &yp))
+        return 1;
+      twobody(t, circular(t), ypref, *params[0]);
+      pmax = std::max(pmax, (y.head<3>() - circular(t).head<3>()).norm());
+      vmax = std::max(vmax, (yp.head<3>() - ypref.head<3>()).norm());
+    }
+
+    printf("MCPI (%d threads): max position error %.3e [m], velocity (from "
+           "derivative) %.3e [m/s]\n",
+           nthreads, pmax, vmax);
+    printf("                  %d segments, %ld iterations, %ld evaluations, "
+           "%.1f ms\n",
+           traj.size(), mcpi.num_iterations(), mcpi.num_fevals(),
+           std::chrono::duration<double, std::milli>(stop - start).count());
+    mcpi.stats.print("                  MCPI statistics");
+    // one step per segment
+    if (mcpi.stats.naccept != traj.size() || mcpi.stats.nreject ||
+        mcpi.stats.nstarts != 1) {
+      fprintf(stderr, "Failed! Unexpected Picard-Chebyshev statistics\n");
+      return 1;
+    }
+  }
+
+  // SGOde, for reference
+  dso::SGOde sg(twobody, 6, 1e-12, 1e-12, instances[0].get());
+  double t = 0e0;
+  Eigen::VectorXd ys = circular(0e0), yout(6);
+  double smax = 0e0;
+  for (int i = 1; i <= 8640; i++) {
+    const double tout = 10e0 * i;
+    sg.de(t, tout, ys, yout);
+    if (sg.flag() != 2) {
+      fprintf(stderr, "SGOde integration failed!\n");
+      return 1;
+    }
+    ys = yout;
+    smax = std::max(smax, (ys.head<3>() - circular(tout).head<3>()).norm());
+  }
+  printf("SGOde            : max position error %.3e [m]\n", smax);
+
+  return 0;
+}
@@ -0,0 +1,74 @@
+#include "eigen3/Eigen/Eigen"
+#include "integrators.hpp"
+#include <cstdio>
+
+// Same demonstration program as test_ode_example.cpp (the defining
+// equations of the jacobian elliptic functions, ksq=k*k=0.51), solved with
+// both the dynamic (dso::SGOde) and the fixed-size (dso::SGOdeN)
+// integrators. Results (and integrator statistics) should be identical.
+//   y1'=y2*y3,      y1(0)=0
+//   y2'=-y1*y3,     y2(0)=1
+//   y3'=-ksq*y1*y2, y3(0)=1
+
+void f([[maybe_unused]] double x,      // Independent variable
+       const Eigen::VectorXd &y,       // State (function values)
+       Eigen::Ref<Eigen::VectorXd> yp, // Partials/Derivative
+       [[maybe_unused]] dso::IntegrationParameters &params) noexcept {
+  yp(0) = y(1) * y(2);
+  yp(1) = -y(0) * y(2);
+  yp(2) = -0.51e0 * y(0) * y(1);
+  return;
+}
+
+int main() {
+  constexpr const int neqn = 3;
+  const double relerr_ode = 1e-9;
+  const double abserr_ode = 1e-16;
+
+  // dynamic-size integrator
+  dso::SGOde Sg(f, neqn, relerr_ode, abserr_ode);
+
+  // fixed-size integrator; the derivative function is a lambda
+  auto fn = [](double, const Eigen::Matrix<double, neqn, 1> &y,
+               Eigen::Matrix<double, neqn, 1> &yp) {
+    yp(0) = y(1) * y(2);
+    yp(1) = -y(0) * y(2);
+    yp(2) = -0.51e0 * y(0) * y(1);
+  };
+  dso::SGOdeN<neqn, decltype(fn)> SgN(fn, relerr_ode, abserr_ode);
+
+  double t = 0e0, tn = 0e0;
+  Eigen::VectorXd y(3), yy = Eigen::VectorXd::Zero(3);
+  Eigen::Matrix<double, neqn, 1> yn,
+      yyn = Eigen::Matrix<double, neqn, 1>::Zero();
+  y << 0e0, 1e0, 1e0;
+  yn << 0e0, 1e0, 1e0;
+
+  printf("- neqn=%3d relerr=%.2e abserr=%.2e iflag=%3d\n", neqn, relerr_ode,
+         abserr_ode, SgN.flag());
+  for (int i = 1; i <= 13; i++) {
+    double tout = 5e0 * i;
+    Sg.de(t, tout, y, yy);
+    SgN.de(tn, tout, yn, yyn);
+    printf(" %16.8e %16.8e %16.8e %16.8e %3d (diff: %.3e)\n", tn, yyn(0),
+           yyn(1), yyn(2), SgN.flag(), (yy - yyn).norm());
+    if (SgN.flag() == 4 || SgN.flag() == 5) {
+      printf("integration failed, flag: %d\n", SgN.flag());
+      return 1;
+    }
+    y = yy;
+    yn = yyn;
+  }
+
+  Sg.stats.print("SGOde ");
+  SgN.stats.print("SGOdeN");
+  if (Sg.stats.nfev != SgN.stats.nfev ||
+      Sg.stats.naccept != SgN.stats.naccept ||
+      Sg.stats.nreject != SgN.stats.nreject ||
+      Sg.stats.norder_changes != SgN.stats.norder_changes ||
+      Sg.stats.nstarts != SgN.stats.nstarts) {
+    printf("statistics differ\n");
+    return 1;
+  }
+  return 0;
+}
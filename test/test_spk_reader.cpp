@@ -0,0 +1,100 @@
+#include "planetpos.hpp"
+#include "spk_ephemeris.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+// Compare Sun and Moon (geocentric) positions from the native SPK reader
+// (dso::SpkReader/dso::SpkCursor) against CSPICE, for a month of epochs,
+// and time both; then evaluate the same epochs concurrently, on a few
+// threads (one cursor each) and check that results agree.
+
+constexpr const int num_epochs = 30 * 24 * 60; // every minute
+constexpr const double mjd_tt_start = 59580e0;
+
+int main(int argc, char *argv[]) {
+  if (argc != 3) {
+    fprintf(stderr, "Usage: %s [SPK kernel, e.g. de440.bsp] [LSK kernel]\n",
+            argv[0]);
+    return 1;
+  }
+
+  dso::SpkReader spk;
+  if (spk.open(argv[1])) {
+    fprintf(stderr, "Failed opening SPK file %s\n", argv[1]);
+    return 1;
+  }
+  printf("SPK file %s: %d segments\n", argv[1], spk.num_segments());
+  dso::cspice::load_if_unloaded_spk(argv[1]);
+  dso::cspice::load_if_unloaded_lsk(argv[2]);
+
+  std::vector<double> et(num_epochs);
+  double max_det = 0e0;
+  for (int i = 0; i < num_epochs; i++) {
+    const double mjd_tt = mjd_tt_start + i / 1440e0;
+    et[i] = dso::tt2et(mjd_tt);
+    max_det = std::max(
+        max_det, std::abs(et[i] - dso::cspice::jd2et(mjd_tt + dso::mjd0_jd)));
+  }
+  printf("Max ET difference (native - CSPICE): %.3e [sec]\n", max_det);
+
+  // CSPICE
+  std::vector<double> ref(6 * num_epochs), nat(6 * num_epochs);
+  auto t0 = std::chrono::steady_clock::now();
+  for (int i = 0; i < num_epochs; i++) {
+    dso::cspice::j2planet_pos_from(et[i], 10, 399, &ref[6 * i]);
+    dso::cspice::j2planet_pos_from(et[i], 301, 399, &ref[6 * i + 3]);
+  }
+  auto t1 = std::chrono::steady_clock::now();
+
+  // native reader, one cursor
+  dso::SpkCursor cursor(spk);
+  for (int i = 0; i < num_epochs; i++) {
+    if (cursor.position(et[i], 10, 399, &nat[6 * i]) ||
+        cursor.position(et[i], 301, 399, &nat[6 * i + 3]))
+      return 1;
+  }
+  auto t2 = std::chrono::steady_clock::now();
+
+  double dsun = 0e0, dmon = 0e0;
+  for (int i = 0; i < num_epochs; i++) {
+    for (int j = 0; j < 3; j++) {
+      dsun = std::max(dsun, std::abs(ref[6 * i + j] - nat[6 * i + j]));
+      dmon = std::max(dmon, std::abs(ref[6 * i + 3 + j] - nat[6 * i + 3 + j]));
+    }
+  }
+  printf("Max difference (native - CSPICE): Sun %.3e [km], Moon %.3e [km]\n",
+         dsun, dmon);
+  printf("Timing for %d epochs: CSPICE %.3f ms, native %.3f ms (cursor "
+         "hits/misses: %ld/%ld)\n",
+         num_epochs,
+         std::chrono::duration<double, std::milli>(t1 - t0).count(),
+         std::chrono::duration<double, std::milli>(t2 - t1).count(),
+         cursor.hits(), cursor.misses());
+
+  // concurrent evaluation, one cursor per thread
+  const int nthreads = 4;
+  std::vector<double> par(6 * num_epochs);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < nthreads; t++) {
+    threads.emplace_back([&, t]() {
+      dso::SpkCursor c(spk);
+      for (int i = t; i < num_epochs; i += nthreads) {
+        c.position(et[i], 10, 399, &par[6 * i]);
+        c.position(et[i], 301, 399, &par[6 * i + 3]);
+      }
+    });
+  }
+  for (auto &thread : threads)
+    thread.join();
+  const bool same = std::equal(par.begin(), par.end(), nat.begin());
+  printf("Concurrent evaluation (%d threads): %s\n", nthreads,
+         same ? "identical results" : "results differ!");
+
+  // agreement to numerical precision (differences should be at the level of
+  // rounding, i.e. well below 1 m for the Sun and 1 cm for the Moon)
+  return !same || dsun > 1e-3 || dmon > 1e-5;
+}
@@ -0,0 +1,167 @@
+#include "harmonic_coeffs.hpp"
+#include "integrators.hpp"
+#include "orbit_integration.hpp"
+#include <cmath>
+#include <cstdio>
+#include <datetime/dtfund.hpp>
+
+// Compare the state transition matrix computed by dso::VariationalEquations
+// in each of the dso::IntegrationParameters::StmMode modes, over a short
+// (30 min) arc:
+// * StmMode::Full against central finite differences of the (full force
+//   model) state, and
+// * StmMode::Reduced and StmMode::J2 against StmMode::Full.
+// The force model is a degree 4 geopotential plus Sun and Moon (analytic
+// ephemerides); no atmosphere is attached, hence there is no drag and the
+// Reduced and J2 modes coincide. The state itself is integrated with the
+// full force model in all modes, so it should be identical.
+// Returns the number of failed checks.
+
+constexpr const double GM = 3986004.415e8;
+constexpr const double Re = 6378136.3e0;
+// force model parameters (drag coefficient) in dso::VariationalEquations
+constexpr const int Np = 1;
+constexpr const int neqn = 6 + 6 * (6 + Np);
+// length of the arc [sec]
+constexpr const double arc = 1800e0;
+
+using StmMode = dso::IntegrationParameters::StmMode;
+
+// integrate state and STM for the arc; returns the final state and STM
+int propagate(dso::IntegrationParameters &params, StmMode mode,
+              const Eigen::Matrix<double, 6, 1> &y0,
+              Eigen::Matrix<double, 6, 1> &y,
+              Eigen::Matrix<double, 6, 6> &phi) noexcept {
+  params.stm_mode = mode;
+  Eigen::VectorXd yphi = Eigen::VectorXd::Zero(neqn);
+  yphi.head<6>() = y0;
+  for (int i = 0; i < 6; i++)
+    yphi(6 + 7 * i) = 1e0;
+
+  dso::SGOde ode(dso::VariationalEquations, neqn, 1e-13, 1e-13, &params);
+  double t = 0e0;
+  Eigen::VectorXd yout(neqn);
+  if (ode.de(t, arc, yphi, yout) || ode.flag() != 2) {
+    fprintf(stderr, "Integration failed (flag=%d)\n", ode.flag());
+    return 1;
+  }
+  y = yout.head<6>();
+  phi = Eigen::Map<const Eigen::Matrix<double, 6, 6>>(yout.data() + 6);
+  return 0;
+}
+
+// max difference between two STMs, as the (position, velocity) difference
+// at the end of the arc, of initial perturbations of 1 [m] (position) or
+// 1 [mm/sec] (velocity), relative to the mapped perturbation
+void stm_diff(const Eigen::Matrix<double, 6, 6> &a,
+              const Eigen::Matrix<double, 6, 6> &b, double &rel) noexcept {
+  rel = 0e0;
+  for (int j = 0; j < 6; j++) {
+    const double s = (j < 3) ? 1e0 : 1e-3;
+    const double d = ((a.col(j) - b.col(j)) * s).head<3>().norm();
+    const double n = (b.col(j) * s).head<3>().norm();
+    rel = std::max(rel, d / n);
+  }
+}
+
+int main(int argc, char *argv[]) {
+  if (argc != 3) {
+    fprintf(stderr, "Usage: %s [EOP C04 file] [PCK kernel]\n", argv[0]);
+    return 1;
+  }
+
+  // EOP for the arc (plus margin for the interpolation)
+  dso::datetime<dso::nanoseconds> tstart(dso::year(2021), dso::month(12),
+                                         dso::day_of_month(20),
+                                         dso::nanoseconds(0));
+  dso::datetime<dso::nanoseconds> tend(dso::year(2022), dso::month(1),
+                                       dso::day_of_month(10),
+                                       dso::nanoseconds(0));
+  dso::EopLookUpTable eops;
+  if (dso::parse_iers_C04(argv[1], tstart.mjd(), tend.mjd(), eops)) {
+    fprintf(stderr, "Failed parsing IERS/C04 file %s\n", argv[1]);
+    return 1;
+  }
+  eops.regularize();
+
+  // degree 4 geopotential (un-normalized, EGM-like values)
+  constexpr const int degree = 4;
+  dso::HarmonicCoeffs hc(degree, GM, Re);
+  for (int n = 0; n <= degree; n++) {
+    for (int m = 0; m <= n; m++) {
+      hc.C(n, m) = 0e0;
+      if (m)
+        hc.S(n, m) = 0e0;
+    }
+  }
+  hc.normalized() = false;
+  hc.C(0, 0) = 1e0;
+  hc.C(2, 0) = -1.08262668e-3;
+  hc.C(2, 2) = 1.57446e-6;
+  hc.S(2, 2) = -9.03868e-7;
+  hc.C(3, 0) = 2.53266e-6;
+  hc.C(3, 1) = 2.19264e-6;
+  hc.S(3, 1) = 2.68012e-7;
+  hc.C(4, 0) = 1.61962e-6;
+
+  dso::IntegrationParameters params(degree, degree, eops, hc, argv[2]);
+  params.mjd_tai = tstart.as_mjd() + 8e0;
+  params.ephemeris_tier = dso::EphemerisTier::Analytic;
+
+  // initial state; Jason-like orbit, inclination 66 deg
+  const double a = Re + 1336e3;
+  const double v = std::sqrt(GM / a);
+  Eigen::Matrix<double, 6, 1> y0;
+  y0 << a, 0e0, 0e0, 5e0, v * std::cos(1.15e0), v * std::sin(1.15e0);
+
+  int error = 0;
+  Eigen::Matrix<double, 6, 1> yfull, y;
+  Eigen::Matrix<double, 6, 6> phi_full, phi;
+  if (propagate(params, StmMode::Full, y0, yfull, phi_full))
+    return ++error;
+
+  // central finite differences, perturbing the initial state by 10 [m] and
+  // 10 [mm/sec]
+  Eigen::Matrix<double, 6, 6> phi_fd;
+  for (int j = 0; j < 6; j++) {
+    const double d = (j < 3) ? 10e0 : 1e-2;
+    Eigen::Matrix<double, 6, 1> yp, ym;
+    Eigen::Matrix<double, 6, 1> y0p = y0, y0m = y0;
+    y0p(j) += d;
+    y0m(j) -= d;
+    if (propagate(params, StmMode::Full, y0p, yp, phi) ||
+        propagate(params, StmMode::Full, y0m, ym, phi))
+      return ++error;
+    phi_fd.col(j) = (yp - ym) / (2e0 * d);
+  }
+  double rel;
+  stm_diff(phi_full, phi_fd, rel);
+  printf("Full    vs finite differences: max relative difference %.3e\n",
+         rel);
+  if (!(rel < 1e-5)) {
+    fprintf(stderr, "Failed! Full STM does not match finite differences\n");
+    ++error;
+  }
+
+  // reduced-fidelity modes against the full STM; state should be the same
+  for (auto mode : {StmMode::Reduced, StmMode::J2}) {
+    const char *name = (mode == StmMode::Reduced) ? "Reduced" : "J2     ";
+    if (propagate(params, mode, y0, y, phi))
+      return ++error;
+    stm_diff(phi, phi_full, rel);
+    const double dr = (y - yfull).head<3>().norm();
+    printf("%s vs Full: max relative difference %.3e, state difference "
+           "%.3e [m]\n",
+           name, rel, dr);
+    if (!(rel < 1e-3)) {
+      fprintf(stderr, "Failed! %s STM too far off the full one\n", name);
+      ++error;
+    }
+    if (!(dr < 1e-3)) {
+      fprintf(stderr, "Failed! State differs in %s mode\n", name);
+      ++error;
+    }
+  }
+
+  return error;
+}
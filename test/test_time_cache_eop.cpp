@@ -0,0 +1,118 @@
+#include "c2t_table.hpp"
+#include "harmonic_coeffs.hpp"
+#include "orbit_integration.hpp"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <datetime/dtfund.hpp>
+
+// Check that, with a high-rate EOP table (dso::EopHighRateTable) attached to
+// the integration parameters, dso::update_time_cache does not evaluate the
+// sub-daily EOP corrections (zonal tides, ocean tides and libration) per
+// call: the parameters of the fast path are given an empty EOP look-up
+// table, so any call to dso::EopLookUpTable::interpolate (i.e. the only
+// path evaluating the correction series) would fail. Results are compared
+// against the exact path (daily EOP table, corrections at every call), for
+// a day of 30-second epochs. The same is checked for dso::CelTerTable, built
+// off of the high-rate table.
+
+constexpr const double GM = 3986004.415e8;
+constexpr const double Re = 6378136.3e0;
+
+// full celestial-to-terrestrial matrix, off of the cached pieces
+Eigen::Matrix<double, 3, 3> c2t(const dso::ForceModelTimeCache &tc) noexcept {
+  return tc.rpom *
+         (Eigen::AngleAxisd(tc.era, -Eigen::Vector3d::UnitZ()) * tc.rc2i);
+}
+
+int main(int argc, char *argv[]) {
+  if (argc != 3) {
+    fprintf(stderr, "Usage: %s [EOP C04 file] [PCK kernel]\n", argv[0]);
+    return 1;
+  }
+
+  // EOP for the arc (plus margin for the interpolation)
+  dso::datetime<dso::nanoseconds> tstart(dso::year(2021), dso::month(12),
+                                         dso::day_of_month(20),
+                                         dso::nanoseconds(0));
+  dso::datetime<dso::nanoseconds> tend(dso::year(2022), dso::month(1),
+                                       dso::day_of_month(10),
+                                       dso::nanoseconds(0));
+  dso::EopLookUpTable eops;
+  if (dso::parse_iers_C04(argv[1], tstart.mjd(), tend.mjd(), eops)) {
+    fprintf(stderr, "Failed parsing IERS/C04 file %s\n", argv[1]);
+    return 1;
+  }
+  eops.regularize();
+
+  // the arc (TAI), and the high-rate table covering it (TT), with a margin
+  // for the celestial-to-terrestrial table nodes
+  const double mjd_start = tstart.as_mjd() + 8e0;
+  const double mjd_end = mjd_start + 1e0;
+  dso::EopHighRateTable heop;
+  if (heop.build(eops, mjd_start - .5e0, mjd_end + .5e0)) {
+    fprintf(stderr, "Failed building high-rate EOP table\n");
+    return 1;
+  }
+
+  // exact path, and fast path with no daily EOP values at all
+  dso::HarmonicCoeffs hc(2, GM, Re);
+  dso::EopLookUpTable none;
+  dso::IntegrationParameters exact(2, 2, eops, hc, argv[2]);
+  dso::IntegrationParameters fast(2, 2, none, hc, argv[2]);
+  exact.ephemeris_tier = dso::EphemerisTier::Analytic;
+  fast.ephemeris_tier = dso::EphemerisTier::Analytic;
+  fast.eop_high_rate = &heop;
+
+  int error = 0;
+  dso::EopRecord eopr;
+  if (!none.interpolate(mjd_start, eopr)) {
+    fprintf(stderr, "Failed! Interpolation off of an empty table should "
+                    "fail\n");
+    ++error;
+  }
+
+  // every 30 seconds, for the whole day (all cache misses)
+  const int n = 2880;
+  double max_angle = 0e0, max_dlod = 0e0;
+  std::chrono::duration<double, std::micro> t_exact{0}, t_fast{0};
+  for (int i = 0; i < n; i++) {
+    const double mjd = mjd_start + i * 30e0 / 86400e0;
+    auto t0 = std::chrono::steady_clock::now();
+    const dso::ForceModelTimeCache &te = dso::update_time_cache(mjd, exact);
+    auto t1 = std::chrono::steady_clock::now();
+    const dso::ForceModelTimeCache &tf = dso::update_time_cache(mjd, fast);
+    auto t2 = std::chrono::steady_clock::now();
+    t_exact += t1 - t0;
+    t_fast += t2 - t1;
+    const Eigen::AngleAxisd d(
+        Eigen::Matrix<double, 3, 3>(c2t(tf) * c2t(te).transpose()));
+    max_angle = std::max(max_angle, std::abs(d.angle()));
+    max_dlod = std::max(max_dlod, std::abs(tf.xlod - te.xlod));
+  }
+  printf("update_time_cache, high-rate EOP vs exact: max angle %.3e [rad] "
+         "(%.3f [mm] at 6378 km), max LOD diff %.3e [sec/day]; %.3f vs %.3f "
+         "[usec] per call (%ld misses)\n",
+         max_angle, max_angle * 6378e6, max_dlod, t_fast.count() / n,
+         t_exact.count() / n, fast.time_cache.nmisses);
+  // 2 μas, i.e. ~0.06 mm on the Earth's surface
+  error += !(max_angle < 1e-11);
+  error += !(max_dlod < 1e-6);
+  error += (fast.time_cache.nmisses != n);
+
+  // celestial-to-terrestrial table, built off of the high-rate table
+  dso::CelTerTable table;
+  if (table.build(mjd_start, mjd_end, heop)) {
+    fprintf(stderr, "Failed building table off of the high-rate EOP table\n");
+    return ++error;
+  }
+  if (table.verify(eops, max_angle, 2000)) {
+    fprintf(stderr, "Failed verifying table\n");
+    return ++error;
+  }
+  printf("CelTerTable off of high-rate EOP vs exact: max angle %.3e [rad]\n",
+         max_angle);
+  error += !(max_angle < 1e-11);
+
+  return error;
+}
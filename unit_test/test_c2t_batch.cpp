@@ -0,0 +1,143 @@
+#include "c2t_table.hpp"
+#include "orbit_integration.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+// Compare the batch celestial/terrestrial transformations (dso::cel2ter and
+// dso::ter2cel, both the exact and the tabulated variants) against the
+// per-epoch path (dso::gcrs2itrs or dso::CelTerTable::gcrs2itrs, and
+// dso::ycel2ter/dso::yter2cel), on a synthetic set of daily EOP values. Runs
+// with one and with several threads, and with groups of rows sharing an
+// epoch. Also checks that a dso::CelTerTable built with several threads is
+// identical to one built serially.
+
+constexpr const double mjd0 = 59580e0; // TT
+
+// synthetic daily values; annual/Chandler-like polar motion, drifting UT1
+void fill(dso::EopLookUpTable &eops) noexcept {
+  for (int i = 0; i < eops.size(); i++) {
+    const double t = i;
+    *eops.mjd(i) = mjd0 + t;
+    *eops.xp(i) = 0.1e0 + 0.15e0 * std::sin(2e0 * M_PI * t / 433e0) +
+                  0.08e0 * std::cos(2e0 * M_PI * t / 365.25e0);
+    *eops.yp(i) = 0.3e0 + 0.15e0 * std::cos(2e0 * M_PI * t / 433e0) -
+                  0.08e0 * std::sin(2e0 * M_PI * t / 365.25e0);
+    *eops.dut(i) = -0.11e0 - 1e-3 * t + 2e-4 * std::sin(2e0 * M_PI * t / 14e0);
+    *eops.dx(i) = 2e-4 * std::sin(2e0 * M_PI * t / 30e0);
+    *eops.dy(i) = -1e-4 * std::cos(2e0 * M_PI * t / 30e0);
+    *eops.lod(i) = 1e-3 + 2e-4 * std::cos(2e0 * M_PI * t / 14e0);
+    *eops.omega(i) = 0e0;
+  }
+}
+
+// max position and velocity differences between two n x 6 state matrices
+void max_diff(const Eigen::MatrixXd &a, const Eigen::MatrixXd &b, double &dr,
+              double &dv) noexcept {
+  dr = dv = 0e0;
+  for (int i = 0; i < a.rows(); i++) {
+    dr = std::max(dr, (a.block<1, 3>(i, 0) - b.block<1, 3>(i, 0)).norm());
+    dv = std::max(dv, (a.block<1, 3>(i, 3) - b.block<1, 3>(i, 3)).norm());
+  }
+}
+
+int main() {
+  dso::EopLookUpTable eops(20);
+  fill(eops);
+
+  // one day (TAI), three rows (e.g. beacons) per epoch, every 20 seconds
+  const double start = mjd0 + 8e0;
+  constexpr const int rows_per_epoch = 3;
+  constexpr const int n = 3 * 4320;
+  std::vector<double> mjd(n);
+  Eigen::MatrixXd cel(n, 6);
+  for (int i = 0; i < n; i++) {
+    mjd[i] = start + (i / rows_per_epoch) * 20e0 / 86400e0;
+    const double u = 1e-3 * i;
+    cel.row(i) << 7e6 * std::cos(u), 7e6 * std::sin(u), 1e6 * std::sin(3 * u),
+        -7.5e3 * std::sin(u), 7.5e3 * std::cos(u), 3e2 * std::cos(3 * u);
+  }
+
+  // tabulated transformation, built serially and with threads
+  dso::CelTerTable table, table4;
+  if (table.build(start - .5e0, start + 1.5e0, eops) ||
+      table4.build(start - .5e0, start + 1.5e0, eops, 4)) {
+    fprintf(stderr, "Failed building celestial-to-terrestrial table\n");
+    return 1;
+  }
+
+  // per-epoch reference (exact and tabulated)
+  Eigen::MatrixXd ter_exact(n, 6), ter_table(n, 6);
+  Eigen::Matrix<double, 3, 3> rc2i, rpom;
+  double era, xlod;
+  int error = 0;
+  for (int i = 0; i < n; i++) {
+    const Eigen::Matrix<double, 6, 1> y = cel.row(i).transpose();
+    if (dso::gcrs2itrs(mjd[i], eops, rc2i, era, rpom, xlod)) {
+      fprintf(stderr, "Failed computing transformation at MJD=%.6f\n",
+              mjd[i]);
+      return 1;
+    }
+    ter_exact.row(i) = dso::ycel2ter(y, rc2i, era, xlod, rpom).transpose();
+    if (table.gcrs2itrs(mjd[i], rc2i, era, rpom, xlod)) {
+      fprintf(stderr, "Failed interpolating table at MJD=%.6f\n", mjd[i]);
+      return 1;
+    }
+    ter_table.row(i) = dso::ycel2ter(y, rc2i, era, xlod, rpom).transpose();
+
+    // the table built with threads is identical
+    dso::CelTerQuantities q, q4;
+    if (table.interpolate(mjd[i], q) || table4.interpolate(mjd[i], q4) ||
+        q.X != q4.X || q.Y != q4.Y || q.s != q4.s || q.ut1_tai != q4.ut1_tai ||
+        q.xp != q4.xp || q.yp != q4.yp || q.sp != q4.sp || q.lod != q4.lod) {
+      fprintf(stderr, "Failed! Tables differ at MJD=%.6f\n", mjd[i]);
+      ++error;
+      break;
+    }
+  }
+
+  // batch, exact and tabulated, serially and with threads; then back to
+  // celestial (into the same matrix)
+  for (int nthreads : {1, 4}) {
+    for (bool tabulated : {false, true}) {
+      Eigen::MatrixXd ter;
+      const int status =
+          tabulated ? dso::cel2ter(mjd.data(), cel, ter, table, nthreads)
+                    : dso::cel2ter(mjd.data(), cel, ter, eops, nthreads);
+      if (status) {
+        fprintf(stderr, "Failed batch transformation to terrestrial\n");
+        return 1;
+      }
+      double dr, dv;
+      max_diff(ter, tabulated ? ter_table : ter_exact, dr, dv);
+
+      Eigen::MatrixXd y = ter;
+      if (tabulated ? dso::ter2cel(mjd.data(), y, y, table, nthreads)
+                    : dso::ter2cel(mjd.data(), y, y, eops, nthreads)) {
+        fprintf(stderr, "Failed batch transformation to celestial\n");
+        return 1;
+      }
+      double drc, dvc;
+      max_diff(y, cel, drc, dvc);
+
+      printf("%s, %d thread(s): batch vs per-epoch %.3e [m] %.3e [m/sec]; "
+             "round trip %.3e [m] %.3e [m/sec]\n",
+             tabulated ? "table" : "exact", nthreads, dr, dv, drc, dvc);
+      if (!(dr < 1e-6) || !(dv < 1e-9) || !(drc < 1e-6) || !(dvc < 1e-9)) {
+        fprintf(stderr, "Failed! Batch results differ\n");
+        ++error;
+      }
+    }
+  }
+
+  // epochs out of the table range are an error
+  Eigen::MatrixXd ter;
+  std::vector<double> late(n, start + 10e0);
+  if (!dso::cel2ter(late.data(), cel, ter, table, 4)) {
+    fprintf(stderr, "Failed! Out of range epochs should fail\n");
+    ++error;
+  }
+
+  return error;
+}
@@ -0,0 +1,72 @@
+#include "cip_chebyshev.hpp"
+#include "datetime/dtcalendar.hpp"
+#include "iers2010/iau.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+// Compare the Chebyshev fit of the CIP X, Y and the CIO locator s
+// (dso::CipChebyshev) against the full IAU 2006/2000A series
+// (iers2010::sofa::xy06 and iers2010::sofa::s06); the fit error should be
+// below 1 μas.
+
+constexpr const double uas2rad = 1e-6 * M_PI / 180e0 / 3600e0;
+
+int main() {
+  int error = 0;
+  dso::CipChebyshev cip;
+
+  // a few arcs, some decades apart (TT)
+  for (const double start : {51544.3e0, 59580e0, 64000.7e0}) {
+    const double end = start + 3e0;
+    if (cip.build(start, end)) {
+      fprintf(stderr, "Failed building CIP fit\n");
+      return 1;
+    }
+
+    // compare at (off-node) epochs, every 71 seconds
+    double dxy = 0e0, ds = 0e0;
+    for (double t = start; t <= end; t += 71e0 / 86400e0) {
+      const double imjd = std::floor(t);
+      double X, Y, s, Xf, Yf, sf;
+      iers2010::sofa::xy06(dso::mjd0_jd + imjd, t - imjd, X, Y);
+      s = iers2010::sofa::s06(dso::mjd0_jd + imjd, t - imjd, X, Y);
+      if (cip.evaluate(t, Xf, Yf, sf)) {
+        fprintf(stderr, "Failed evaluating CIP fit at MJD=%.6f\n", t);
+        return 1;
+      }
+      dxy = std::max(dxy, std::max(std::abs(X - Xf), std::abs(Y - Yf)));
+      ds = std::max(ds, std::abs(s - sf));
+    }
+    printf("Max residuals (fit - series) for MJD [%.1f, %.1f]: X,Y %.3e "
+           "[μas], s %.3e [μas]\n",
+           start, end, dxy / uas2rad, ds / uas2rad);
+    if (dxy > uas2rad || ds > uas2rad) {
+      fprintf(stderr, "Failed! CIP fit residuals too large\n");
+      ++error;
+    }
+  }
+
+  // the built-in check should agree
+  double max_xy, max_s;
+  cip.verify(max_xy, max_s);
+  if (max_xy > uas2rad || max_s > uas2rad) {
+    fprintf(stderr, "Failed! CIP fit verification residuals too large\n");
+    ++error;
+  }
+
+  // epochs off the fitted segments are an error, unless fitted on first use
+  double X, Y, s;
+  if (!cip.evaluate(60000.5e0, X, Y, s)) {
+    fprintf(stderr, "Failed! Evaluation off the fit should fail\n");
+    ++error;
+  }
+  const int nseg = cip.num_segments();
+  if (cip.evaluate_or_fit(60000.5e0, X, Y, s) ||
+      cip.num_segments() != nseg + 1 || !cip.contains(60000.9e0)) {
+    fprintf(stderr, "Failed! Fitting on first use failed\n");
+    ++error;
+  }
+
+  return error;
+}
@@ -0,0 +1,102 @@
+#include "eigen3/Eigen/Eigen"
+#include "integrators.hpp"
+#include <cmath>
+#include <cstdio>
+
+// Integrate a circular (two-body) orbit for a day with dso::DormandPrince853
+// (and dso::SGOde, for reference) and check the position error against the
+// analytic solution. Output is requested every 10 seconds, and the arc is
+// integrated:
+// (a) in one go,
+// (b) restarting every 10 minutes (as e.g. after filter resets) off of the
+//     output state, the output point being reached with a negative flag
+//     (i.e. not stepping past it), and
+// (c) as (b), but with the output at the restart points interpolated (the
+//     integrator steps past them); the restarts then accumulate the error
+//     of the continuous extension, hence this is only checked loosely.
+
+constexpr const double GM = 3.986004415e14;
+constexpr const double R = 7000e3;
+
+long calls = 0;
+
+void twobody([[maybe_unused]] double t, const Eigen::VectorXd &y,
+             Eigen::Ref<Eigen::VectorXd> yp,
+             [[maybe_unused]] dso::IntegrationParameters &params) noexcept {
+  const double r = y.head<3>().norm();
+  yp.head<3>() = y.segment<3>(3);
+  yp.segment<3>(3) = -GM / (r * r * r) * y.head<3>();
+  ++calls;
+}
+
+Eigen::VectorXd circular(double t) noexcept {
+  const double n = std::sqrt(GM / (R * R * R));
+  Eigen::VectorXd y(6);
+  y << R * std::cos(n * t), R * std::sin(n * t), 0e0,
+      -R * n * std::sin(n * t), R * n * std::cos(n * t), 0e0;
+  return y;
+}
+
+// integrate for a day, with output every 10 seconds, restarting every
+// restart outputs (if not 0); returns the max position error (or a negative
+// number on failure) and the number of evaluations
+template <typename Integrator>
+double run(Integrator &ode, int restart, bool exact, long &fevals) noexcept {
+  double t = 0e0;
+  Eigen::VectorXd y = circular(0e0), yout(6);
+  double max_error = 0e0;
+  calls = 0;
+  for (int i = 1; i <= 8640; i++) {
+    const double tout = 10e0 * i;
+    if (restart && !(i % restart))
+      ode.flag() = 1;
+    // next output is a restart point
+    if (restart && exact && !((i + 1) % restart))
+      ode.flag() = -std::abs(ode.flag());
+    if (ode.de(t, tout, y, yout) || std::abs(ode.flag()) != 2)
+      return -1e0;
+    y = yout;
+    max_error =
+        std::max(max_error, (y.head<3>() - circular(tout).head<3>()).norm());
+  }
+  fevals = calls;
+  return max_error;
+}
+
+int main() {
+  struct {
+    const char *name;
+    int restart;
+    bool exact;
+    double max_error;
+  } cases[] = {{"no restarts", 0, false, 1e-3},
+               {"restart at step ends", 60, true, 1e-3},
+               {"restart at interpolated points", 60, false, 5e-2}};
+
+  int error = 0;
+  for (const auto &c : cases) {
+    long rk_fevals, sg_fevals;
+    dso::DormandPrince853 rk(twobody, 6, 1e-12, 1e-12);
+    dso::SGOde sg(twobody, 6, 1e-12, 1e-12);
+    const double rmax = run(rk, c.restart, c.exact, rk_fevals);
+    const double smax = run(sg, c.restart, c.exact, sg_fevals);
+    if (rmax < 0e0 || smax < 0e0) {
+      fprintf(stderr, "Failed! Integration failed (%s)\n", c.name);
+      ++error;
+      continue;
+    }
+    printf("%s:\n", c.name);
+    printf("  DOP853: max position error %.3e [m], %ld evaluations (%ld/%ld "
+           "accepted/rejected steps)\n",
+           rmax, rk_fevals, rk.num_accepted(), rk.num_rejected());
+    printf("  SGOde : max position error %.3e [m], %ld evaluations\n", smax,
+           sg_fevals);
+    if (!(rmax < c.max_error)) {
+      fprintf(stderr, "Failed! DOP853 position error above %.1e [m] (%s)\n",
+              c.max_error, c.name);
+      ++error;
+    }
+  }
+
+  return error;
+}
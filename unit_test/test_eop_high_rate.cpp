@@ -0,0 +1,82 @@
+#include "eop.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+// Compare the high-rate EOP table (dso::EopHighRateTable) against the exact
+// path (dso::EopLookUpTable::interpolate, including the sub-daily
+// corrections), on a synthetic set of daily EOP values.
+
+constexpr const double mjd0 = 59580e0; // TT
+
+// synthetic daily values; annual/Chandler-like polar motion, drifting UT1
+void fill(dso::EopLookUpTable &eops) noexcept {
+  for (int i = 0; i < eops.size(); i++) {
+    const double t = i;
+    *eops.mjd(i) = mjd0 + t;
+    *eops.xp(i) = 0.1e0 + 0.15e0 * std::sin(2e0 * M_PI * t / 433e0) +
+                  0.08e0 * std::cos(2e0 * M_PI * t / 365.25e0);
+    *eops.yp(i) = 0.3e0 + 0.15e0 * std::cos(2e0 * M_PI * t / 433e0) -
+                  0.08e0 * std::sin(2e0 * M_PI * t / 365.25e0);
+    *eops.dut(i) = -0.11e0 - 1e-3 * t + 2e-4 * std::sin(2e0 * M_PI * t / 14e0);
+    *eops.dx(i) = 2e-4 * std::sin(2e0 * M_PI * t / 30e0);
+    *eops.dy(i) = -1e-4 * std::cos(2e0 * M_PI * t / 30e0);
+    *eops.lod(i) = 1e-3 + 2e-4 * std::cos(2e0 * M_PI * t / 14e0);
+    *eops.omega(i) = 0e0;
+  }
+}
+
+int main() {
+  dso::EopLookUpTable eops(20);
+  fill(eops);
+
+  // three days arc
+  const double start = mjd0 + 8e0, end = mjd0 + 11e0;
+  dso::EopHighRateTable heop;
+  if (heop.build(eops, start, end)) {
+    fprintf(stderr, "Failed building high-rate EOP table\n");
+    return 1;
+  }
+
+  // compare at (off-node) epochs, every 37 seconds
+  double dxp = 0e0, dyp = 0e0, ddut = 0e0, dlod = 0e0, ddx = 0e0;
+  dso::EopRecord exact, fast;
+  for (double t = start; t <= end; t += 37e0 / 86400e0) {
+    if (eops.interpolate(t, exact) || heop.interpolate(t, fast)) {
+      fprintf(stderr, "Failed interpolating EOP at MJD=%.6f\n", t);
+      return 1;
+    }
+    dxp = std::max(dxp, std::abs(exact.xp - fast.xp));
+    dyp = std::max(dyp, std::abs(exact.yp - fast.yp));
+    ddut = std::max(ddut, std::abs(exact.dut - fast.dut));
+    dlod = std::max(dlod, std::abs(exact.lod - fast.lod));
+    ddx = std::max(ddx, std::abs(exact.dx - fast.dx));
+  }
+
+  printf("Max residuals (high-rate - exact): xp %.3e [\"], yp %.3e [\"], "
+         "UT1-UTC %.3e [sec], LOD %.3e [sec/day], dX %.3e [\"]\n",
+         dxp, dyp, ddut, dlod, ddx);
+
+  int error = 0;
+  // 1 μas for polar motion (and CIP offsets), 0.1 μs for UT1
+  if (dxp > 1e-6 || dyp > 1e-6 || ddx > 1e-6) {
+    fprintf(stderr, "Failed! polar motion residuals too large\n");
+    ++error;
+  }
+  if (ddut > 1e-7) {
+    fprintf(stderr, "Failed! UT1-UTC residuals too large\n");
+    ++error;
+  }
+  if (dlod > 1e-6) {
+    fprintf(stderr, "Failed! LOD residuals too large\n");
+    ++error;
+  }
+
+  // out of range epochs are an error
+  if (!heop.interpolate(end + 1e0, fast)) {
+    fprintf(stderr, "Failed! Interpolation out of range should fail\n");
+    ++error;
+  }
+
+  return error;
+}
@@ -0,0 +1,233 @@
+#include "eop.hpp"
+#include "lagrange.hpp"
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+// Check the Lagrange interpolation of dso::EopLookUpTable (and the
+// dso::lagrange_weights it is built on):
+// * polynomials of degree up to the interpolation order are reproduced
+//   (to rounding error), for both the arbitrary and the uniform nodes
+//   variants of dso::lagrange_weights, and for all EOP series,
+//   anywhere in the table (i.e. also close to its ends),
+// * batch interpolation gives the same results as interpolation at single
+//   epochs, for both chronological and unordered epochs, and
+// * epochs out of the table (and invalid orders) are rejected.
+// Returns the number of failed checks.
+
+constexpr const double mjd0 = 59580e0;
+constexpr const int table_size = 20;
+// max number of interpolation points used here (aka order+1)
+constexpr const int max_points = 8;
+
+// a polynomial of degree deg, at x
+double poly(const double *c, int deg, double x) noexcept {
+  double p = c[deg];
+  for (int i = deg - 1; i >= 0; i--)
+    p = p * x + c[i];
+  return p;
+}
+
+// coefficients of the (degree order) polynomial of series k
+double coef(int k, int i) noexcept {
+  return (1e0 + 0.1e0 * k) * ((i % 2) ? -1e0 : 1e0) / (1e0 + i);
+}
+
+// every series holds a polynomial of degree order, in the (scaled) time
+// since the middle of the table
+void fill(dso::EopLookUpTable &eops, int order) noexcept {
+  double c[7][max_points];
+  for (int k = 0; k < 7; k++)
+    for (int i = 0; i <= order; i++)
+      c[k][i] = coef(k, i);
+  for (int i = 0; i < eops.size(); i++) {
+    const double x = (i - table_size / 2) / 10e0;
+    *eops.mjd(i) = mjd0 + i;
+    *eops.xp(i) = poly(c[0], order, x);
+    *eops.yp(i) = poly(c[1], order, x);
+    *eops.dut(i) = poly(c[2], order, x);
+    *eops.dx(i) = poly(c[3], order, x);
+    *eops.dy(i) = poly(c[4], order, x);
+    *eops.lod(i) = poly(c[5], order, x);
+    *eops.omega(i) = poly(c[6], order, x);
+  }
+}
+
+// max difference between interpolated and exact (polynomial) values
+double poly_error(const dso::EopRecord &r, int order) noexcept {
+  double c[max_points];
+  const double x = (r.mjd - mjd0 - table_size / 2) / 10e0;
+  const double v[] = {r.xp, r.yp, r.dut, r.dx, r.dy, r.lod, r.omega};
+  double e = 0e0;
+  for (int k = 0; k < 7; k++) {
+    for (int i = 0; i <= order; i++)
+      c[i] = coef(k, i);
+    e = std::max(e, std::abs(v[k] - poly(c, order, x)));
+  }
+  return e;
+}
+
+// bitwise equal records
+bool same(const dso::EopRecord &a, const dso::EopRecord &b) noexcept {
+  return a.mjd == b.mjd && a.xp == b.xp && a.yp == b.yp && a.dut == b.dut &&
+         a.dx == b.dx && a.dy == b.dy && a.lod == b.lod &&
+         a.omega == b.omega;
+}
+
+int main() {
+  int error = 0;
+
+  // dso::lagrange_weights, on uneven nodes and on uniform ones
+  for (int np = 2; np <= max_points; np++) {
+    double xk[max_points], fk[max_points], w[max_points], wu[max_points],
+        c[max_points];
+    for (int j = 0; j < np; j++) {
+      xk[j] = j + 0.3e0 * std::sin(1e0 + j);
+      c[j] = coef(0, j);
+    }
+    for (int j = 0; j < np; j++)
+      fk[j] = poly(c, np - 1, xk[j]);
+    // errors relative to the magnitude of the (weighted) terms of the sum
+    double max_arb = 0e0, max_uni = 0e0;
+    for (double x : {-0.5e0, 0.1e0, 1.7e0, np - 1.2e0, np - 0.5e0}) {
+      const double p = poly(c, np - 1, x);
+      dso::lagrange_weights(x, xk, np, w);
+      double f = 0e0, scale = 0e0;
+      for (int j = 0; j < np; j++) {
+        f += w[j] * fk[j];
+        scale += std::abs(w[j] * fk[j]);
+      }
+      max_arb = std::max(max_arb, std::abs(f - p) / scale);
+      // uniform nodes 0, 1, ..., np-1
+      dso::lagrange_weights(x, np, wu);
+      f = scale = 0e0;
+      for (int j = 0; j < np; j++) {
+        const double fj = poly(c, np - 1, (double)j);
+        f += wu[j] * fj;
+        scale += std::abs(wu[j] * fj);
+      }
+      max_uni = std::max(max_uni, std::abs(f - p) / scale);
+    }
+    if (!(max_arb < 1e-12) || !(max_uni < 1e-12)) {
+      fprintf(stderr, "Failed! Lagrange weights, %d points: error %.3e "
+                      "(arbitrary nodes) and %.3e (uniform nodes)\n",
+              np, max_arb, max_uni);
+      ++error;
+    }
+  }
+
+  // a table with capacity > size, so that array strides differ from size
+  dso::EopLookUpTable eops(2 * table_size);
+  eops.resize(table_size);
+
+  // off-node epochs, all over the table (including its ends)
+  std::vector<double> t;
+  for (int i = 0; i <= 100 * (table_size - 1); i++)
+    t.push_back(mjd0 + i / 100e0 + ((i % 100) ? 1e-3 * std::sin(i) : 0e0));
+  t.front() = mjd0;
+  t.back() = mjd0 + table_size - 1;
+  const int n = t.size();
+  std::vector<dso::EopRecord> single(n), batch(n);
+
+  for (int order : {1, 3, 5, 7}) {
+    fill(eops, order);
+
+    // exact for polynomials of degree order
+    double max_error = 0e0;
+    for (int i = 0; i < n; i++) {
+      if (eops.interpolate_lagrange(t[i], single[i], order)) {
+        fprintf(stderr, "Failed! Epoch MJD %.6f within table rejected\n",
+                t[i]);
+        ++error;
+        break;
+      }
+      max_error = std::max(max_error, poly_error(single[i], order));
+    }
+    printf("Order %d: max interpolation error %.3e\n", order, max_error);
+    if (!(max_error < 1e-12)) {
+      fprintf(stderr, "Failed! Polynomial of degree %d not reproduced\n",
+              order);
+      ++error;
+    }
+
+    // batch, chronological epochs
+    if (eops.interpolate_lagrange(t.data(), n, batch.data(), order)) {
+      fprintf(stderr, "Failed! Batch interpolation (order %d)\n", order);
+      ++error;
+    }
+    for (int i = 0; i < n; i++) {
+      if (!same(single[i], batch[i])) {
+        fprintf(stderr, "Failed! Batch differs from single epoch, MJD "
+                        "%.6f (order %d)\n",
+                t[i], order);
+        ++error;
+        break;
+      }
+    }
+  }
+
+  // batch, unordered epochs (the search hint is mostly of no use)
+  std::vector<double> tu(n);
+  for (int i = 0; i < n; i++)
+    tu[i] = t[(i * 7919) % n];
+  std::vector<dso::EopRecord> unordered(n);
+  if (eops.interpolate_lagrange(tu.data(), n, unordered.data())) {
+    fprintf(stderr, "Failed! Batch interpolation (unordered epochs)\n");
+    ++error;
+  }
+  for (int i = 0; i < n; i++) {
+    dso::EopRecord r;
+    eops.interpolate_lagrange(tu[i], r);
+    if (!same(r, unordered[i])) {
+      fprintf(stderr, "Failed! Batch differs from single epoch, MJD %.6f "
+                      "(unordered epochs)\n",
+              tu[i]);
+      ++error;
+      break;
+    }
+  }
+
+  // same for the fully corrected values
+  if (eops.interpolate(t.data(), n, batch.data())) {
+    fprintf(stderr, "Failed! Batch interpolation (corrected)\n");
+    ++error;
+  }
+  for (int i = 0; i < n; i++) {
+    eops.interpolate(t[i], single[i]);
+    if (!same(single[i], batch[i])) {
+      fprintf(stderr, "Failed! Batch differs from single epoch, MJD %.6f "
+                      "(corrected)\n",
+              t[i]);
+      ++error;
+      break;
+    }
+  }
+
+  // out of the table, or invalid orders
+  dso::EopRecord r;
+  for (double tx : {mjd0 - 1e-6, mjd0 + table_size - 1 + 1e-6, mjd0 - 10e0,
+                    mjd0 + table_size + 10e0}) {
+    if (!eops.interpolate_lagrange(tx, r) || !eops.interpolate(tx, r)) {
+      fprintf(stderr, "Failed! Epoch MJD %.6f out of table accepted\n", tx);
+      ++error;
+    }
+    // anywhere in a batch
+    std::vector<double> tb(t.begin(), t.begin() + 10);
+    tb[5] = tx;
+    if (!eops.interpolate_lagrange(tb.data(), 10, batch.data()) ||
+        !eops.interpolate(tb.data(), 10, batch.data())) {
+      fprintf(stderr, "Failed! Batch with epoch MJD %.6f out of table "
+                      "accepted\n",
+              tx);
+      ++error;
+    }
+  }
+  for (int order : {0, 16, table_size}) {
+    if (!eops.interpolate_lagrange(mjd0 + 5.5e0, r, order)) {
+      fprintf(stderr, "Failed! Invalid order %d accepted\n", order);
+      ++error;
+    }
+  }
+
+  return error;
+}
@@ -0,0 +1,133 @@
+#include "eop.hpp"
+#include <cmath>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+// Copy/move semantics of dso::EopLookUpTable: copies share the memmory pool
+// (copy-on-write), deep copies and modified copies are independent, all
+// arrays are copied in full and shared tables can be used concurrently.
+
+void fill(dso::EopLookUpTable &eops, double offset) noexcept {
+  for (int i = 0; i < eops.size(); i++) {
+    *eops.mjd(i) = 59580e0 + i;
+    *eops.xp(i) = offset + 0.1e0 * i;
+    *eops.yp(i) = offset + 0.2e0 * i;
+    *eops.dut(i) = offset - 0.01e0 * i;
+    *eops.dx(i) = offset + 1e-4 * i;
+    *eops.dy(i) = offset - 1e-4 * i;
+    *eops.lod(i) = offset + 1e-3 * i;
+    *eops.omega(i) = offset;
+  }
+}
+
+// compare all arrays, element by element
+bool same(const dso::EopLookUpTable &a, const dso::EopLookUpTable &b) noexcept {
+  if (a.size() != b.size())
+    return false;
+  for (int i = 0; i < a.size(); i++) {
+    if (*a.mjd(i) != *b.mjd(i) || *a.xp(i) != *b.xp(i) ||
+        *a.yp(i) != *b.yp(i) || *a.dut(i) != *b.dut(i) ||
+        *a.dx(i) != *b.dx(i) || *a.dy(i) != *b.dy(i) ||
+        *a.lod(i) != *b.lod(i) || *a.omega(i) != *b.omega(i))
+      return false;
+  }
+  return true;
+}
+
+int main() {
+  int error = 0;
+
+  // a table with capacity > size, so that array strides differ from size
+  dso::EopLookUpTable eops(40);
+  eops.resize(20);
+  fill(eops, 1e0);
+
+  // copy shares storage, holds the same values
+  dso::EopLookUpTable copy(eops);
+  const dso::EopLookUpTable &ccopy = copy;
+  if (!ccopy.shares_storage(eops) || !same(ccopy, eops)) {
+    fprintf(stderr, "Failed! copy constructor\n");
+    ++error;
+  }
+
+  // modifying the copy detaches it; the original is untouched
+  *copy.xp(3) = -1e0;
+  if (copy.shares_storage(eops) || *eops.xp(3) != 1e0 + 0.3e0 ||
+      *copy.xp(3) != -1e0 || *copy.lod(19) != *eops.lod(19)) {
+    fprintf(stderr, "Failed! copy-on-write\n");
+    ++error;
+  }
+
+  // assignment (to a table of different size/capacity)
+  dso::EopLookUpTable assigned(5);
+  fill(assigned, 2e0);
+  assigned = eops;
+  if (!same(assigned, eops)) {
+    fprintf(stderr, "Failed! assignment operator\n");
+    ++error;
+  }
+
+  // deep copy is independent
+  const dso::EopLookUpTable deep = eops.deep_copy();
+  if (deep.shares_storage(eops) || !same(deep, eops)) {
+    fprintf(stderr, "Failed! deep copy\n");
+    ++error;
+  }
+
+  // resizing a shared table keeps the values (of the remaining epochs) and
+  // leaves the other owner untouched
+  dso::EopLookUpTable grown(eops);
+  grown.resize(60);
+  if (grown.shares_storage(eops) || grown.size() != 60 ||
+      *grown.dy(19) != *eops.dy(19) || eops.size() != 20) {
+    fprintf(stderr, "Failed! resize of shared table\n");
+    ++error;
+  }
+
+  // move leaves the source empty
+  dso::EopLookUpTable moved(std::move(grown));
+  if (moved.size() != 60 || grown.size() != 0 ||
+      *moved.omega(19) != *eops.omega(19)) {
+    fprintf(stderr, "Failed! move constructor\n");
+    ++error;
+  }
+  dso::EopLookUpTable move_assigned;
+  move_assigned = std::move(moved);
+  if (move_assigned.size() != 60 || moved.size() != 0) {
+    fprintf(stderr, "Failed! move assignment\n");
+    ++error;
+  }
+
+  // shared (const) tables used concurrently; each thread has its own copy
+  // (same pool) and interpolates on it
+  dso::EopRecord ref;
+  if (eops.interpolate_lagrange(59590.3e0, ref)) {
+    fprintf(stderr, "Failed! interpolation\n");
+    return 1;
+  }
+  std::vector<int> ok(8, 0);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 8; t++) {
+    threads.emplace_back([&eops, &ref, &ok, t]() {
+      const dso::EopLookUpTable mine(eops);
+      dso::EopRecord rec;
+      int good = 1;
+      for (int k = 0; k < 1000; k++)
+        good &= (!mine.interpolate_lagrange(59590.3e0, rec) &&
+                 rec.xp == ref.xp && rec.dut == ref.dut);
+      ok[t] = good && mine.shares_storage(eops);
+    });
+  }
+  for (auto &t : threads)
+    t.join();
+  for (int t = 0; t < 8; t++) {
+    if (!ok[t]) {
+      fprintf(stderr, "Failed! concurrent use, thread %d\n", t);
+      ++error;
+    }
+  }
+
+  printf("%s\n", error ? "Some tests failed!" : "All tests passed");
+  return error;
+}
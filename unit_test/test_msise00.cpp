@@ -2,6 +2,9 @@
 #include <cassert>
 #include <cmath>
 #include <cstdio>
+#include <cstring>
+#include <thread>
+#include <vector>
 
 // FORTRAN results in cm^3 and gr/cm^3
 const dso::nrlmsise00::OutParams fortran[17] = {
@@ -86,8 +89,9 @@ int main() {
   input[8].params_.f107 = 180e0;
   input[9].params_.ap = 40e0;
 
-  dso::Nrlmsise00 Msise;
+  const dso::Nrlmsise00 Msise;
   int mass = 48;
+  int errors = 0;
 
   for (int i = 0; i < 17; i++) {
     input[i].params_.set_switches_on();
@@ -104,7 +108,8 @@ int main() {
 
     // check density results
     for (int k = 0; k < 9; k++) {
-      if (std::abs(out[i].d[k] - ref->d[k]) > DPRECISION[k]) {
+      if (!(std::abs(out[i].d[k] - ref->d[k]) <= DPRECISION[k])) {
+        ++errors;
         fprintf(stderr,
                 "ERROR. Results differ! test-case %d / density index %d / "
                 "difference %.15e\n",
@@ -118,7 +123,8 @@ int main() {
 
     // check temperature results
     for (int k = 0; k < 2; k++) {
-      if (std::abs(out[i].t[k] - ref->t[k]) > TPRECISION) {
+      if (!(std::abs(out[i].t[k] - ref->t[k]) <= TPRECISION)) {
+        ++errors;
         fprintf(stderr,
                 "ERROR. Results differ! test-case %d / temperature index %d / "
                 "difference %.15e\n",
@@ -128,5 +134,28 @@ int main() {
     }
   }
 
-  return 0;
+  // the model holds no state: evaluating the same cases concurrently (one
+  // instance, shared by all threads) in reverse order, should give identical
+  // results
+  const int nthreads = 4;
+  dso::nrlmsise00::OutParams pout[17];
+  std::vector<std::thread> threads;
+  for (int t = 0; t < nthreads; t++) {
+    threads.emplace_back([&, t]() {
+      for (int i = 16 - t; i >= 0; i -= nthreads)
+        Msise.gtd7(&input[i].params_, &pout[i], mass);
+    });
+  }
+  for (auto &thread : threads)
+    thread.join();
+  for (int i = 0; i < 17; i++) {
+    if (std::memcmp(pout[i].d, out[i].d, sizeof(double) * 9) ||
+        std::memcmp(pout[i].t, out[i].t, sizeof(double) * 2)) {
+      ++errors;
+      fprintf(stderr,
+              "ERROR. Concurrent evaluation differs! test-case %d\n", i);
+    }
+  }
+
+  return errors;
 }
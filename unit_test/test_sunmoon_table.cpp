@@ -0,0 +1,111 @@
+#include "orbit_integration.hpp"
+#include "sunmoon_table.hpp"
+#include <cmath>
+#include <cstdio>
+
+// Check dso::SunMoonTable, tabulating the analytic series (so that no
+// kernels are needed):
+// * the table against direct evaluation, at epochs off of the fit nodes,
+// * dso::SunMoonTable::contains and positions at (and just past) the ends
+//   of the arc, and rejection of epochs out of the arc, and
+// * that failures of the source of positions are propagated by build.
+// Returns the number of failed checks.
+
+int analytic(double mjd_tai, Eigen::Matrix<double, 3, 1> &sun_pos,
+             Eigen::Matrix<double, 3, 1> &mon_pos) noexcept {
+  dso::sun_moon_positions_analytic(mjd_tai, sun_pos, mon_pos);
+  return 0;
+}
+
+int main() {
+  // ~10 days arc (TAI)
+  const double mjd_start = 59580.3e0;
+  const double mjd_end = 59590.7e0;
+  constexpr const double tolerance = 1e-1;
+
+  int error = 0;
+  dso::SunMoonTable table(tolerance);
+  if (table.build(mjd_start, mjd_end, analytic)) {
+    fprintf(stderr, "Failed building Sun/Moon table\n");
+    return 1;
+  }
+  printf("Segments: %.3f (Sun) and %.3f (Moon) [days]; fit error %.3e and "
+         "%.3e [m]\n",
+         table.sun_segment_length(), table.moon_segment_length(),
+         table.sun_error(), table.moon_error());
+  error += !(table.sun_error() <= tolerance);
+  error += !(table.moon_error() <= tolerance);
+
+  // off-node epochs (an irrational fraction of the arc apart); the fit error
+  // is only checked midway between the nodes while building, hence allow
+  // some margin
+  Eigen::Matrix<double, 3, 1> s, m, s0, m0;
+  double max_sun = 0e0, max_mon = 0e0;
+  const int n = 5000;
+  for (int i = 0; i < n; i++) {
+    const double t =
+        mjd_start + std::fmod(i * M_SQRT2, n) / n * (mjd_end - mjd_start);
+    if (table.positions(t, s, m)) {
+      fprintf(stderr, "Failed! Epoch MJD %.6f within arc rejected\n", t);
+      ++error;
+      break;
+    }
+    analytic(t, s0, m0);
+    max_sun = std::max(max_sun, (s - s0).norm());
+    max_mon = std::max(max_mon, (m - m0).norm());
+  }
+  printf("Table vs direct evaluation: max error %.3e (Sun) and %.3e (Moon) "
+         "[m]\n",
+         max_sun, max_mon);
+  if (!(max_sun < 2e0 * tolerance) || !(max_mon < 2e0 * tolerance)) {
+    fprintf(stderr, "Failed! Table too far off the direct evaluation\n");
+    ++error;
+  }
+
+  // ends of the arc are covered
+  for (double t : {mjd_start, mjd_end}) {
+    if (!table.contains(t) || table.positions(t, s, m)) {
+      fprintf(stderr, "Failed! Arc end MJD %.6f not covered\n", t);
+      ++error;
+      continue;
+    }
+    analytic(t, s0, m0);
+    if (!((s - s0).norm() < 2e0 * tolerance) ||
+        !((m - m0).norm() < 2e0 * tolerance)) {
+      fprintf(stderr, "Failed! Table off at arc end MJD %.6f\n", t);
+      ++error;
+    }
+  }
+
+  // epochs out of the arc are rejected
+  for (double t : {mjd_start - 1e-6, mjd_end + 1e-6, mjd_start - 10e0,
+                   mjd_end + 10e0}) {
+    if (table.contains(t) || !table.positions(t, s, m)) {
+      fprintf(stderr, "Failed! Epoch MJD %.6f out of arc accepted\n", t);
+      ++error;
+    }
+  }
+
+  // failures of the source are propagated, and leave the table empty
+  dso::SunMoonTable broken(tolerance);
+  if (!broken.build(mjd_start, mjd_end,
+                    [](double t, Eigen::Matrix<double, 3, 1> &sp,
+                       Eigen::Matrix<double, 3, 1> &mp) {
+                      return (t > 59585e0) ? 1 : analytic(t, sp, mp);
+                    })) {
+    fprintf(stderr, "Failed! Failure of the source not propagated\n");
+    ++error;
+  }
+  if (broken.contains(mjd_start)) {
+    fprintf(stderr, "Failed! Table not empty after failed build\n");
+    ++error;
+  }
+
+  // invalid arc
+  if (!broken.build(mjd_end, mjd_start, analytic)) {
+    fprintf(stderr, "Failed! Invalid arc accepted\n");
+    ++error;
+  }
+
+  return error;
+}
@@ -0,0 +1,167 @@
+#include "harmonic_coeffs.hpp"
+#include "orbit_integration.hpp"
+#include <cmath>
+#include <cstdio>
+#include <datetime/dtfund.hpp>
+
+// Check the caching of the time-only force model quantities
+// (dso::update_time_cache), on a set of synthetic daily EOP values:
+// * repeated epochs are served from the cache (nhits/nmisses), and so are
+//   nearby epochs, within window seconds of the cached one,
+// * leaving the window recomputes the quantities, at the new epoch,
+// * cached values equal freshly computed ones (exact-time hits), or are
+//   close to them (within the window; the ERA is extrapolated), and
+// * the UTC date/time of the atmospheric model input, around a UTC day
+//   boundary.
+// Usage: [PCK kernel] [CelesTrak Space-Weather CSV, e.g. SW-test-data.csv]
+// Returns the number of failed checks.
+
+constexpr const double GM = 3986004.415e8;
+constexpr const double Re = 6378136.3e0;
+// 2022-07-25 (TAI), doy 206; TAI-UTC is 37 [sec]
+constexpr const double mjd0 = 59785e0;
+
+// synthetic daily values; annual/Chandler-like polar motion, drifting UT1
+void fill(dso::EopLookUpTable &eops) noexcept {
+  for (int i = 0; i < eops.size(); i++) {
+    const double t = i;
+    *eops.mjd(i) = mjd0 - 10e0 + t;
+    *eops.xp(i) = 0.1e0 + 0.15e0 * std::sin(2e0 * M_PI * t / 433e0);
+    *eops.yp(i) = 0.3e0 + 0.15e0 * std::cos(2e0 * M_PI * t / 433e0);
+    *eops.dut(i) = -0.11e0 - 1e-3 * t;
+    *eops.dx(i) = 2e-4 * std::sin(2e0 * M_PI * t / 30e0);
+    *eops.dy(i) = -1e-4 * std::cos(2e0 * M_PI * t / 30e0);
+    *eops.lod(i) = 1e-3;
+    *eops.omega(i) = 0e0;
+  }
+}
+
+// bitwise equal time-only quantities
+bool same(const dso::ForceModelTimeCache &a,
+          const dso::ForceModelTimeCache &b) noexcept {
+  return a.rc2i == b.rc2i && a.rpom == b.rpom && a.era == b.era &&
+         a.xlod == b.xlod && a.rsun == b.rsun && a.rmon == b.rmon;
+}
+
+int main(int argc, char *argv[]) {
+  if (argc != 3) {
+    fprintf(stderr, "Usage: %s [PCK kernel] [Space-Weather CSV file]\n",
+            argv[0]);
+    return 1;
+  }
+
+  dso::EopLookUpTable eops(20);
+  fill(eops);
+  dso::HarmonicCoeffs hc(2, GM, Re);
+  dso::IntegrationParameters params(2, 2, eops, hc, argv[1]);
+  params.ephemeris_tier = dso::EphemerisTier::Analytic;
+  // reference, never served from the cache
+  dso::IntegrationParameters fresh(2, 2, eops, hc, argv[1]);
+  fresh.ephemeris_tier = dso::EphemerisTier::Analytic;
+
+  int error = 0;
+  const double t0 = mjd0 + .3e0;
+  constexpr const double s = 1e0 / dso::sec_per_day;
+
+  // exact-time hits only (window = 0)
+  dso::ForceModelTimeCache &tc = params.time_cache;
+  dso::update_time_cache(t0, params);
+  dso::update_time_cache(t0, params);
+  dso::update_time_cache(t0, params);
+  if (tc.nmisses != 1 || tc.nhits != 2) {
+    fprintf(stderr, "Failed! Repeated epoch: %ld hits, %ld misses\n",
+            tc.nhits, tc.nmisses);
+    ++error;
+  }
+  if (!same(tc, dso::update_time_cache(t0, fresh))) {
+    fprintf(stderr, "Failed! Cached values differ from fresh ones\n");
+    ++error;
+  }
+  dso::update_time_cache(t0 + 1e-3 * s, params);
+  if (tc.nmisses != 2 || tc.mjd_tai != t0 + 1e-3 * s) {
+    fprintf(stderr, "Failed! Nearby epoch served from the cache (window "
+                    "is zero)\n");
+    ++error;
+  }
+
+  // nearby epochs (window = 60 sec), on both sides of the cached one
+  tc.window = 60e0;
+  tc.clear();
+  tc.nhits = tc.nmisses = 0;
+  dso::update_time_cache(t0, params);
+  double max_era = 0e0, max_rc2i = 0e0;
+  for (double dt : {10e0, -30e0, 59.5e0, -59.5e0}) {
+    const double t = t0 + dt * s;
+    const dso::ForceModelTimeCache &c = dso::update_time_cache(t, params);
+    const dso::ForceModelTimeCache &f = dso::update_time_cache(t, fresh);
+    max_era = std::max(max_era, std::abs(c.era_at(t) - f.era));
+    max_rc2i = std::max(max_rc2i, (c.rc2i - f.rc2i).cwiseAbs().maxCoeff());
+    // the rest is used as is, i.e. as computed at the cached epoch
+    if (c.mjd_tai != t0) {
+      fprintf(stderr, "Failed! Epoch within window recomputed\n");
+      ++error;
+    }
+  }
+  printf("Within window: max ERA difference %.3e [rad], max rc2i difference "
+         "%.3e\n",
+         max_era, max_rc2i);
+  if (tc.nmisses != 1 || tc.nhits != 4) {
+    fprintf(stderr, "Failed! Within window: %ld hits, %ld misses\n",
+            tc.nhits, tc.nmisses);
+    ++error;
+  }
+  if (!(max_era < 1e-9) || !(max_rc2i < 1e-8)) {
+    fprintf(stderr, "Failed! Cached values off within the window\n");
+    ++error;
+  }
+
+  // leaving the window invalidates the cache; recomputed at the new epoch,
+  // which is then the center of the window
+  const double t1 = t0 + 61e0 * s;
+  if (!same(dso::update_time_cache(t1, params),
+            dso::update_time_cache(t1, fresh)) ||
+      tc.nmisses != 2 || tc.mjd_tai != t1) {
+    fprintf(stderr, "Failed! Cache not refreshed out of the window\n");
+    ++error;
+  }
+  dso::update_time_cache(t1 + 50e0 * s, params);
+  if (tc.nmisses != 2 || tc.nhits != 5) {
+    fprintf(stderr, "Failed! New window not used\n");
+    ++error;
+  }
+
+  // atmospheric model input around a UTC day boundary: TAI 00:00:36.5 and
+  // 00:00:37.5 of doy 207 are UTC 23:59:59.5 of doy 206 and 00:00:00.5 of
+  // doy 207
+  using dso::nrlmsise00::detail::FluxDataFeedType;
+  dso::nrlmsise00::InParams<FluxDataFeedType::ST_CSV_SW> feed(
+      argv[2], dso::modified_julian_day((long)mjd0), 0e0);
+  params.AtmDataFeed = &feed;
+  tc.window = 0e0;
+  tc.clear();
+  struct {
+    double sec_tai;
+    int doy;
+    double sec_utc;
+  } boundary[] = {{36.5e0, 206, 86399.5e0}, {37.5e0, 207, 0.5e0}};
+  for (const auto &b : boundary) {
+    const double t = mjd0 + 1e0 + b.sec_tai * s;
+    const dso::ForceModelTimeCache &c = dso::update_time_cache(t, params);
+    if (c.atm.doy != b.doy || std::abs(c.atm.sec - b.sec_utc) > 1e-3 ||
+        feed.params_.doy != b.doy) {
+      fprintf(stderr, "Failed! UTC at TAI %.1f sec past midnight: doy %d, "
+                      "%.3f [sec] (expected %d, %.3f)\n",
+              b.sec_tai, c.atm.doy, c.atm.sec, b.doy, b.sec_utc);
+      ++error;
+    }
+  }
+  // a hit restores the date/time of the (since updated) feed
+  feed.update_params((int)mjd0 + 2, 100e0);
+  dso::update_time_cache(mjd0 + 1e0 + 37.5e0 * s, params);
+  if (feed.params_.doy != 207 || std::abs(feed.params_.sec - 0.5e0) > 1e-3) {
+    fprintf(stderr, "Failed! Feed date/time not restored on a cache hit\n");
+    ++error;
+  }
+
+  return error;
+}
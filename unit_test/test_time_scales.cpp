@@ -0,0 +1,93 @@
+#include "time_scales.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+// Check dso::TimeScaleConverter around the leap second of 2016-12-31 (MJD
+// 57753), and its UT1 conversions against a synthetic (quadratic) UT1-TAI.
+
+constexpr const long leap_day = 57753;
+
+// synthetic UT1-TAI [sec] at the given TT epoch
+double ut1_tai(double mjd_tt) noexcept {
+  const double x = mjd_tt - (leap_day - 10);
+  return -36.4e0 - 1e-3 * x + 2e-5 * x * x;
+}
+
+int main() {
+  int error = 0;
+  dso::TimeScaleConverter tsc;
+
+  // TAI-UTC and the leap second
+  int extra;
+  if (tsc.dat(leap_day - 50, extra) != 36 || extra ||
+      tsc.dat(leap_day, extra) != 36 || extra != 1 ||
+      tsc.dat(leap_day + 1, extra) != 37 || extra) {
+    fprintf(stderr, "Failed! Wrong TAI-UTC around the leap second\n");
+    ++error;
+  }
+
+  // 23:59:60 UTC and the first second of the next day
+  long utc_mjd;
+  double sec = tsc.tai2utc(leap_day + 1 + 36.5e0 / 86400e0, utc_mjd);
+  if (utc_mjd != leap_day || std::abs(sec - 86400.5e0) > 1e-5) {
+    fprintf(stderr, "Failed! TAI to UTC within the leap second\n");
+    ++error;
+  }
+  sec = tsc.tai2utc(leap_day + 1 + 37.5e0 / 86400e0, utc_mjd);
+  if (utc_mjd != leap_day + 1 || std::abs(sec - 0.5e0) > 1e-5) {
+    fprintf(stderr, "Failed! TAI to UTC after the leap second\n");
+    ++error;
+  }
+  if (std::abs((tsc.utc2tai(leap_day, 86400.5e0) - leap_day - 1) * 86400e0 -
+               36.5e0) > 1e-5) {
+    fprintf(stderr, "Failed! UTC to TAI within the leap second\n");
+    ++error;
+  }
+
+  // repeated conversions within the interval are served from the cache
+  tsc.tai2utc(leap_day + 10, utc_mjd);
+  const long misses = tsc.misses();
+  for (int i = 1; i < 1000; i++)
+    tsc.tai2utc(leap_day + 10 + i * 1e-3, utc_mjd);
+  if (tsc.misses() != misses) {
+    fprintf(stderr, "Failed! Leap-second interval not cached\n");
+    ++error;
+  }
+
+  // synthetic EOP table (UT1-UTC jumps at the leap second)
+  dso::EopLookUpTable eop(20);
+  for (int i = 0; i < eop.size(); i++) {
+    const long day = leap_day - 9 + i;
+    *eop.mjd(i) = day + (tsc.dat(day, extra) + 32.184e0) / 86400e0;
+    *eop.dut(i) = ut1_tai(*eop.mjd(i)) + tsc.dat(day, extra);
+  }
+  tsc.set_eop(&eop);
+
+  double max_dt = 0e0;
+  for (double t = leap_day - 7; t < leap_day + 8; t += 0.0137e0) {
+    double dt;
+    if (tsc.ut1_tai(t, dt)) {
+      fprintf(stderr, "Failed computing UT1-TAI at MJD=%.6f\n", t);
+      return 1;
+    }
+    max_dt = std::max(max_dt, std::abs(dt - ut1_tai(t + 32.184e0 / 86400e0)));
+  }
+  printf("Max UT1-TAI residual: %.3e [sec]\n", max_dt);
+  if (max_dt > 1e-9) {
+    fprintf(stderr, "Failed! UT1-TAI residuals too large\n");
+    ++error;
+  }
+
+  // round trip UT1 -> GPS -> UT1
+  double gps, ut1;
+  if (tsc.convert(leap_day + 0.25e0, dso::TimeScale::UT1, dso::TimeScale::GPS,
+                  gps) ||
+      tsc.convert(gps, dso::TimeScale::GPS, dso::TimeScale::UT1, ut1) ||
+      std::abs(ut1 - leap_day - 0.25e0) * 86400e0 > 1e-6) {
+    fprintf(stderr, "Failed! UT1/GPS round trip\n");
+    ++error;
+  }
+
+  return error;
+}
@@ -0,0 +1,87 @@
+#include "egravity.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+// Compare the zonal-only fast path (dso::grav_potential_accel_zonal) against
+// the general geopotential path (Lagrange polynomials and
+// dso::grav_potential_accel with order 0), for a zonal-only field, at a few
+// positions (equatorial, polar, generic and close to the reference sphere).
+// Both the acceleration and its gradient are checked; note that the general
+// path only fills the lower triangle of the gradient, while the zonal one
+// returns it in full (symmetric).
+
+constexpr const int degree = 20;
+constexpr const double GM = 3986004.415e8;
+constexpr const double Re = 6378136.3e0;
+
+int main() {
+  // a zonal-only (un-normalized) field: J2..J6 like values, plus smaller
+  // higher degree terms; C(n,m)=S(n,m)=0 for m>0
+  dso::HarmonicCoeffs hc(degree, GM, Re);
+  for (int n = 0; n <= degree; n++) {
+    for (int m = 0; m <= n; m++) {
+      hc.C(n, m) = 0e0;
+      if (m)
+        hc.S(n, m) = 0e0;
+    }
+  }
+  hc.normalized() = false;
+  hc.C(0, 0) = 1e0;
+  hc.C(2, 0) = -1.08262668e-3;
+  hc.C(3, 0) = 2.53265649e-6;
+  hc.C(4, 0) = 1.61962159e-6;
+  hc.C(5, 0) = 2.27296083e-7;
+  hc.C(6, 0) = -5.40681239e-7;
+  for (int n = 7; n <= degree; n++)
+    hc.C(n, 0) = ((n % 2) ? 1e0 : -1e0) * 1e-7 / n;
+
+  const Eigen::Matrix<double, 3, 1> positions[] = {
+      {7000e3, 0e0, 0e0},              // equatorial
+      {0e0, 0e0, 7000e3},              // polar
+      {-3100e3, 4500e3, -4900e3},      // generic
+      {1200e3, -5800e3, 3200e3},       // close to the reference sphere
+      {25000e3, 18000e3, 9000e3},      // high altitude
+  };
+
+  // work space for the general path (partials need degree+3 x order+3)
+  dso::Mat2D<dso::MatrixStorageType::Trapezoid> V(degree + 3, 3),
+      W(degree + 3, 3);
+
+  int error = 0;
+  for (const auto &r : positions) {
+    // general path
+    Eigen::Matrix<double, 3, 3> pg;
+    if (dso::lagrange_polynomials(r, Re, degree + 2, 2, V, W)) {
+      fprintf(stderr, "Failed computing Lagrange polynomials\n");
+      return 1;
+    }
+    const Eigen::Matrix<double, 3, 1> ag =
+        dso::grav_potential_accel(degree, 0, Re, GM, V, W, hc, pg);
+
+    // zonal fast path (without and with partials)
+    Eigen::Matrix<double, 3, 3> pz;
+    const Eigen::Matrix<double, 3, 1> az =
+        dso::grav_potential_accel_zonal(r, degree, hc);
+    const Eigen::Matrix<double, 3, 1> azp =
+        dso::grav_potential_accel_zonal(r, degree, hc, pz);
+
+    const double da = (az - ag).norm() / ag.norm();
+    const double dap = (azp - ag).norm() / ag.norm();
+    const Eigen::Matrix<double, 3, 3> pzl =
+        pz.triangularView<Eigen::Lower>();
+    const Eigen::Matrix<double, 3, 3> pgl =
+        pg.triangularView<Eigen::Lower>();
+    const double dp = (pzl - pgl).norm() / pgl.norm() +
+                      (pz - pz.transpose()).norm() / pz.norm();
+    printf("r=(%+.0f,%+.0f,%+.0f) km: rel. diff acc %.2e / %.2e, "
+           "gradient %.2e\n",
+           r(0) * 1e-3, r(1) * 1e-3, r(2) * 1e-3, da, dap, dp);
+
+    // agreement to (a few orders above) rounding
+    if (!(da < 1e-13) || !(dap < 1e-13) || !(dp < 1e-12))
+      ++error;
+  }
+
+  return error;
+}